@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+// Library-independent work (a sort and a hashing pass over 4 MiB) that the perf gate divides
+// throughput by, so one baseline carries over between machines of different speed
+void BM_Calibration(benchmark::State& state)
+{
+    std::vector<uint32_t> data(1 << 20);
+    uint32_t x = 2463534242U;
+    for (auto& value : data)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        value = x;
+    }
+
+    std::vector<uint32_t> sorted;
+    for (auto _ : state)
+    {
+        sorted = data;
+        std::ranges::sort(sorted);
+
+        uint64_t hash = 14695981039346656037ULL;
+        for (const uint32_t value : sorted)
+        {
+            hash = (hash ^ value) * 1099511628211ULL;
+        }
+        benchmark::DoNotOptimize(hash);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(data.size() * sizeof(uint32_t)));
+}
+BENCHMARK(BM_Calibration)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,162 @@
+// Runs the benchmarks named in a baseline file and fails when the throughput of any of them,
+// relative to BM_Calibration, falls further below the recorded value than the baseline's
+// tolerance allows. Relative numbers let one checked-in baseline serve machines of different
+// speed.
+//
+//   perf_gate <baseline.json>           Compare against the baseline
+//   perf_gate <baseline.json> --update  Rewrite the baseline's values from this machine
+
+#include <benchmark/benchmark.h>
+
+#include <format>
+#include <fstream>
+#include <map>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace
+{
+
+// Prints as usual and keeps the median bytes per second of every benchmark
+class ThroughputReporter : public benchmark::ConsoleReporter
+{
+public:
+    void ReportRuns(const std::vector<Run>& runs) override
+    {
+        ConsoleReporter::ReportRuns(runs);
+        for (const auto& run : runs)
+        {
+            const auto it = run.counters.find("bytes_per_second");
+            if (run.aggregate_name == "median" && it != run.counters.end())
+            {
+                m_throughput[run.run_name.str()] = it->second;
+            }
+        }
+    }
+
+    [[nodiscard]] const std::map<std::string, double>& GetThroughput() const
+    {
+        return m_throughput;
+    }
+
+private:
+    std::map<std::string, double> m_throughput;
+};
+
+nlohmann::json LoadBaseline(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        throw std::runtime_error(std::format("Failed to open baseline: {}", path));
+    }
+    return nlohmann::json::parse(in);
+}
+
+void SaveBaseline(const std::string& path, const nlohmann::json& baseline)
+{
+    std::ofstream out(path);
+    out << baseline.dump(4) << '\n';
+    if (!out)
+    {
+        throw std::runtime_error(std::format("Failed to write baseline: {}", path));
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) // NOLINT(bugprone-exception-escape)
+{
+    if (argc < 2 || argc > 3 || (argc == 3 && std::string_view(argv[2]) != "--update"))
+    {
+        std::println(stderr, "Usage: {} <baseline.json> [--update]", argv[0]);
+        return 2;
+    }
+    const std::string baseline_path = argv[1];
+    const bool update = argc == 3;
+
+    try
+    {
+        auto baseline = LoadBaseline(baseline_path);
+        const auto calibration = baseline.at("calibration").get<std::string>();
+        const auto tolerance = baseline.at("tolerance").get<double>();
+        auto& expected = baseline.at("benchmarks");
+
+        std::string filter = calibration;
+        for (const auto& [name, value] : expected.items())
+        {
+            filter += "|" + name;
+        }
+        filter = "^(" + filter + ")$";
+
+        // Medians of several repetitions keep one noisy run from failing the gate
+        std::string repetitions =
+            std::format("--benchmark_repetitions={}", baseline.value("repetitions", 5));
+        std::string aggregates_only = "--benchmark_report_aggregates_only=true";
+        std::vector<char*> benchmark_argv = {argv[0], repetitions.data(), aggregates_only.data()};
+        int benchmark_argc = static_cast<int>(benchmark_argv.size());
+        benchmark::Initialize(&benchmark_argc, benchmark_argv.data());
+
+        ThroughputReporter reporter;
+        benchmark::RunSpecifiedBenchmarks(&reporter, filter);
+        benchmark::Shutdown();
+
+        const auto& throughput = reporter.GetThroughput();
+        const auto calibration_it = throughput.find(calibration);
+        if (calibration_it == throughput.end() || calibration_it->second <= 0)
+        {
+            std::println(stderr, "No throughput measured for {}", calibration);
+            return 1;
+        }
+
+        bool regressed = false;
+        std::println("\n{:<24} {:>10} {:>10} {:>8}", "Benchmark", "Relative", "Baseline", "Change");
+        for (auto& [name, value] : expected.items())
+        {
+            const auto it = throughput.find(name);
+            if (it == throughput.end())
+            {
+                std::println("{:<24} no throughput measured", name);
+                regressed = true;
+                continue;
+            }
+
+            const double relative = it->second / calibration_it->second;
+            const double recorded = value.get<double>();
+            const double change = recorded > 0 ? (relative / recorded - 1) * 100 : 0;
+            const bool failed = !update && relative < recorded * (1 - tolerance);
+            std::println("{:<24} {:>10.4f} {:>10.4f} {:>+7.1f}%{}", name, relative, recorded,
+                         change, failed ? "  REGRESSED" : "");
+            regressed = regressed || failed;
+
+            if (update)
+            {
+                value = relative;
+            }
+        }
+
+        if (update)
+        {
+            SaveBaseline(baseline_path, baseline);
+            std::println("\nUpdated {}", baseline_path);
+            return 0;
+        }
+        if (regressed)
+        {
+            std::println(stderr, "\nThroughput regressed by more than {:.0f}% against {}",
+                         tolerance * 100, baseline_path);
+            return 1;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "Error: {}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
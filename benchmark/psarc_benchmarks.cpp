@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include "workload.h"
+
+#include <open-psarc/psarc_file.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace
+{
+
+void BM_Open(benchmark::State& state)
+{
+    const auto& archive = workload::GetArchive();
+    for (auto _ : state)
+    {
+        PsarcFile psarc(archive.path.string());
+        psarc.Open();
+        benchmark::DoNotOptimize(psarc.GetFileCount());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(archive.entry_count));
+}
+BENCHMARK(BM_Open);
+
+void BM_ExtractFileSmall(benchmark::State& state)
+{
+    const auto& archive = workload::GetArchive();
+    PsarcFile psarc(archive.path.string());
+    psarc.Open();
+
+    std::vector<uint8_t> output;
+    int64_t bytes = 0;
+    for (auto _ : state)
+    {
+        for (const auto& name : archive.small_entries)
+        {
+            psarc.ExtractFile(name, output);
+            bytes += static_cast<int64_t>(output.size());
+        }
+    }
+    state.SetBytesProcessed(bytes);
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<int64_t>(archive.small_entries.size()));
+}
+BENCHMARK(BM_ExtractFileSmall);
+
+void BM_ExtractFileLarge(benchmark::State& state)
+{
+    const auto& archive = workload::GetArchive();
+    PsarcFile psarc(archive.path.string());
+    psarc.Open();
+
+    std::vector<uint8_t> output;
+    int64_t bytes = 0;
+    for (auto _ : state)
+    {
+        psarc.ExtractFile(archive.large_entry, output);
+        bytes += static_cast<int64_t>(output.size());
+    }
+    state.SetBytesProcessed(bytes);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ExtractFileLarge)->Unit(benchmark::kMillisecond);
+
+// Argument: PsarcOptions::thread_count
+void BM_ExtractAll(benchmark::State& state)
+{
+    const auto& archive = workload::GetArchive();
+    const auto output_directory = workload::GetScratchDirectory() / "extract_all";
+
+    PsarcFile psarc(archive.path.string());
+    psarc.Open();
+
+    PsarcOptions options;
+    options.thread_count = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state)
+    {
+        const auto report = psarc.ExtractAll(output_directory.string(), options);
+        if (!report.Succeeded())
+        {
+            state.SkipWithError("ExtractAll reported failed entries");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(archive.total_bytes));
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(archive.entry_count));
+
+    std::filesystem::remove_all(output_directory);
+}
+BENCHMARK(BM_ExtractAll)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace
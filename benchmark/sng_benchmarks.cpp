@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+
+#include "fixture_generator.h"
+#include "manifest_parser.h"
+#include "sng_parser.h"
+#include "sng_writer.h"
+#include "sng_xml_writer.h"
+#include "workload.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const sng::SngData& GetSng()
+{
+    static const sng::SngData sng =
+        FixtureGenerator::MakeSng({.notes_per_level = workload::g_note_count});
+    return sng;
+}
+
+int64_t CountNotes(const sng::SngData& sng)
+{
+    int64_t notes = 0;
+    for (const auto& arrangement : sng.arrangements)
+    {
+        notes += static_cast<int64_t>(arrangement.notes.size());
+    }
+    return notes;
+}
+
+void BM_SngParse(benchmark::State& state)
+{
+    const auto serialized = SngWriter::Serialize(GetSng());
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(SngParser::Parse(serialized));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(serialized.size()));
+    state.SetItemsProcessed(state.iterations() * CountNotes(GetSng()));
+}
+BENCHMARK(BM_SngParse)->Unit(benchmark::kMillisecond);
+
+void BM_SngXmlWrite(benchmark::State& state)
+{
+    const auto& sng = GetSng();
+    const auto manifest = ManifestParser::Parse(FixtureGenerator::MakeManifestJson("bench_lead"));
+    const auto output_path = workload::GetScratchDirectory() / "bench_lead.xml";
+
+    for (auto _ : state)
+    {
+        SngXmlWriter::Write(sng, output_path, &manifest);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<int64_t>(std::filesystem::file_size(output_path)));
+    state.SetItemsProcessed(state.iterations() * CountNotes(sng));
+}
+BENCHMARK(BM_SngXmlWrite)->Unit(benchmark::kMillisecond);
+
+void BM_ManifestParse(benchmark::State& state)
+{
+    const std::string json = FixtureGenerator::MakeManifestJson("bench_lead");
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ManifestParser::Parse(json));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(json.size()));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ManifestParse);
+
+} // namespace
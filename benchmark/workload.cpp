@@ -0,0 +1,94 @@
+#include "workload.h"
+
+#include "fixture_generator.h"
+
+#include <format>
+#include <random>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+constexpr int g_small_entry_count = 256;
+constexpr size_t g_small_entry_size = 4 * 1024;
+constexpr size_t g_large_entry_size = 16 * 1024 * 1024;
+
+workload::Archive CreateArchive()
+{
+    workload::Archive archive;
+    archive.path = workload::GetScratchDirectory() / "workload.psarc";
+
+    FixtureArchiveSpec spec;
+    spec.entry_count = g_small_entry_count;
+    spec.min_entry_size = g_small_entry_size;
+    spec.max_entry_size = g_small_entry_size;
+    spec.sng_count = 1;
+    spec.sng.notes_per_level = workload::g_note_count;
+
+    std::vector<FixtureEntry> entries;
+    for (int i = 0; i < FixtureGenerator::GetEntryCount(spec); ++i)
+    {
+        entries.push_back(FixtureGenerator::MakeEntry(spec, i));
+        if (i < g_small_entry_count)
+        {
+            archive.small_entries.push_back(entries.back().name);
+        }
+    }
+    archive.sng_entry = entries[g_small_entry_count].name;
+
+    entries.push_back({.name = "audio/windows/large.bin",
+                       .data = FixtureGenerator::MakeEntryData(g_large_entry_size, 1234)});
+    archive.large_entry = entries.back().name;
+
+    FixtureGenerator::WriteArchive(archive.path, entries, spec);
+
+    archive.entry_count = entries.size();
+    for (const auto& entry : entries)
+    {
+        archive.total_bytes += entry.data.size();
+    }
+    return archive;
+}
+
+// Owns the scratch directory so it is cleaned up with the process's static objects
+struct ScratchDirectory
+{
+    fs::path path;
+
+    ScratchDirectory()
+        : path(fs::temp_directory_path() /
+               std::format("open-psarc-bench-{:08x}", std::random_device{}()))
+    {
+        fs::create_directories(path);
+    }
+
+    ~ScratchDirectory()
+    {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+
+    ScratchDirectory(const ScratchDirectory&) = delete;
+    ScratchDirectory& operator=(const ScratchDirectory&) = delete;
+};
+
+} // namespace
+
+namespace workload
+{
+
+const Archive& GetArchive()
+{
+    static const Archive archive = CreateArchive();
+    return archive;
+}
+
+const fs::path& GetScratchDirectory()
+{
+    static const ScratchDirectory directory;
+    return directory.path;
+}
+
+} // namespace workload
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Synthetic inputs shared by the benchmarks, generated once per process into a temp directory
+namespace workload
+{
+
+struct Archive
+{
+    std::filesystem::path path;
+    std::vector<std::string> small_entries;
+    std::string large_entry;
+    std::string sng_entry;
+    size_t entry_count = 0;
+    uint64_t total_bytes = 0;
+};
+
+// Notes in the benchmark arrangement
+inline constexpr int g_note_count = 8000;
+
+[[nodiscard]] const Archive& GetArchive();
+
+// Scratch directory removed at exit
+[[nodiscard]] const std::filesystem::path& GetScratchDirectory();
+
+} // namespace workload
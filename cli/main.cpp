@@ -1,8 +1,13 @@
 #include <open-psarc/psarc_file.h>
+#include <open-psarc/psarc_trace.h>
 
+#include <charconv>
 #include <chrono>
 #include <cstring>
+#include <format>
+#include <functional>
 #include <print>
+#include <string_view>
 
 void PrintUsage(const char* program_name)
 {
@@ -16,11 +21,21 @@ void PrintUsage(const char* program_name)
                "\n"
                "Options:\n"
                "  -a, --convert-audio  Convert .wem/.bnk audio to .ogg after extraction\n"
+               "  -c, --cache <dir>    Share extracted and converted outputs through a\n"
+               "                       content-addressed cache (copied into place)\n"
                "  -h, --help           Show this help message\n"
+               "  -i, --incremental    Skip files unchanged since the last extraction\n"
+               "      --info[=json]    Summarize sizes, blocks and extensions from the TOC\n"
+               "  -j, --threads <n>    Worker threads for extraction/conversion (0 = all cores)\n"
                "  -l, --list           List files only (don't extract)\n"
+               "  -m, --memory <MiB>   Limit memory held by in-flight entries\n"
+               "  -p, --progress       Show a progress indicator on stderr\n"
                "  -q, --quiet          Suppress file listing during extraction\n"
                "  -s, --convert-sng    Convert .sng arrangements to .xml after extraction\n"
+               "      --stats[=json]   Print I/O, decompression and timing counters at the end\n"
+               "      --trace <file>   Write a Chrome/Perfetto trace of the run as JSON\n"
                "  -v, --version        Show version information\n"
+               "      --verify         Check every entry decompresses consistently with the TOC\n"
                "\n"
                "Examples:\n"
                "  {} archive.psarc              List archive contents\n"
@@ -29,6 +44,225 @@ void PrintUsage(const char* program_name)
                program_name, program_name, program_name, program_name);
 }
 
+bool ParseNumber(const char* text, uint64_t& value)
+{
+    const char* end = text + std::strlen(text);
+    const auto [ptr, ec] = std::from_chars(text, end, value);
+    return ec == std::errc() && ptr == end;
+}
+
+// Rewrites one stderr line whenever the whole-percent value changes
+std::function<void(const PsarcProgress&)> MakeProgressPrinter()
+{
+    return [last_percent = uint64_t{101}](const PsarcProgress& progress) mutable {
+        const uint64_t percent =
+            progress.bytes_total ? progress.bytes_done * 100 / progress.bytes_total : 100;
+        if (percent != last_percent)
+        {
+            last_percent = percent;
+            std::print(stderr, "\r  {:3}% ({}/{} files)", percent, progress.entries_done,
+                       progress.entries_total);
+        }
+    };
+}
+
+// Prints the failed entries and a one-line summary; returns whether every entry succeeded
+bool PrintReport(const PsarcReport& report, std::string_view verb)
+{
+    for (const auto& result : report.entries)
+    {
+        if (result.status == PsarcEntryStatus::Failed)
+        {
+            std::println(stderr, "  {}: {}", result.name, result.message);
+        }
+    }
+
+    const auto duration = std::chrono::duration<double, std::milli>(report.duration);
+    std::println("{} {} files in {:.2f} ms ({} cached, {} skipped, {} failed)", verb,
+                 report.Count(PsarcEntryStatus::Succeeded) + report.Count(PsarcEntryStatus::Cached),
+                 duration.count(), report.Count(PsarcEntryStatus::Cached),
+                 report.Count(PsarcEntryStatus::Skipped), report.Count(PsarcEntryStatus::Failed));
+    return report.Succeeded();
+}
+
+// Records spans from opening the archive until the end of main, including early returns and
+// errors, and writes them out on destruction
+class TraceRecording
+{
+public:
+    explicit TraceRecording(const char* path) : m_path(path)
+    {
+        if (m_path)
+        {
+            PsarcTrace::Start();
+        }
+    }
+
+    ~TraceRecording()
+    {
+        if (!m_path)
+        {
+            return;
+        }
+
+        PsarcTrace::Stop();
+        try
+        {
+            PsarcTrace::WriteChromeTrace(m_path);
+            std::println(stderr, "Trace written to {}", m_path);
+        }
+        catch (const std::exception& e)
+        {
+            std::println(stderr, "Error: {}", e.what());
+        }
+    }
+
+    TraceRecording(const TraceRecording&) = delete;
+    TraceRecording& operator=(const TraceRecording&) = delete;
+
+private:
+    const char* m_path;
+};
+
+enum class StatsFormat
+{
+    None,
+    Text,
+    Json,
+};
+
+void PrintStats(const PsarcStats& stats, StatsFormat format)
+{
+    const std::pair<const char*, const PsarcPhaseStats*> phases[] = {
+        {"open", &stats.open},   {"extract", &stats.extract}, {"audio", &stats.audio},
+        {"sng", &stats.sng},     {"verify", &stats.verify}};
+    const auto ms = [](std::chrono::nanoseconds duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    };
+
+    if (format == StatsFormat::Json)
+    {
+        std::print("{{\"bytes_read\":{},\"compressed_bytes\":{},\"uncompressed_bytes\":{},"
+                   "\"blocks_inflated\":{},\"blocks_stored\":{},\"buffer_allocations\":{},"
+                   "\"bytes_decrypted\":{},\"files_written\":{},\"bytes_written\":{},"
+                   "\"phases\":{{",
+                   stats.bytes_read, stats.compressed_bytes, stats.uncompressed_bytes,
+                   stats.blocks_inflated, stats.blocks_stored, stats.buffer_allocations,
+                   stats.bytes_decrypted, stats.files_written, stats.bytes_written);
+        const char* separator = "";
+        for (const auto& [name, phase] : phases)
+        {
+            std::print("{}\"{}\":{{\"runs\":{},\"wall_ms\":{:.3f},\"cpu_ms\":{:.3f}}}",
+                       separator, name, phase->runs, ms(phase->wall_time), ms(phase->cpu_time));
+            separator = ",";
+        }
+        std::println("}}}}");
+        return;
+    }
+
+    std::println("\nStatistics:");
+    std::println("  Bytes read:         {}", stats.bytes_read);
+    std::println("  Compressed bytes:   {}", stats.compressed_bytes);
+    std::println("  Uncompressed bytes: {}", stats.uncompressed_bytes);
+    std::println("  Blocks inflated:    {}", stats.blocks_inflated);
+    std::println("  Blocks stored:      {}", stats.blocks_stored);
+    std::println("  Buffer allocations: {}", stats.buffer_allocations);
+    std::println("  Bytes decrypted:    {}", stats.bytes_decrypted);
+    std::println("  Files written:      {} ({} bytes)", stats.files_written, stats.bytes_written);
+    for (const auto& [name, phase] : phases)
+    {
+        if (phase->runs > 0)
+        {
+            std::println("  {:<8} {:>10.2f} ms wall {:>10.2f} ms CPU", name, ms(phase->wall_time),
+                         ms(phase->cpu_time));
+        }
+    }
+}
+
+// Quotes a string for JSON output, escaping quotes, backslashes and control characters
+std::string ToJsonString(std::string_view text)
+{
+    std::string quoted = "\"";
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            quoted += '\\';
+            quoted += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            quoted += std::format("\\u{:04x}", c);
+        }
+        else
+        {
+            quoted += c;
+        }
+    }
+    return quoted + '"';
+}
+
+void PrintArchiveInfo(std::string_view path, const PsarcArchiveInfo& info, StatsFormat format)
+{
+    if (format == StatsFormat::Json)
+    {
+        std::print("{{\"archive\":{},\"archive_size\":{},\"block_size\":{},"
+                   "\"compression_method\":{},\"toc_encrypted\":{},\"entry_count\":{},"
+                   "\"uncompressed_size\":{},\"compressed_size\":{},\"compression_ratio\":{:.4f},"
+                   "\"block_count\":{},\"stored_blocks\":{},\"extensions\":[",
+                   ToJsonString(path), info.archive_size, info.block_size,
+                   ToJsonString(info.compression_method), info.toc_encrypted, info.entry_count,
+                   info.uncompressed_size, info.compressed_size, info.GetCompressionRatio(),
+                   info.block_count, info.stored_blocks);
+        const char* separator = "";
+        for (const auto& extension : info.extensions)
+        {
+            std::print("{}{{\"extension\":{},\"entry_count\":{},\"uncompressed_size\":{},"
+                       "\"compressed_size\":{}}}",
+                       separator, ToJsonString(extension.extension), extension.entry_count,
+                       extension.uncompressed_size, extension.compressed_size);
+            separator = ",";
+        }
+        std::print("],\"largest_entries\":[");
+        separator = "";
+        for (const auto& entry : info.largest_entries)
+        {
+            std::print("{}{{\"name\":{},\"uncompressed_size\":{},\"compressed_size\":{},"
+                       "\"block_count\":{},\"stored_blocks\":{}}}",
+                       separator, ToJsonString(entry.name), entry.uncompressed_size,
+                       entry.compressed_size, entry.block_count, entry.stored_blocks);
+            separator = ",";
+        }
+        std::println("]}}");
+        return;
+    }
+
+    std::println("Archive: {}", path);
+    std::println("Files: {}", info.entry_count);
+    std::println("Size: {} bytes, {}, {}-byte blocks, {} TOC", info.archive_size,
+                 info.compression_method, info.block_size,
+                 info.toc_encrypted ? "encrypted" : "plain");
+    std::println("Data: {} bytes compressed to {} (ratio {:.3f})", info.uncompressed_size,
+                 info.compressed_size, info.GetCompressionRatio());
+    std::println("Blocks: {} ({} stored uncompressed)", info.block_count, info.stored_blocks);
+
+    std::println("\nBy extension:");
+    for (const auto& extension : info.extensions)
+    {
+        std::println("  {:<12} {:>7} files {:>14} bytes {:>14} compressed",
+                     extension.extension.empty() ? "(none)" : extension.extension,
+                     extension.entry_count, extension.uncompressed_size,
+                     extension.compressed_size);
+    }
+
+    std::println("\nLargest entries:");
+    for (const auto& entry : info.largest_entries)
+    {
+        std::println("  {} ({} bytes, {} compressed)", entry.name, entry.uncompressed_size,
+                     entry.compressed_size);
+    }
+}
+
 void PrintVersion()
 {
     std::println("open-psarc version 1.0.0");
@@ -42,8 +276,15 @@ int main(int argc, char* argv[]) // NOLINT(bugprone-exception-escape)
         bool convert_sng = false;
         bool list_only = false;
         bool quiet = false;
+        bool show_progress = false;
+        bool verify = false;
         const char* psarc_path = nullptr;
         const char* output_dir = nullptr;
+        const char* trace_path = nullptr;
+        StatsFormat stats_format = StatsFormat::None;
+        StatsFormat info_format = StatsFormat::None;
+        PsarcOptions options;
+        bool threads_set = false;
 
         // Parse arguments
         for (int i = 1; i < argc; ++i)
@@ -63,21 +304,99 @@ int main(int argc, char* argv[]) // NOLINT(bugprone-exception-escape)
                 convert_audio = true;
                 continue;
             }
+            if (std::strcmp(argv[i], "-c") == 0 || std::strcmp(argv[i], "--cache") == 0)
+            {
+                if (i + 1 >= argc)
+                {
+                    std::println(stderr, "Missing directory for {}", argv[i]);
+                    return 1;
+                }
+                options.cache_directory = argv[++i];
+                continue;
+            }
             if (std::strcmp(argv[i], "-s") == 0 || std::strcmp(argv[i], "--convert-sng") == 0)
             {
                 convert_sng = true;
                 continue;
             }
+            if (std::strcmp(argv[i], "-i") == 0 || std::strcmp(argv[i], "--incremental") == 0)
+            {
+                options.incremental = true;
+                continue;
+            }
+            if (std::strcmp(argv[i], "-j") == 0 || std::strcmp(argv[i], "--threads") == 0)
+            {
+                uint64_t threads = 0;
+                if (i + 1 >= argc || !ParseNumber(argv[++i], threads))
+                {
+                    std::println(stderr, "Invalid or missing thread count");
+                    return 1;
+                }
+                options.thread_count = static_cast<unsigned int>(threads);
+                threads_set = true;
+                continue;
+            }
+            if (std::strcmp(argv[i], "--info") == 0 || std::strcmp(argv[i], "--info=text") == 0)
+            {
+                info_format = StatsFormat::Text;
+                continue;
+            }
+            if (std::strcmp(argv[i], "--info=json") == 0)
+            {
+                info_format = StatsFormat::Json;
+                continue;
+            }
+            if (std::strcmp(argv[i], "-m") == 0 || std::strcmp(argv[i], "--memory") == 0)
+            {
+                uint64_t mebibytes = 0;
+                if (i + 1 >= argc || !ParseNumber(argv[++i], mebibytes))
+                {
+                    std::println(stderr, "Invalid or missing memory limit");
+                    return 1;
+                }
+                options.memory_budget = mebibytes * 1024 * 1024;
+                continue;
+            }
             if (std::strcmp(argv[i], "-l") == 0 || std::strcmp(argv[i], "--list") == 0)
             {
                 list_only = true;
                 continue;
             }
+            if (std::strcmp(argv[i], "-p") == 0 || std::strcmp(argv[i], "--progress") == 0)
+            {
+                show_progress = true;
+                continue;
+            }
             if (std::strcmp(argv[i], "-q") == 0 || std::strcmp(argv[i], "--quiet") == 0)
             {
                 quiet = true;
                 continue;
             }
+            if (std::strcmp(argv[i], "--stats") == 0 || std::strcmp(argv[i], "--stats=text") == 0)
+            {
+                stats_format = StatsFormat::Text;
+                continue;
+            }
+            if (std::strcmp(argv[i], "--stats=json") == 0)
+            {
+                stats_format = StatsFormat::Json;
+                continue;
+            }
+            if (std::strcmp(argv[i], "--trace") == 0)
+            {
+                if (i + 1 >= argc)
+                {
+                    std::println(stderr, "Missing file for {}", argv[i]);
+                    return 1;
+                }
+                trace_path = argv[++i];
+                continue;
+            }
+            if (std::strcmp(argv[i], "--verify") == 0)
+            {
+                verify = true;
+                continue;
+            }
             if (argv[i][0] == '-')
             {
                 std::println(stderr, "Unknown option: {}", argv[i]);
@@ -107,61 +426,121 @@ int main(int argc, char* argv[]) // NOLINT(bugprone-exception-escape)
             return 1;
         }
 
+        if (trace_path && !PsarcTrace::IsAvailable())
+        {
+            std::println(stderr, "Warning: tracing is not compiled in (build with ENABLE_TRACING)");
+            trace_path = nullptr;
+        }
+        const TraceRecording trace(trace_path);
+
         PsarcFile psarc(psarc_path);
         psarc.Open();
 
+        // The summary replaces the listing and never extracts
+        if (info_format != StatsFormat::None)
+        {
+            PrintArchiveInfo(psarc_path, psarc.GetArchiveInfo(), info_format);
+            return 0;
+        }
+
         std::println("Archive: {}", psarc_path);
         std::println("Files: {}", psarc.GetFileCount());
 
+        if (verify)
+        {
+            // Verification only reads, so it uses every core unless told otherwise
+            PsarcOptions verify_options = options;
+            if (!threads_set)
+            {
+                verify_options.thread_count = 0;
+            }
+            if (show_progress)
+            {
+                verify_options.progress = MakeProgressPrinter();
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            const auto errors = psarc.Verify(verify_options);
+            const auto end = std::chrono::steady_clock::now();
+            if (show_progress)
+            {
+                std::print(stderr, "\n");
+            }
+
+            const auto duration = std::chrono::duration<double, std::milli>(end - start);
+            for (const auto& error : errors)
+            {
+                std::println(stderr, "  {}", error);
+            }
+            std::println("Verified {} files in {:.2f} ms: {} corrupt", psarc.GetFileCount(),
+                         duration.count(), errors.size());
+            if (stats_format != StatsFormat::None)
+            {
+                PrintStats(psarc.GetStats(), stats_format);
+            }
+            return errors.empty() ? 0 : 1;
+        }
+
+        int exit_code = 0;
         const bool should_list = list_only || !output_dir || !quiet;
 
         if (should_list)
         {
             std::println("");
-            for (const auto& name : psarc.GetFileList())
+            for (const auto& entry : psarc.GetEntries())
             {
-                std::println("  {} ({} bytes)", name, psarc.GetFileSize(name));
+                std::println("  {} ({} bytes)", entry.name, entry.size);
             }
         }
 
         if (output_dir && !list_only)
         {
-            std::println("\nExtracting to: {}", output_dir);
+            // Each operation gets a fresh copy of the printer and ends its line on completion
+            const auto finish_progress = [&] {
+                if (show_progress)
+                {
+                    std::print(stderr, "\n");
+                }
+            };
+            if (show_progress)
+            {
+                options.progress = MakeProgressPrinter();
+            }
 
-            const auto start = std::chrono::steady_clock::now();
-            psarc.ExtractAll(output_dir);
-            const auto end = std::chrono::steady_clock::now();
+            std::println("\nExtracting to: {}", output_dir);
 
-            const auto duration = std::chrono::duration<double, std::milli>(end - start);
-            std::println("Successfully extracted {} files in {:.2f} ms", psarc.GetFileCount(),
-                         duration.count());
+            // Failed entries don't stop the remaining work, only the exit status
+            const auto extract_report = psarc.ExtractAll(output_dir, options);
+            finish_progress();
+            bool succeeded = PrintReport(extract_report, "Extracted");
 
             if (convert_audio)
             {
                 std::println("\nConverting audio files...");
-
-                const auto audio_start = std::chrono::steady_clock::now();
-                psarc.ConvertAudio(output_dir);
-                const auto audio_end = std::chrono::steady_clock::now();
-
-                const auto audio_duration =
-                    std::chrono::duration<double, std::milli>(audio_end - audio_start);
-                std::println("Audio conversion completed in {:.2f} ms", audio_duration.count());
+                const auto audio_report = psarc.ConvertAudio(output_dir, options);
+                finish_progress();
+                succeeded = PrintReport(audio_report, "Converted") && succeeded;
             }
 
             if (convert_sng)
             {
                 std::println("\nConverting SNG arrangements to XML...");
+                const auto sng_report = psarc.ConvertSng(output_dir, options);
+                finish_progress();
+                succeeded = PrintReport(sng_report, "Converted") && succeeded;
+            }
 
-                const auto sng_start = std::chrono::steady_clock::now();
-                psarc.ConvertSng(output_dir);
-                const auto sng_end = std::chrono::steady_clock::now();
-
-                const auto sng_duration =
-                    std::chrono::duration<double, std::milli>(sng_end - sng_start);
-                std::println("SNG conversion completed in {:.2f} ms", sng_duration.count());
+            if (!succeeded)
+            {
+                exit_code = 1;
             }
         }
+
+        if (stats_format != StatsFormat::None)
+        {
+            PrintStats(psarc.GetStats(), stats_format);
+        }
+        return exit_code;
     }
     catch (const PsarcException& e)
     {
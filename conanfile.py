@@ -39,6 +39,7 @@ class OpenPsarcConan(ConanFile):
         self.requires("zlib/1.3.1")
 
     def build_requirements(self):
+        self.test_requires("benchmark/1.9.1")
         self.test_requires("catch2/3.6.0")
 
     def layout(self):
@@ -0,0 +1,418 @@
+#include "fixture_generator.h"
+
+#include "open-psarc/psarc_file.h"
+#include "psarc_format.h"
+#include "psarc_writer.h"
+#include "sng_writer.h"
+#include "sng_xml_reader.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+#include <openssl/evp.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+std::array<uint8_t, 16> HashName(std::string_view name)
+{
+    std::array<uint8_t, 16> md5{};
+    if (EVP_Digest(name.data(), name.size(), md5.data(), nullptr, EVP_md5(), nullptr) != 1)
+    {
+        throw PsarcException("Failed to hash entry name");
+    }
+    return md5;
+}
+
+void WriteBytes(std::ofstream& out, std::span<const uint8_t> bytes)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    out.write(reinterpret_cast<const char*>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+}
+
+// Compresses entries into a temporary data file as they are produced, then writes the header and
+// TOC (whose size depends on the total block count) followed by the data. The names block is
+// only known at the end, so its blocks are stored last.
+std::vector<std::string> WriteArchiveFrom(const fs::path& path, int count,
+                                          const std::function<FixtureEntry(int)>& entry_at,
+                                          const FixtureArchiveSpec& spec)
+{
+    if (spec.block_size == 0 || spec.block_size > g_max_block_size)
+    {
+        throw PsarcException(std::format("Unsupported block size: {}", spec.block_size));
+    }
+
+    PsarcTocLayout layout;
+    layout.block_size = spec.block_size;
+    layout.compression_method = spec.compression_method;
+    layout.archive_flags = spec.encrypt_toc ? g_toc_encrypted_flag : 0;
+    layout.entries.resize(1);
+
+    const fs::path data_path = path.string() + ".data.tmp";
+    std::vector<std::string> names;
+    try
+    {
+        std::ofstream data(data_path, std::ios::binary);
+        if (!data)
+        {
+            throw PsarcException(std::format("Failed to create file: {}", data_path.string()));
+        }
+
+        uint64_t data_size = 0;
+        const auto add_blocks = [&](std::span<const uint8_t> bytes) {
+            PsarcTocEntry entry;
+            entry.start_chunk_index = static_cast<uint32_t>(layout.z_lengths.size());
+            entry.uncompressed_size = bytes.size();
+            entry.offset = data_size;
+
+            const auto blocks = PsarcWriter::CompressBlocks(bytes, layout.block_size,
+                                                            layout.compression_method,
+                                                            layout.z_lengths);
+            WriteBytes(data, blocks);
+            data_size += blocks.size();
+            return entry;
+        };
+
+        std::string names_block;
+        for (int i = 0; i < count; ++i)
+        {
+            const auto entry = entry_at(i);
+            auto toc_entry = add_blocks(entry.data);
+            toc_entry.md5 = HashName(entry.name);
+            layout.entries.push_back(toc_entry);
+
+            names_block += (i == 0 ? "" : "\n") + entry.name;
+            names.push_back(entry.name);
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        layout.entries[0] = add_blocks({reinterpret_cast<const uint8_t*>(names_block.data()),
+                                        names_block.size()});
+
+        data.close();
+        if (!data)
+        {
+            throw PsarcException(std::format("Failed to write file: {}", data_path.string()));
+        }
+
+        const uint64_t toc_length = PsarcWriter::GetTocLength(layout);
+        for (auto& entry : layout.entries)
+        {
+            entry.offset += toc_length;
+        }
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out)
+        {
+            throw PsarcException(std::format("Failed to create file: {}", path.string()));
+        }
+        WriteBytes(out, PsarcWriter::EncodeHeaderAndToc(layout));
+
+        std::ifstream in(data_path, std::ios::binary);
+        out << in.rdbuf();
+        if (!out)
+        {
+            throw PsarcException(std::format("Failed to write file: {}", path.string()));
+        }
+    }
+    catch (...)
+    {
+        std::error_code ec;
+        fs::remove(data_path, ec);
+        throw;
+    }
+
+    fs::remove(data_path);
+    return names;
+}
+
+std::string MakeNotesXml(const FixtureSngSpec& spec, int level, double start, double spacing,
+                         int& chord_count, std::string& chords, std::string& hand_shapes)
+{
+    std::mt19937 rng(spec.seed * 31 + static_cast<uint32_t>(level));
+    std::uniform_int_distribution<int> string_dist(0, 5);
+    std::uniform_int_distribution<int> fret_dist(0, 17);
+    std::uniform_int_distribution<int> technique_dist(0, 15);
+
+    std::string notes;
+    chord_count = 0;
+    for (int i = 0; i < spec.notes_per_level; ++i)
+    {
+        const double time = start + i * spacing;
+        if (spec.chord_interval > 0 && spec.chord_templates > 0 &&
+            i % spec.chord_interval == spec.chord_interval - 1)
+        {
+            const int chord_id = chord_count % spec.chord_templates;
+            const int root = 1 + chord_id % 12;
+            chords += std::format(
+                "        <chord time=\"{0:.3f}\" chordId=\"{1}\">\n"
+                "          <chordNote time=\"{0:.3f}\" string=\"0\" fret=\"{2}\" />\n"
+                "          <chordNote time=\"{0:.3f}\" string=\"1\" fret=\"{3}\" />\n"
+                "          <chordNote time=\"{0:.3f}\" string=\"2\" fret=\"{3}\" />\n"
+                "        </chord>\n",
+                time, chord_id, root, root + 2);
+            hand_shapes += std::format(
+                "        <handShape chordId=\"{}\" startTime=\"{:.3f}\" endTime=\"{:.3f}\" />\n",
+                chord_id, time, time + spacing / 2);
+            ++chord_count;
+            continue;
+        }
+
+        const int string = string_dist(rng);
+        const int fret = fret_dist(rng);
+        switch (technique_dist(rng))
+        {
+        case 0:
+            notes += std::format("        <note time=\"{:.3f}\" string=\"{}\" fret=\"{}\" "
+                                 "sustain=\"{:.3f}\" bend=\"1\">\n"
+                                 "          <bendValues count=\"1\"><bendValue time=\"{:.3f}\" "
+                                 "step=\"1.000\" /></bendValues>\n"
+                                 "        </note>\n",
+                                 time, string, fret + 1, spacing, time + spacing / 2);
+            break;
+        case 1:
+            notes += std::format("        <note time=\"{:.3f}\" string=\"{}\" fret=\"{}\" "
+                                 "sustain=\"{:.3f}\" slideTo=\"{}\" />\n",
+                                 time, string, fret + 1, spacing, fret + 3);
+            break;
+        case 2:
+            notes += std::format(
+                "        <note time=\"{:.3f}\" string=\"{}\" fret=\"{}\" palmMute=\"1\" />\n", time,
+                string, fret);
+            break;
+        default:
+            notes += std::format("        <note time=\"{:.3f}\" string=\"{}\" fret=\"{}\" />\n",
+                                 time, string, fret);
+            break;
+        }
+    }
+    return notes;
+}
+
+} // namespace
+
+int FixtureGenerator::GetEntryCount(const FixtureArchiveSpec& spec)
+{
+    return spec.entry_count + 2 * spec.sng_count;
+}
+
+FixtureEntry FixtureGenerator::MakeEntry(const FixtureArchiveSpec& spec, int index)
+{
+    if (index < 0 || index >= GetEntryCount(spec))
+    {
+        throw PsarcException(std::format("Fixture entry index out of range: {}", index));
+    }
+
+    const auto seed = static_cast<uint32_t>(spec.seed * 7919 + static_cast<uint32_t>(index));
+    if (index < spec.entry_count)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<size_t> size_dist(
+            spec.min_entry_size, std::max(spec.min_entry_size, spec.max_entry_size));
+        const size_t size = size_dist(rng);
+        const bool compressible = std::uniform_real_distribution<double>(0.0, 1.0)(rng) >=
+                                  spec.incompressible_ratio;
+
+        return {.name = std::format("assets/fixture/entry_{:05}.{}", index,
+                                    compressible ? "txt" : "bin"),
+                .data = MakeEntryData(size, seed, compressible)};
+    }
+
+    const int song = (index - spec.entry_count) / 2;
+    const std::string song_key = std::format("fixture{:03}_lead", song);
+    if ((index - spec.entry_count) % 2 == 0)
+    {
+        FixtureSngSpec sng = spec.sng;
+        sng.seed += static_cast<uint32_t>(song);
+        return {.name = std::format("songs/bin/generic/{}.sng", song_key),
+                .data = MakeEncryptedSng(sng)};
+    }
+
+    const std::string manifest = MakeManifestJson(song_key);
+    return {.name = std::format("manifests/songs_dlc_fixture/{}.json", song_key),
+            .data = {manifest.begin(), manifest.end()}};
+}
+
+std::vector<std::string> FixtureGenerator::GenerateArchive(const fs::path& path,
+                                                           const FixtureArchiveSpec& spec)
+{
+    return WriteArchiveFrom(path, GetEntryCount(spec),
+                            [&](int index) { return MakeEntry(spec, index); }, spec);
+}
+
+void FixtureGenerator::WriteArchive(const fs::path& path, const std::vector<FixtureEntry>& entries,
+                                    const FixtureArchiveSpec& spec)
+{
+    WriteArchiveFrom(path, static_cast<int>(entries.size()),
+                     [&](int index) { return entries[static_cast<size_t>(index)]; }, spec);
+}
+
+std::vector<uint8_t> FixtureGenerator::MakeEntryData(size_t size, uint32_t seed,
+                                                     bool compressible)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> data;
+    data.reserve(size);
+
+    if (!compressible)
+    {
+        std::uniform_int_distribution<int> byte_dist(0, 255);
+        while (data.size() < size)
+        {
+            data.push_back(static_cast<uint8_t>(byte_dist(rng)));
+        }
+        return data;
+    }
+
+    static constexpr std::string_view words[] = {
+        "<note ", "time=\"", "0.125\" ", "string=\"", "fret=\"", "/>\n", "<chord ", "sustain=\"",
+        "\"Attributes\": ", "{ ", "}, ", "bend ", "anchor ", "width=\"4\" ", "1\" ", "12\" "};
+    std::uniform_int_distribution<size_t> word_dist(0, std::size(words) - 1);
+    while (data.size() < size)
+    {
+        const auto word = words[word_dist(rng)];
+        data.insert(data.end(), word.begin(), word.end());
+    }
+    data.resize(size);
+    return data;
+}
+
+std::string FixtureGenerator::MakeArrangementXml(const FixtureSngSpec& spec)
+{
+    constexpr double start = 1.0;
+    constexpr double spacing = 0.125;
+    const int levels = std::max(1, spec.levels);
+    const double length = start + (spec.notes_per_level + 16) * spacing;
+
+    std::string ebeats;
+    int ebeat_count = 0;
+    for (double time = 0.5; time < length; time += 0.5, ++ebeat_count)
+    {
+        ebeats += ebeat_count % 4 == 0
+                      ? std::format("    <ebeat time=\"{:.3f}\" measure=\"{}\" />\n", time,
+                                    ebeat_count / 4 + 1)
+                      : std::format("    <ebeat time=\"{:.3f}\" />\n", time);
+    }
+
+    // One phrase iteration, section and anchor every 8 seconds
+    std::string iterations;
+    std::string sections;
+    std::string anchors;
+    int iteration_count = 0;
+    for (double time = start; time < length; time += 8.0, ++iteration_count)
+    {
+        iterations += std::format("    <phraseIteration time=\"{:.3f}\" phraseId=\"{}\" />\n",
+                                  time, iteration_count == 0 ? 0 : 1);
+        sections +=
+            std::format("    <section name=\"riff\" number=\"{}\" startTime=\"{:.3f}\" />\n",
+                        iteration_count + 1, time);
+        anchors += std::format("        <anchor time=\"{:.3f}\" fret=\"{}\" width=\"4\" />\n",
+                               time, 1 + iteration_count % 9);
+    }
+
+    std::string templates;
+    for (int i = 0; i < spec.chord_templates; ++i)
+    {
+        const int root = 1 + i % 12;
+        templates += std::format("    <chordTemplate chordName=\"C{0}\" displayName=\"C{0}\" "
+                                 "finger0=\"1\" finger1=\"3\" finger2=\"4\" fret0=\"{1}\" "
+                                 "fret1=\"{2}\" fret2=\"{2}\" />\n",
+                                 i, root, root + 2);
+    }
+
+    std::string level_xml;
+    for (int level = 0; level < levels; ++level)
+    {
+        int chord_count = 0;
+        std::string chords;
+        std::string hand_shapes;
+        const std::string notes =
+            MakeNotesXml(spec, level, start, spacing, chord_count, chords, hand_shapes);
+
+        level_xml += std::format("    <level difficulty=\"{}\">\n"
+                                 "      <notes count=\"{}\">\n{}      </notes>\n"
+                                 "      <chords count=\"{}\">\n{}      </chords>\n"
+                                 "      <anchors count=\"{}\">\n{}      </anchors>\n"
+                                 "      <handShapes count=\"{}\">\n{}      </handShapes>\n"
+                                 "    </level>\n",
+                                 level, spec.notes_per_level - chord_count, notes, chord_count,
+                                 chords, iteration_count, anchors, chord_count, hand_shapes);
+    }
+
+    return std::format(R"(<?xml version="1.0" encoding="utf-8"?>
+<song version="8">
+  <title>Fixture {0}</title>
+  <offset>0.000</offset>
+  <songLength>{1:.3f}</songLength>
+  <startBeat>0.500</startBeat>
+  <capo>0</capo>
+  <tuning string0="0" string1="0" string2="0" string3="0" string4="0" string5="0" />
+  <phrases count="2">
+    <phrase disparity="0" ignore="0" maxDifficulty="0" name="COUNT" solo="0" />
+    <phrase disparity="0" ignore="0" maxDifficulty="{2}" name="riff" solo="0" />
+  </phrases>
+  <phraseIterations count="{3}">
+{4}  </phraseIterations>
+  <chordTemplates count="{5}">
+{6}  </chordTemplates>
+  <ebeats count="{7}">
+{8}  </ebeats>
+  <sections count="{3}">
+{9}  </sections>
+  <events count="0" />
+  <transcriptionTrack difficulty="-1"><notes count="0" /></transcriptionTrack>
+  <levels count="{10}">
+{11}  </levels>
+</song>
+)",
+                       spec.seed, length, levels - 1, iteration_count, iterations,
+                       spec.chord_templates, templates, ebeat_count, ebeats, sections, levels,
+                       level_xml);
+}
+
+sng::SngData FixtureGenerator::MakeSng(const FixtureSngSpec& spec)
+{
+    return SngXmlReader::Parse(MakeArrangementXml(spec));
+}
+
+std::vector<uint8_t> FixtureGenerator::MakeEncryptedSng(const FixtureSngSpec& spec)
+{
+    return SngWriter::Encode(MakeSng(spec));
+}
+
+std::string FixtureGenerator::MakeManifestJson(const std::string& song_key)
+{
+    return std::format(R"({{
+  "Entries": {{
+    "{0}": {{
+      "Attributes": {{
+        "SongName": "Fixture",
+        "ArrangementName": "Lead",
+        "CentOffset": 0.0,
+        "SongNameSort": "Fixture",
+        "SongAverageTempo": 120.0,
+        "ArtistName": "open-psarc",
+        "ArtistNameSort": "open-psarc",
+        "AlbumName": "Fixtures",
+        "AlbumNameSort": "Fixtures",
+        "SongYear": 2026,
+        "Tone_Base": "{0}_base",
+        "Tone_A": "{0}_a",
+        "ArrangementProperties": {{
+          "represent": 1, "standardTuning": 1, "bends": 1, "pathLead": 1
+        }}
+      }}
+    }}
+  }}
+}}
+)",
+                       song_key);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "sng_types.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Synthetic SNG arrangement. Every level repeats the same rhythm with its own frets, and every
+// chord_interval-th note is replaced by a chord cycling through chord_templates shapes.
+struct FixtureSngSpec
+{
+    int levels = 1;
+    int notes_per_level = 1000;
+    int chord_interval = 16; // 0 disables chords
+    int chord_templates = 4;
+    uint32_t seed = 0;
+};
+
+struct FixtureArchiveSpec
+{
+    // Generic entries with sizes drawn uniformly from [min_entry_size, max_entry_size]. A share
+    // of them (incompressible_ratio) is random data, like audio, that is stored uncompressed.
+    int entry_count = 64;
+    size_t min_entry_size = 1024;
+    size_t max_entry_size = 256 * 1024;
+    double incompressible_ratio = 0.0;
+
+    uint32_t block_size = 65536;
+    std::array<char, 4> compression_method = {'z', 'l', 'i', 'b'};
+    bool encrypt_toc = true;
+
+    // Encrypted SNGs under songs/bin/generic/, each with a matching manifest
+    int sng_count = 0;
+    FixtureSngSpec sng;
+
+    uint32_t seed = 0;
+};
+
+struct FixtureEntry
+{
+    std::string name;
+    std::vector<uint8_t> data;
+};
+
+class FixtureGenerator
+{
+public:
+    // Generic entries come first, followed by each SNG and its manifest
+    [[nodiscard]] static int GetEntryCount(const FixtureArchiveSpec& spec);
+
+    // The index-th entry of a spec as stored in the archive (SNGs encrypted); deterministic for
+    // a given seed, so callers can regenerate expected contents instead of keeping them around
+    [[nodiscard]] static FixtureEntry MakeEntry(const FixtureArchiveSpec& spec, int index);
+
+    // Streams every entry of the spec into a PSARC 1.4 archive one entry at a time, so archive
+    // size is bounded by disk rather than memory. Returns the entry names in archive order.
+    static std::vector<std::string> GenerateArchive(const std::filesystem::path& path,
+                                                    const FixtureArchiveSpec& spec);
+
+    // Writes the given entries after the names block, using the spec's block size, compression
+    // and TOC encryption. TOC entries carry the MD5 of their name as in game archives.
+    static void WriteArchive(const std::filesystem::path& path,
+                             const std::vector<FixtureEntry>& entries,
+                             const FixtureArchiveSpec& spec);
+
+    // Text-like data that compresses about as well as the XML and JSON in real archives, or
+    // random bytes when compressible is false
+    [[nodiscard]] static std::vector<uint8_t> MakeEntryData(size_t size, uint32_t seed,
+                                                            bool compressible = true);
+
+    [[nodiscard]] static std::string MakeArrangementXml(const FixtureSngSpec& spec);
+    [[nodiscard]] static sng::SngData MakeSng(const FixtureSngSpec& spec);
+    [[nodiscard]] static std::vector<uint8_t> MakeEncryptedSng(const FixtureSngSpec& spec);
+
+    // Manifest whose first entry carries the metadata ManifestParser reads
+    [[nodiscard]] static std::string MakeManifestJson(const std::string& song_key);
+};
@@ -0,0 +1,172 @@
+#include "fixture_generator.h"
+
+#include <open-psarc/psarc_file.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <print>
+#include <string_view>
+
+void PrintUsage(const char* program_name)
+{
+    std::print("Usage: {} [options] <output.psarc>\n"
+               "\n"
+               "Generates a synthetic PSARC archive for tests and benchmarks.\n"
+               "\n"
+               "Options:\n"
+               "  -n, --entries <n>          Generic entries (default 64)\n"
+               "      --min-size <bytes>     Smallest generic entry (default 1024)\n"
+               "      --max-size <bytes>     Largest generic entry (default 262144)\n"
+               "      --incompressible <%>   Share of generic entries with random data\n"
+               "  -b, --block-size <bytes>   Block size, at most 65536 (default 65536)\n"
+               "      --lzma                 Compress with LZMA instead of zlib\n"
+               "      --plain-toc            Don't encrypt the TOC\n"
+               "  -s, --sng <n>              Encrypted SNG arrangements with manifests\n"
+               "      --levels <n>           Difficulty levels per SNG (default 1)\n"
+               "      --notes <n>            Notes per level (default 1000)\n"
+               "      --chord-interval <n>   Every nth note is a chord, 0 for none (default 16)\n"
+               "      --chord-templates <n>  Distinct chord shapes (default 4)\n"
+               "      --seed <n>             Seed for reproducible contents (default 0)\n"
+               "  -h, --help                 Show this help message\n",
+               program_name);
+}
+
+template <typename T> bool ParseNumber(const char* text, T& value)
+{
+    const char* end = text + std::strlen(text);
+    const auto [ptr, ec] = std::from_chars(text, end, value);
+    return ec == std::errc() && ptr == end;
+}
+
+int main(int argc, char* argv[]) // NOLINT(bugprone-exception-escape)
+{
+    try
+    {
+        FixtureArchiveSpec spec;
+        const char* output_path = nullptr;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            const auto number = [&](auto& value) {
+                if (i + 1 >= argc || !ParseNumber(argv[i + 1], value))
+                {
+                    std::println(stderr, "Invalid or missing value for {}", arg);
+                    return false;
+                }
+                ++i;
+                return true;
+            };
+
+            if (arg == "-h" || arg == "--help")
+            {
+                PrintUsage(argv[0]);
+                return 0;
+            }
+
+            bool valid = true;
+            double incompressible_percent = 0;
+            if (arg == "-n" || arg == "--entries")
+            {
+                valid = number(spec.entry_count);
+            }
+            else if (arg == "--min-size")
+            {
+                valid = number(spec.min_entry_size);
+            }
+            else if (arg == "--max-size")
+            {
+                valid = number(spec.max_entry_size);
+            }
+            else if (arg == "--incompressible")
+            {
+                valid = number(incompressible_percent);
+                spec.incompressible_ratio = incompressible_percent / 100.0;
+            }
+            else if (arg == "-b" || arg == "--block-size")
+            {
+                valid = number(spec.block_size);
+            }
+            else if (arg == "--lzma")
+            {
+                spec.compression_method = {'l', 'z', 'm', 'a'};
+            }
+            else if (arg == "--plain-toc")
+            {
+                spec.encrypt_toc = false;
+            }
+            else if (arg == "-s" || arg == "--sng")
+            {
+                valid = number(spec.sng_count);
+            }
+            else if (arg == "--levels")
+            {
+                valid = number(spec.sng.levels);
+            }
+            else if (arg == "--notes")
+            {
+                valid = number(spec.sng.notes_per_level);
+            }
+            else if (arg == "--chord-interval")
+            {
+                valid = number(spec.sng.chord_interval);
+            }
+            else if (arg == "--chord-templates")
+            {
+                valid = number(spec.sng.chord_templates);
+            }
+            else if (arg == "--seed")
+            {
+                valid = number(spec.seed);
+                spec.sng.seed = spec.seed;
+            }
+            else if (arg.starts_with('-'))
+            {
+                std::println(stderr, "Unknown option: {}", arg);
+                return 1;
+            }
+            else if (!output_path)
+            {
+                output_path = argv[i];
+            }
+            else
+            {
+                std::println(stderr, "Too many arguments");
+                PrintUsage(argv[0]);
+                return 1;
+            }
+
+            if (!valid)
+            {
+                return 1;
+            }
+        }
+
+        if (!output_path)
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto names = FixtureGenerator::GenerateArchive(output_path, spec);
+        const auto end = std::chrono::steady_clock::now();
+
+        const auto duration = std::chrono::duration<double, std::milli>(end - start);
+        std::println("Wrote {} entries to {} in {:.2f} ms", names.size(), output_path,
+                     duration.count());
+    }
+    catch (const PsarcException& e)
+    {
+        std::println(stderr, "Error: {}", e.what());
+        return 1;
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "Unexpected error: {}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include "fixture_generator.h"
+#include "sng_writer.h"
+
+#include <open-psarc/psarc_file.h>
+
+#include <filesystem>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <print>
+#include <span>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// Seeds stay small so that executions are fast and mutations reach the parsers' edge cases
+// rather than being spent decompressing
+constexpr FixtureSngSpec g_sng_seeds[] = {
+    {.levels = 1, .notes_per_level = 4, .chord_interval = 0, .chord_templates = 0},
+    {.levels = 2, .notes_per_level = 16, .chord_interval = 4, .chord_templates = 2},
+};
+
+void WriteSeed(const fs::path& path, std::span<const uint8_t> data)
+{
+    fs::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+    if (!out)
+    {
+        throw PsarcException(std::format("Failed to write file: {}", path.string()));
+    }
+}
+
+FixtureArchiveSpec MakeArchiveSpec(uint32_t block_size, bool encrypt_toc)
+{
+    FixtureArchiveSpec spec;
+    spec.entry_count = 3;
+    spec.min_entry_size = 0;
+    spec.max_entry_size = 2 * block_size;
+    spec.incompressible_ratio = 0.34;
+    spec.block_size = block_size;
+    spec.encrypt_toc = encrypt_toc;
+    spec.sng_count = 1;
+    spec.sng = g_sng_seeds[0];
+    return spec;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) // NOLINT(bugprone-exception-escape)
+{
+    if (argc != 2)
+    {
+        std::println(stderr, "Usage: {} <corpus-dir>", argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        const fs::path root = argv[1];
+
+        for (size_t i = 0; i < std::size(g_sng_seeds); ++i)
+        {
+            const auto sng = SngWriter::Serialize(FixtureGenerator::MakeSng(g_sng_seeds[i]));
+            WriteSeed(root / "sng" / std::format("seed_{}.sng", i), sng);
+        }
+
+        const auto manifest = FixtureGenerator::MakeManifestJson("fuzz_lead");
+        WriteSeed(root / "manifest" / "seed_0.json",
+                  std::span(reinterpret_cast<const uint8_t*>(manifest.data()), manifest.size()));
+
+        // Small blocks give multi-block entries without large inputs
+        fs::create_directories(root / "psarc");
+        FixtureGenerator::GenerateArchive(root / "psarc" / "seed_zlib.psarc",
+                                          MakeArchiveSpec(1024, true));
+        auto lzma = MakeArchiveSpec(1024, false);
+        lzma.compression_method = {'l', 'z', 'm', 'a'};
+        FixtureGenerator::GenerateArchive(root / "psarc" / "seed_lzma.psarc", lzma);
+        FixtureGenerator::GenerateArchive(root / "psarc" / "seed_plain_toc.psarc",
+                                          MakeArchiveSpec(4096, false));
+    }
+    catch (const std::exception& e)
+    {
+        std::println(stderr, "Error: {}", e.what());
+        return 1;
+    }
+    return 0;
+}
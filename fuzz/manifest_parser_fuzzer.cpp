@@ -0,0 +1,19 @@
+#include "manifest_parser.h"
+
+#include <open-psarc/psarc_file.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    try
+    {
+        (void)ManifestParser::Parse(std::string_view(reinterpret_cast<const char*>(data), size));
+    }
+    catch (const PsarcException&)
+    {
+    }
+    return 0;
+}
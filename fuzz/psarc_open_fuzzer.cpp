@@ -0,0 +1,34 @@
+#include <open-psarc/psarc_byte_source.h>
+#include <open-psarc/psarc_file.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace
+{
+
+// Extracting a few entries covers the block reader without letting large inputs dominate
+constexpr size_t g_max_extracted_entries = 4;
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    try
+    {
+        PsarcFile psarc(PsarcByteSource::FromMemory(std::span(data, size)));
+        psarc.Open();
+
+        const auto names = psarc.GetFileList();
+        for (size_t i = 0; i < std::min(names.size(), g_max_extracted_entries); ++i)
+        {
+            (void)psarc.ExtractFile(names[i]);
+        }
+    }
+    catch (const PsarcException&)
+    {
+    }
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include "sng_parser.h"
+
+#include <open-psarc/psarc_file.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Inputs are decrypted SNG payloads, the layout PsarcFile hands to the parser
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    try
+    {
+        (void)SngParser::Parse(std::span(data, size));
+    }
+    catch (const PsarcException&)
+    {
+    }
+    return 0;
+}
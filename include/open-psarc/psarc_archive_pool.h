@@ -0,0 +1,58 @@
+#pragma once
+
+#include "open-psarc/psarc_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct PsarcArchivePoolOptions
+{
+    size_t max_archives = 64; // 0 = unlimited
+    uint64_t max_memory = 0;  // Bytes of TOC and index data across cached archives; 0 = unlimited
+    bool map_files = false;   // Read archives through PsarcByteSource::MapFile instead of pread
+
+    // Attached to every archive the pool opens
+    std::shared_ptr<PsarcBlockCache> block_cache;
+};
+
+struct PsarcArchivePoolStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;        // Archives opened, including reopened ones
+    uint64_t invalidations = 0; // Cached archives dropped because the file changed on disk
+    uint64_t evictions = 0;     // Cached archives dropped to stay within the limits
+    size_t archives = 0;
+    uint64_t memory = 0; // PsarcFile::GetMemoryUsage summed over the cached archives
+};
+
+// Thread-safe cache of opened archives, so archives read over and over skip parsing the header,
+// TOC and names block. Cached archives are shared between callers: use the const accessors and
+// ExtractFile, which may be called from any number of threads at once. Least recently used
+// archives are dropped first once a limit is exceeded; callers still holding one keep it usable.
+class PsarcArchivePool
+{
+public:
+    explicit PsarcArchivePool(PsarcArchivePoolOptions options = {});
+    ~PsarcArchivePool();
+
+    PsarcArchivePool(const PsarcArchivePool&) = delete;
+    PsarcArchivePool& operator=(const PsarcArchivePool&) = delete;
+    PsarcArchivePool(PsarcArchivePool&&) = delete;
+    PsarcArchivePool& operator=(PsarcArchivePool&&) = delete;
+
+    // Returns the opened archive at path, opening it on a miss or when the file's modification
+    // time or size no longer match the cached copy. Throws PsarcException if it cannot be opened.
+    [[nodiscard]] std::shared_ptr<const PsarcFile> Acquire(const std::string& path);
+
+    // Drops the cached copy of path, if any
+    void Invalidate(const std::string& path);
+    void Clear();
+
+    [[nodiscard]] PsarcArchivePoolStats GetStats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
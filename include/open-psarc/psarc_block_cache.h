@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+struct PsarcBlockCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t blocks = 0;
+    uint64_t bytes = 0; // Decompressed data held, excluding bookkeeping
+};
+
+// Thread-safe, size-bounded LRU cache of decompressed archive blocks. Attach one to any number of
+// archives with PsarcFile::SetBlockCache; ExtractFile then serves repeated reads of the same
+// blocks from memory instead of reading and inflating them again.
+class PsarcBlockCache
+{
+public:
+    using Block = std::shared_ptr<const std::vector<uint8_t>>;
+
+    explicit PsarcBlockCache(uint64_t max_bytes);
+    ~PsarcBlockCache();
+
+    PsarcBlockCache(const PsarcBlockCache&) = delete;
+    PsarcBlockCache& operator=(const PsarcBlockCache&) = delete;
+    PsarcBlockCache(PsarcBlockCache&&) = delete;
+    PsarcBlockCache& operator=(PsarcBlockCache&&) = delete;
+
+    // Called by PsarcFile. archive_id identifies one opened archive; chunk is the block's index
+    // in the archive's z-length table.
+    [[nodiscard]] Block Find(uint64_t archive_id, uint32_t chunk);
+    void Insert(uint64_t archive_id, uint32_t chunk, std::span<const uint8_t> data);
+
+    void Clear();
+    [[nodiscard]] PsarcBlockCacheStats GetStats() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> m_impl;
+};
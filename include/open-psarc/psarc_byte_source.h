@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+// Random-access input that PsarcFile reads archives from. ReadAt is called concurrently by the
+// worker threads of bulk operations, so implementations must not keep a shared file position.
+class PsarcByteSource
+{
+public:
+    PsarcByteSource() = default;
+    virtual ~PsarcByteSource() = default;
+
+    PsarcByteSource(const PsarcByteSource&) = delete;
+    PsarcByteSource& operator=(const PsarcByteSource&) = delete;
+    PsarcByteSource(PsarcByteSource&&) = delete;
+    PsarcByteSource& operator=(PsarcByteSource&&) = delete;
+
+    [[nodiscard]] virtual uint64_t GetSize() const = 0;
+
+    // Reads up to buffer.size() bytes at offset and returns how many were read, which is less
+    // only at the end of the data. Throws PsarcException on I/O errors.
+    [[nodiscard]] virtual size_t ReadAt(uint64_t offset, std::span<uint8_t> buffer) const = 0;
+
+    // The whole contents when they are already addressable in memory, so readers can use them in
+    // place instead of copying through ReadAt; empty otherwise
+    [[nodiscard]] virtual std::span<const uint8_t> GetData() const
+    {
+        return {};
+    }
+
+    // Hints that a range will be read soon so slow storage can start fetching it in the
+    // background. Never required for correctness; the default does nothing.
+    virtual void Prefetch(uint64_t offset, uint64_t length) const
+    {
+        (void)offset;
+        (void)length;
+    }
+
+    // Reads a file with positional reads
+    [[nodiscard]] static std::shared_ptr<PsarcByteSource> OpenFile(const std::string& path);
+
+    // Maps a file into memory (mmap, or CreateFileMapping on Windows). The file must not shrink
+    // while mapped.
+    [[nodiscard]] static std::shared_ptr<PsarcByteSource> MapFile(const std::string& path);
+
+    // Reads from a buffer owned by the caller, which must outlive every user of the source
+    [[nodiscard]] static std::shared_ptr<PsarcByteSource> FromMemory(
+        std::span<const uint8_t> data);
+
+    // Reads from a buffer owned by the source
+    [[nodiscard]] static std::shared_ptr<PsarcByteSource> FromMemory(std::vector<uint8_t> data);
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "open-psarc/psarc_byte_source.h"
+#include "open-psarc/psarc_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Where a catalog found an entry name
+struct PsarcCatalogEntry
+{
+    std::string_view archive_path; // As added to the builder; points into the catalog
+    int index = 0;                 // TOC index of the entry, for PsarcFile::GetEntry
+    uint64_t size = 0;             // Uncompressed size
+};
+
+// Collects the name tables of many archives and writes them out as one catalog file
+class PsarcCatalogBuilder
+{
+public:
+    // Opens the archive to read its names; path is recorded as given
+    void AddArchive(const std::string& path);
+
+    // Records an archive that is already open
+    void AddArchive(const std::string& path, const PsarcFile& archive);
+
+    // Serialized catalog, readable through PsarcCatalog
+    [[nodiscard]] std::vector<uint8_t> Build() const;
+
+    // Writes the catalog through a temporary file, replacing path only once it is complete
+    void Save(const std::string& path) const;
+
+private:
+    struct Entry
+    {
+        std::string name;
+        uint32_t archive = 0;
+        int index = 0;
+        uint64_t size = 0;
+    };
+
+    std::vector<std::string> m_archive_paths;
+    std::vector<Entry> m_entries;
+};
+
+// Read-only name index across many archives. Lookups hash straight into the catalog image, so
+// loading a mapped catalog costs nothing per entry and finding a name opens no archives.
+class PsarcCatalog
+{
+public:
+    // Maps a catalog file written by PsarcCatalogBuilder::Save
+    [[nodiscard]] static PsarcCatalog Load(const std::string& path);
+
+    // Reads a catalog image, e.g. PsarcByteSource::FromMemory(builder.Build()). Sources that are
+    // not addressable in memory are read into it first. Throws PsarcException if malformed.
+    explicit PsarcCatalog(std::shared_ptr<const PsarcByteSource> source);
+
+    [[nodiscard]] size_t GetArchiveCount() const;
+    [[nodiscard]] size_t GetEntryCount() const;
+    [[nodiscard]] std::string_view GetArchivePath(size_t index) const;
+
+    // The entry from the first archive added that contains name
+    [[nodiscard]] std::optional<PsarcCatalogEntry> Find(std::string_view name) const;
+
+    // Every archive containing name, in the order they were added
+    [[nodiscard]] std::vector<PsarcCatalogEntry> FindAll(std::string_view name) const;
+
+private:
+    template <typename Visitor>
+    void ForEachMatch(std::string_view name, Visitor&& visit) const;
+
+    [[nodiscard]] std::string_view GetString(uint64_t offset, uint64_t length) const;
+    [[nodiscard]] PsarcCatalogEntry ReadEntry(uint32_t index) const;
+
+    std::shared_ptr<const PsarcByteSource> m_source;
+    std::span<const uint8_t> m_data;
+    uint32_t m_archive_count = 0;
+    uint32_t m_entry_count = 0;
+    uint32_t m_bucket_count = 0;
+    uint64_t m_strings_offset = 0;
+    uint64_t m_strings_size = 0;
+};
@@ -1,9 +1,18 @@
 #pragma once
 
+#include "open-psarc/psarc_block_cache.h"
+#include "open-psarc/psarc_byte_source.h"
+
+#include <array>
+#include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <span>
 #include <stdexcept>
+#include <stop_token>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class PsarcException : public std::runtime_error
@@ -12,10 +21,186 @@ public:
     using std::runtime_error::runtime_error;
 };
 
+// Thrown when a bulk operation stops because PsarcOptions::stop_token was triggered
+class PsarcCancelledException : public PsarcException
+{
+public:
+    using PsarcException::PsarcException;
+};
+
+struct PsarcProgress
+{
+    uint64_t entries_done = 0;
+    uint64_t entries_total = 0;
+    uint64_t bytes_done = 0;
+    uint64_t bytes_total = 0;
+};
+
+enum class PsarcEntryStatus
+{
+    Succeeded,
+    Cached,  // Output copied from PsarcOptions::cache_directory
+    Skipped, // Output already up to date (PsarcOptions::incremental)
+    Failed,
+};
+
+enum class PsarcErrorCode
+{
+    None,
+    MissingEntry,     // An entry referenced by another (e.g. a streamed WEM) is not in the archive
+    ReadFailed,       // Reading, decrypting or decompressing the entry failed
+    ConversionFailed, // The entry was read but could not be converted
+    WriteFailed,      // The output could not be written
+};
+
+// Outcome of one entry of a bulk operation
+struct PsarcEntryResult
+{
+    std::string name;   // Archive entry the result is about
+    std::string output; // Path written (or that would have been written)
+    PsarcEntryStatus status = PsarcEntryStatus::Succeeded;
+    PsarcErrorCode error_code = PsarcErrorCode::None;
+    std::string message;
+    uint64_t bytes_read = 0; // Uncompressed archive data read
+    uint64_t bytes_written = 0;
+    std::chrono::nanoseconds duration{};
+};
+
+// Per-entry results of a bulk operation, sorted by name
+struct PsarcReport
+{
+    std::vector<PsarcEntryResult> entries;
+    std::chrono::nanoseconds duration{};
+
+    [[nodiscard]] bool Succeeded() const;
+    [[nodiscard]] size_t Count(PsarcEntryStatus status) const;
+
+    // Distinct names of failed entries, suitable for PsarcOptions::entries to retry just those
+    [[nodiscard]] std::vector<std::string> GetFailedEntries() const;
+};
+
+// Calls and time spent in one kind of PsarcFile operation
+struct PsarcPhaseStats
+{
+    uint64_t runs = 0;
+    std::chrono::nanoseconds wall_time{};
+    std::chrono::nanoseconds cpu_time{}; // Process CPU time, so it includes every worker thread
+};
+
+// Counters accumulated by a PsarcFile since construction or the last ResetStats()
+struct PsarcStats
+{
+    uint64_t bytes_read = 0;         // Read from the archive file: header, TOC and blocks
+    uint64_t compressed_bytes = 0;   // Compressed block bytes fed to zlib or LZMA
+    uint64_t uncompressed_bytes = 0; // Plain bytes produced from blocks, stored ones included
+    uint64_t blocks_inflated = 0;
+    uint64_t blocks_stored = 0;      // Blocks kept uncompressed in the archive
+    uint64_t buffer_allocations = 0; // Entry, block and decryption buffers (re)allocated
+    uint64_t bytes_decrypted = 0;    // TOC and SNG data
+    uint64_t files_written = 0;      // Extracted and converted outputs, excluding cache copies
+    uint64_t bytes_written = 0;
+
+    PsarcPhaseStats open;
+    PsarcPhaseStats extract; // ExtractAll
+    PsarcPhaseStats audio;   // ConvertAudio
+    PsarcPhaseStats sng;     // ConvertSng
+    PsarcPhaseStats verify;
+};
+
+// Name, uncompressed size and TOC index of an entry. The name points into the archive's TOC and
+// stays valid until the archive is closed or rewritten by ReplaceFile or Compact.
+struct PsarcEntryView
+{
+    std::string_view name;
+    uint64_t size = 0;
+    int index = 0; // Position in the TOC; 0 is the names block
+};
+
+// Storage of one entry, read from the TOC without decompressing anything
+struct PsarcEntryInfo
+{
+    std::string name;
+    int index = 0; // Position in the TOC; 0 is the names block
+    uint64_t uncompressed_size = 0;
+    uint64_t compressed_size = 0; // Bytes its blocks occupy in the archive
+    uint64_t offset = 0;          // Archive offset of the first block
+    uint32_t start_chunk_index = 0;
+    uint64_t block_count = 0;
+    uint64_t stored_blocks = 0; // Blocks kept uncompressed; the rest are zlib or LZMA streams
+    std::array<uint8_t, 16> md5{}; // MD5 of the entry name as recorded in the TOC
+};
+
+// Totals over the entries sharing a file extension
+struct PsarcExtensionInfo
+{
+    std::string extension; // Lowercase with the leading dot; empty for names without one
+    uint64_t entry_count = 0;
+    uint64_t uncompressed_size = 0;
+    uint64_t compressed_size = 0;
+};
+
+// Archive-wide storage summary computed from the header and TOC alone
+struct PsarcArchiveInfo
+{
+    uint64_t archive_size = 0;
+    uint32_t block_size = 0;
+    std::string compression_method; // "zlib" or "lzma"
+    bool toc_encrypted = false;
+
+    uint64_t entry_count = 0;
+    uint64_t uncompressed_size = 0;
+    uint64_t compressed_size = 0;
+    uint64_t block_count = 0;
+    uint64_t stored_blocks = 0;
+
+    std::vector<PsarcExtensionInfo> extensions;  // Largest compressed size first
+    std::vector<PsarcEntryInfo> largest_entries; // Largest uncompressed size first
+
+    // Compressed size as a share of the uncompressed size (1 for empty archives)
+    [[nodiscard]] double GetCompressionRatio() const;
+};
+
+// Options for the bulk extraction and conversion methods
+struct PsarcOptions
+{
+    // Content-addressed cache shared between archives. Outputs are stored under a digest of the
+    // entry's stored blocks and copied into the output directory, so content duplicated across
+    // archives is decompressed and converted only once.
+    std::string cache_directory;
+
+    // ExtractAll records a TOC fingerprint (offset, size, block lengths) of every entry in a
+    // sidecar in the output directory and skips entries whose output is still up to date
+    bool incremental = false;
+
+    // Worker threads for extraction and conversion; 0 uses one per hardware thread
+    unsigned int thread_count = 1;
+
+    // Upper bound on bytes held by in-flight entries (0 = unlimited). Entries are extracted
+    // block by block, so only whole-entry work (SNG decryption, audio conversion) is large; it
+    // waits for room in the budget instead of running alongside other large entries.
+    uint64_t memory_budget = 0;
+
+    // Called as blocks and entries complete, possibly from worker threads but never concurrently.
+    // Byte counts refer to the uncompressed entry data read by the operation.
+    std::function<void(const PsarcProgress&)> progress;
+
+    // Checked between blocks; once a stop is requested the operation throws
+    // PsarcCancelledException. Entries already written are left in place.
+    std::stop_token stop_token;
+
+    // Restricts the operation to these archive entries (empty = all of them)
+    std::vector<std::string> entries;
+};
+
 class PsarcFile
 {
 public:
     explicit PsarcFile(std::string file_path);
+
+    // Reads the archive from a source, e.g. PsarcByteSource::FromMemory for archives already in
+    // RAM. name stands in for the path in messages and incremental state; ReplaceFile and Compact
+    // are not available.
+    PsarcFile(std::shared_ptr<PsarcByteSource> source, std::string name = "archive.psarc");
     ~PsarcFile();
 
     PsarcFile(const PsarcFile&) = delete;
@@ -26,17 +211,81 @@ public:
     void Open();
     void Close();
     [[nodiscard]] bool IsOpen() const;
+
+    // Serves ExtractFile from a cache of decompressed blocks, which may be shared with other
+    // archives. Bulk operations such as ExtractAll bypass it. Pass nullptr to detach.
+    void SetBlockCache(std::shared_ptr<PsarcBlockCache> cache);
     [[nodiscard]] int GetFileCount() const;
 
     [[nodiscard]] std::vector<std::string> GetFileList() const;
+
+    // Named entries in TOC order, without copying any names
+    [[nodiscard]] std::span<const PsarcEntryView> GetEntries() const;
+
+    // Accessors by TOC index in [0, GetFileCount())
+    [[nodiscard]] PsarcEntryView GetEntry(int index) const;
+    [[nodiscard]] PsarcEntryInfo GetEntryInfo(int index) const;
     [[nodiscard]] bool FileExists(const std::string& file_name) const;
     [[nodiscard]] uint64_t GetFileSize(const std::string& file_name) const;
-    [[nodiscard]] std::vector<uint8_t> ExtractFile(const std::string& file_name);
-    void ExtractFileTo(const std::string& file_name, const std::string& output_path);
+
+    // TOC details such as compressed size and block layout, without reading the entry's data
+    [[nodiscard]] PsarcEntryInfo GetEntryInfo(const std::string& file_name) const;
+    [[nodiscard]] std::vector<PsarcEntryInfo> GetEntryInfoList() const;
+
+    // Single-entry extraction may be called concurrently on an open archive, e.g. one shared
+    // through PsarcArchivePool; each call reads through a stream of its own
+    [[nodiscard]] std::vector<uint8_t> ExtractFile(const std::string& file_name) const;
+
+    // Extracts into output, reusing its capacity; keep one vector around for repeated calls
+    void ExtractFile(const std::string& file_name, std::vector<uint8_t>& output) const;
+    void ExtractFileTo(const std::string& file_name, const std::string& output_path) const;
+
+    // Hints that these entries will be read soon, so slow storage fetches their stored blocks in
+    // the background, e.g. the manifest and audio of a song about to be extracted. Unknown names
+    // are ignored. ConvertAudio and ConvertSng prefetch the entries of upcoming tasks themselves.
+    void Prefetch(const std::vector<std::string>& names) const;
+
+    // Throw a PsarcException listing every entry that failed
     void ExtractAll(const std::string& output_directory);
     void ConvertAudio(const std::string& output_directory);
     void ConvertSng(const std::string& output_directory);
 
+    // Process every entry and report per-entry outcomes instead of throwing for failed entries.
+    // Exceptions are reserved for cancellation and problems with the archive as a whole.
+    [[nodiscard]] PsarcReport ExtractAll(const std::string& output_directory,
+                                         const PsarcOptions& options);
+    [[nodiscard]] PsarcReport ConvertAudio(const std::string& output_directory,
+                                           const PsarcOptions& options);
+    [[nodiscard]] PsarcReport ConvertSng(const std::string& output_directory,
+                                         const PsarcOptions& options);
+
+    // Rewrites an entry in place by appending its new blocks and rewriting the TOC. The data is
+    // stored verbatim, so .sng entries must already be encrypted. The new TOC is first written to
+    // "<archive>.journal"; if the rewrite is interrupted, the next Open() completes it. A journal
+    // is only replayed over the archive it was written for and is discarded otherwise.
+    void ReplaceFile(const std::string& file_name, std::span<const uint8_t> data);
+
+    // Rewrites the archive without the dead space left behind by ReplaceFile. The copy replaces
+    // the archive only once complete; the archive stays open if that fails.
+    void Compact();
+
+    // Reads sizes, block counts and per-extension totals from the TOC without touching the data,
+    // listing up to largest_entry_count of the largest entries
+    [[nodiscard]] PsarcArchiveInfo GetArchiveInfo(size_t largest_entry_count = 10) const;
+
+    // Approximate heap bytes held for the open archive's TOC and name index
+    [[nodiscard]] uint64_t GetMemoryUsage() const;
+
+    // Decompresses every block in parallel without writing output and checks it against the TOC.
+    // Returns one "name: problem" message per corrupt entry; empty when the archive is intact.
+    // The overload without options uses one thread per hardware thread.
+    [[nodiscard]] std::vector<std::string> Verify() const;
+    [[nodiscard]] std::vector<std::string> Verify(const PsarcOptions& options) const;
+
+    // Counters are updated by every operation, including those running on worker threads
+    [[nodiscard]] PsarcStats GetStats() const;
+    void ResetStats();
+
 private:
     struct Impl;
     std::unique_ptr<Impl> m_impl;
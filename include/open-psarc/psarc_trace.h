@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+// Records timed spans from the library's extraction and SNG pipeline into per-thread ring
+// buffers. Spans are compiled in only when the library is built with ENABLE_TRACING; otherwise
+// every method is a no-op and IsAvailable() returns false.
+class PsarcTrace
+{
+public:
+    [[nodiscard]] static bool IsAvailable();
+
+    // Discards previously recorded spans and starts recording
+    static void Start();
+    static void Stop();
+
+    // Writes the recorded spans as Chrome trace event JSON, viewable in chrome://tracing or
+    // Perfetto. Spans still open are not included; call after the traced operations return.
+    static void WriteChromeTrace(const std::string& path);
+};
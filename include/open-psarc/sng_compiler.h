@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class SngCompiler
+{
+public:
+    // Compiles a Rocksmith 2014 arrangement or vocals XML file into an encrypted .sng, ready to
+    // be stored in a PSARC archive
+    [[nodiscard]] static std::vector<uint8_t> Compile(const std::string& xml_path);
+    static void CompileTo(const std::string& xml_path, const std::string& sng_path);
+};
@@ -0,0 +1,197 @@
+#include "open-psarc/psarc_archive_pool.h"
+
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// Identifies the version of a file an archive was opened from
+struct FileStamp
+{
+    fs::file_time_type write_time;
+    uintmax_t size = 0;
+
+    bool operator==(const FileStamp&) const = default;
+};
+
+FileStamp ReadStamp(const std::string& path)
+{
+    std::error_code error;
+    FileStamp stamp{.write_time = fs::last_write_time(path, error)};
+    if (!error)
+    {
+        stamp.size = fs::file_size(path, error);
+    }
+    if (error)
+    {
+        throw PsarcException(std::format("Failed to open file: {}", path));
+    }
+    return stamp;
+}
+
+} // namespace
+
+struct PsarcArchivePool::Impl
+{
+    struct CachedArchive
+    {
+        std::string path;
+        FileStamp stamp;
+        std::shared_ptr<const PsarcFile> archive;
+        uint64_t memory = 0;
+    };
+
+    using Lru = std::list<CachedArchive>; // Most recently used first
+
+    explicit Impl(PsarcArchivePoolOptions options) : m_options(options)
+    {
+    }
+
+    std::shared_ptr<const PsarcFile> Acquire(const std::string& path)
+    {
+        const auto key = fs::absolute(path).lexically_normal().string();
+
+        // Stamping before opening means a file changed in between is reopened on the next call,
+        // never served stale
+        const auto stamp = ReadStamp(key);
+        Lru dropped; // Closed after the lock is released
+        {
+            const std::scoped_lock lock(m_mutex);
+            if (const auto it = m_index.find(key); it != m_index.end())
+            {
+                if (it->second->stamp == stamp)
+                {
+                    ++m_stats.hits;
+                    m_lru.splice(m_lru.begin(), m_lru, it->second);
+                    return it->second->archive;
+                }
+                ++m_stats.invalidations;
+                Erase(it->second, dropped);
+            }
+        }
+
+        // Open without holding the lock so hits on other archives are not held up
+        auto source = m_options.map_files ? PsarcByteSource::MapFile(key)
+                                          : PsarcByteSource::OpenFile(key);
+        auto archive = std::make_shared<PsarcFile>(std::move(source), key);
+        archive->SetBlockCache(m_options.block_cache);
+        archive->Open();
+        const uint64_t memory = archive->GetMemoryUsage() + sizeof(CachedArchive) + key.size();
+
+        const std::scoped_lock lock(m_mutex);
+        ++m_stats.misses;
+        if (const auto it = m_index.find(key); it != m_index.end())
+        {
+            // Another caller opened the same file meanwhile. Keep whichever copy is newer, so a
+            // slow open of an older version cannot replace the current one.
+            const auto& cached = *it->second;
+            if (cached.stamp == stamp || cached.stamp.write_time > stamp.write_time)
+            {
+                m_lru.splice(m_lru.begin(), m_lru, it->second);
+                return cached.archive;
+            }
+            Erase(it->second, dropped);
+        }
+
+        m_lru.push_front({.path = key, .stamp = stamp, .archive = archive, .memory = memory});
+        m_index.emplace(key, m_lru.begin());
+        m_memory += memory;
+        EvictOverLimit(dropped);
+        return archive;
+    }
+
+    void Invalidate(const std::string& path)
+    {
+        const auto key = fs::absolute(path).lexically_normal().string();
+        Lru dropped; // Closed after the lock is released
+        const std::scoped_lock lock(m_mutex);
+        if (const auto it = m_index.find(key); it != m_index.end())
+        {
+            ++m_stats.invalidations;
+            Erase(it->second, dropped);
+        }
+    }
+
+    void Clear()
+    {
+        Lru dropped; // Closed after the lock is released
+        const std::scoped_lock lock(m_mutex);
+        m_index.clear();
+        dropped.swap(m_lru);
+        m_memory = 0;
+    }
+
+    PsarcArchivePoolStats GetStats() const
+    {
+        const std::scoped_lock lock(m_mutex);
+        auto stats = m_stats;
+        stats.archives = m_lru.size();
+        stats.memory = m_memory;
+        return stats;
+    }
+
+    // Moves the least recently used archives into dropped, always keeping the most recent one
+    void EvictOverLimit(Lru& dropped)
+    {
+        const auto over_limit = [&] {
+            return (m_options.max_archives != 0 && m_lru.size() > m_options.max_archives) ||
+                   (m_options.max_memory != 0 && m_memory > m_options.max_memory);
+        };
+        while (m_lru.size() > 1 && over_limit())
+        {
+            ++m_stats.evictions;
+            Erase(std::prev(m_lru.end()), dropped);
+        }
+    }
+
+    // Unlinks an archive without closing it; the caller releases dropped once unlocked
+    void Erase(Lru::iterator it, Lru& dropped)
+    {
+        m_memory -= it->memory;
+        m_index.erase(it->path);
+        dropped.splice(dropped.end(), m_lru, it);
+    }
+
+    PsarcArchivePoolOptions m_options;
+    mutable std::mutex m_mutex;
+    Lru m_lru;
+    std::unordered_map<std::string, Lru::iterator> m_index;
+    uint64_t m_memory = 0;
+    PsarcArchivePoolStats m_stats;
+};
+
+PsarcArchivePool::PsarcArchivePool(PsarcArchivePoolOptions options)
+    : m_impl(std::make_unique<Impl>(options))
+{
+}
+
+PsarcArchivePool::~PsarcArchivePool() = default;
+
+std::shared_ptr<const PsarcFile> PsarcArchivePool::Acquire(const std::string& path)
+{
+    return m_impl->Acquire(path);
+}
+
+void PsarcArchivePool::Invalidate(const std::string& path)
+{
+    m_impl->Invalidate(path);
+}
+
+void PsarcArchivePool::Clear()
+{
+    m_impl->Clear();
+}
+
+PsarcArchivePoolStats PsarcArchivePool::GetStats() const
+{
+    return m_impl->GetStats();
+}
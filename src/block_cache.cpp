@@ -0,0 +1,123 @@
+#include "open-psarc/psarc_block_cache.h"
+
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+struct PsarcBlockCache::Impl
+{
+    struct CachedBlock
+    {
+        uint64_t key;
+        Block data;
+    };
+
+    using Lru = std::list<CachedBlock>; // Most recently used first
+
+    explicit Impl(uint64_t max_bytes) : m_max_bytes(max_bytes)
+    {
+    }
+
+    // Archive ids come from a counter and chunk indices fit in 32 bits, so both pack into one key
+    [[nodiscard]] static uint64_t MakeKey(uint64_t archive_id, uint32_t chunk)
+    {
+        return (archive_id << 32) | chunk;
+    }
+
+    Block Find(uint64_t archive_id, uint32_t chunk)
+    {
+        const std::scoped_lock lock(m_mutex);
+        const auto it = m_index.find(MakeKey(archive_id, chunk));
+        if (it == m_index.end())
+        {
+            ++m_stats.misses;
+            return nullptr;
+        }
+        ++m_stats.hits;
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return it->second->data;
+    }
+
+    void Insert(uint64_t archive_id, uint32_t chunk, std::span<const uint8_t> data)
+    {
+        if (data.size() > m_max_bytes)
+        {
+            return;
+        }
+
+        // Copy before locking; readers share the block without holding the lock
+        auto block = std::make_shared<const std::vector<uint8_t>>(data.begin(), data.end());
+        Lru dropped; // Freed after the lock is released
+
+        const std::scoped_lock lock(m_mutex);
+        const uint64_t key = MakeKey(archive_id, chunk);
+        if (m_index.contains(key))
+        {
+            return;
+        }
+        m_lru.push_front({.key = key, .data = std::move(block)});
+        m_index.emplace(key, m_lru.begin());
+        m_bytes += data.size();
+
+        while (m_bytes > m_max_bytes)
+        {
+            const auto last = std::prev(m_lru.end());
+            m_bytes -= last->data->size();
+            m_index.erase(last->key);
+            dropped.splice(dropped.end(), m_lru, last);
+            ++m_stats.evictions;
+        }
+    }
+
+    void Clear()
+    {
+        Lru dropped;
+        const std::scoped_lock lock(m_mutex);
+        m_index.clear();
+        dropped.swap(m_lru);
+        m_bytes = 0;
+    }
+
+    PsarcBlockCacheStats GetStats() const
+    {
+        const std::scoped_lock lock(m_mutex);
+        auto stats = m_stats;
+        stats.blocks = m_lru.size();
+        stats.bytes = m_bytes;
+        return stats;
+    }
+
+    uint64_t m_max_bytes;
+    mutable std::mutex m_mutex;
+    Lru m_lru;
+    std::unordered_map<uint64_t, Lru::iterator> m_index;
+    uint64_t m_bytes = 0;
+    PsarcBlockCacheStats m_stats;
+};
+
+PsarcBlockCache::PsarcBlockCache(uint64_t max_bytes) : m_impl(std::make_unique<Impl>(max_bytes))
+{
+}
+
+PsarcBlockCache::~PsarcBlockCache() = default;
+
+PsarcBlockCache::Block PsarcBlockCache::Find(uint64_t archive_id, uint32_t chunk)
+{
+    return m_impl->Find(archive_id, chunk);
+}
+
+void PsarcBlockCache::Insert(uint64_t archive_id, uint32_t chunk, std::span<const uint8_t> data)
+{
+    m_impl->Insert(archive_id, chunk, data);
+}
+
+void PsarcBlockCache::Clear()
+{
+    m_impl->Clear();
+}
+
+PsarcBlockCacheStats PsarcBlockCache::GetStats() const
+{
+    return m_impl->GetStats();
+}
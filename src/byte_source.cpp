@@ -0,0 +1,389 @@
+#include "open-psarc/psarc_byte_source.h"
+
+#include "open-psarc/psarc_file.h"
+
+#include <algorithm>
+#include <format>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <mutex>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+size_t ReadFromSpan(std::span<const uint8_t> data, uint64_t offset, std::span<uint8_t> buffer)
+{
+    if (offset >= data.size())
+    {
+        return 0;
+    }
+    const auto count = static_cast<size_t>(std::min<uint64_t>(buffer.size(), data.size() - offset));
+    std::copy_n(data.begin() + static_cast<std::ptrdiff_t>(offset), count, buffer.begin());
+    return count;
+}
+
+class MemoryByteSource : public PsarcByteSource
+{
+public:
+    explicit MemoryByteSource(std::span<const uint8_t> data) : m_data(data)
+    {
+    }
+
+    explicit MemoryByteSource(std::vector<uint8_t> data) : m_owned(std::move(data)), m_data(m_owned)
+    {
+    }
+
+    [[nodiscard]] uint64_t GetSize() const override
+    {
+        return m_data.size();
+    }
+
+    [[nodiscard]] size_t ReadAt(uint64_t offset, std::span<uint8_t> buffer) const override
+    {
+        return ReadFromSpan(m_data, offset, buffer);
+    }
+
+    [[nodiscard]] std::span<const uint8_t> GetData() const override
+    {
+        return m_data;
+    }
+
+private:
+    std::vector<uint8_t> m_owned;
+    std::span<const uint8_t> m_data;
+};
+
+#ifndef _WIN32
+
+std::string GetErrorMessage(int error)
+{
+    return std::system_category().message(error);
+}
+
+// Opens path read-only and stores its size; the caller owns the descriptor
+int OpenReadOnly(const std::string& path, uint64_t& size)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw PsarcException(std::format("Failed to open file: {}", path));
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0)
+    {
+        const int error = errno;
+        ::close(fd);
+        throw PsarcException(std::format("Failed to stat {}: {}", path, GetErrorMessage(error)));
+    }
+    size = static_cast<uint64_t>(info.st_size);
+    return fd;
+}
+
+// pread() keeps no shared file position, so concurrent readers need no locking
+class FileByteSource : public PsarcByteSource
+{
+public:
+    explicit FileByteSource(std::string path) : m_path(std::move(path))
+    {
+        m_fd = OpenReadOnly(m_path, m_size);
+    }
+
+    ~FileByteSource() override
+    {
+        ::close(m_fd);
+    }
+
+    FileByteSource(const FileByteSource&) = delete;
+    FileByteSource& operator=(const FileByteSource&) = delete;
+    FileByteSource(FileByteSource&&) = delete;
+    FileByteSource& operator=(FileByteSource&&) = delete;
+
+    [[nodiscard]] uint64_t GetSize() const override
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] size_t ReadAt(uint64_t offset, std::span<uint8_t> buffer) const override
+    {
+        size_t done = 0;
+        while (done < buffer.size())
+        {
+            const ssize_t count = ::pread(m_fd, buffer.data() + done, buffer.size() - done,
+                                          static_cast<off_t>(offset + done));
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw PsarcException(
+                    std::format("Failed to read {}: {}", m_path, GetErrorMessage(errno)));
+            }
+            if (count == 0)
+            {
+                break;
+            }
+            done += static_cast<size_t>(count);
+        }
+        return done;
+    }
+
+    void Prefetch(uint64_t offset, uint64_t length) const override
+    {
+#ifdef POSIX_FADV_WILLNEED
+        ::posix_fadvise(m_fd, static_cast<off_t>(offset), static_cast<off_t>(length),
+                        POSIX_FADV_WILLNEED);
+#else
+        (void)offset;
+        (void)length;
+#endif
+    }
+
+private:
+    std::string m_path;
+    int m_fd = -1;
+    uint64_t m_size = 0;
+};
+
+class MappedByteSource : public PsarcByteSource
+{
+public:
+    explicit MappedByteSource(const std::string& path)
+    {
+        const int fd = OpenReadOnly(path, m_size);
+        if (m_size == 0)
+        {
+            ::close(fd);
+            return;
+        }
+        m_address = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        const int error = errno;
+        ::close(fd);
+        if (m_address == MAP_FAILED)
+        {
+            throw PsarcException(std::format("Failed to map {}: {}", path, GetErrorMessage(error)));
+        }
+    }
+
+    ~MappedByteSource() override
+    {
+        if (m_address != MAP_FAILED)
+        {
+            ::munmap(m_address, m_size);
+        }
+    }
+
+    MappedByteSource(const MappedByteSource&) = delete;
+    MappedByteSource& operator=(const MappedByteSource&) = delete;
+    MappedByteSource(MappedByteSource&&) = delete;
+    MappedByteSource& operator=(MappedByteSource&&) = delete;
+
+    [[nodiscard]] uint64_t GetSize() const override
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] size_t ReadAt(uint64_t offset, std::span<uint8_t> buffer) const override
+    {
+        return ReadFromSpan(GetData(), offset, buffer);
+    }
+
+    [[nodiscard]] std::span<const uint8_t> GetData() const override
+    {
+        if (m_address == MAP_FAILED)
+        {
+            return {};
+        }
+        return {static_cast<const uint8_t*>(m_address), static_cast<size_t>(m_size)};
+    }
+
+    void Prefetch(uint64_t offset, uint64_t length) const override
+    {
+        if (m_address == MAP_FAILED || offset >= m_size)
+        {
+            return;
+        }
+        // madvise() takes page-aligned addresses
+        static const auto page_size = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+        const uint64_t start = offset - offset % page_size;
+        const uint64_t end = std::min(m_size, offset + length);
+        ::madvise(static_cast<uint8_t*>(m_address) + start, end - start, MADV_WILLNEED);
+    }
+
+private:
+    void* m_address = MAP_FAILED;
+    uint64_t m_size = 0;
+};
+
+#else
+
+// Without pread(), reads share one stream and are serialized
+class FileByteSource : public PsarcByteSource
+{
+public:
+    explicit FileByteSource(std::string path) : m_path(std::move(path))
+    {
+        m_file.open(m_path, std::ios::binary | std::ios::ate);
+        if (!m_file)
+        {
+            throw PsarcException(std::format("Failed to open file: {}", m_path));
+        }
+        m_size = static_cast<uint64_t>(m_file.tellg());
+    }
+
+    [[nodiscard]] uint64_t GetSize() const override
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] size_t ReadAt(uint64_t offset, std::span<uint8_t> buffer) const override
+    {
+        const std::scoped_lock lock(m_mutex);
+        m_file.clear();
+        m_file.seekg(static_cast<std::streamoff>(offset));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        m_file.read(reinterpret_cast<char*>(buffer.data()),
+                    static_cast<std::streamsize>(buffer.size()));
+        if (m_file.bad())
+        {
+            throw PsarcException(std::format("Failed to read {}", m_path));
+        }
+        return static_cast<size_t>(m_file.gcount());
+    }
+
+private:
+    std::string m_path;
+    mutable std::mutex m_mutex;
+    mutable std::ifstream m_file;
+    uint64_t m_size = 0;
+};
+
+std::string GetErrorMessage(DWORD error)
+{
+    return std::system_category().message(static_cast<int>(error));
+}
+
+class MappedByteSource : public PsarcByteSource
+{
+public:
+    explicit MappedByteSource(const std::string& path)
+    {
+        // Sharing matches POSIX, where other processes may write or unlink a mapped file
+        const HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ,
+                                          FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                          nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw PsarcException(std::format("Failed to open file: {}", path));
+        }
+
+        LARGE_INTEGER size{};
+        if (::GetFileSizeEx(file, &size) == 0)
+        {
+            const DWORD error = ::GetLastError();
+            ::CloseHandle(file);
+            throw PsarcException(
+                std::format("Failed to stat {}: {}", path, GetErrorMessage(error)));
+        }
+        m_size = static_cast<uint64_t>(size.QuadPart);
+        if (m_size == 0)
+        {
+            // CreateFileMapping() rejects empty files
+            ::CloseHandle(file);
+            return;
+        }
+
+        // The view keeps the mapping alive, so neither handle is needed once it exists
+        const HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        DWORD error = ::GetLastError();
+        ::CloseHandle(file);
+        if (mapping != nullptr)
+        {
+            m_address = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            error = ::GetLastError();
+            ::CloseHandle(mapping);
+        }
+        if (m_address == nullptr)
+        {
+            throw PsarcException(std::format("Failed to map {}: {}", path, GetErrorMessage(error)));
+        }
+    }
+
+    ~MappedByteSource() override
+    {
+        if (m_address != nullptr)
+        {
+            ::UnmapViewOfFile(m_address);
+        }
+    }
+
+    MappedByteSource(const MappedByteSource&) = delete;
+    MappedByteSource& operator=(const MappedByteSource&) = delete;
+    MappedByteSource(MappedByteSource&&) = delete;
+    MappedByteSource& operator=(MappedByteSource&&) = delete;
+
+    [[nodiscard]] uint64_t GetSize() const override
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] size_t ReadAt(uint64_t offset, std::span<uint8_t> buffer) const override
+    {
+        return ReadFromSpan(GetData(), offset, buffer);
+    }
+
+    [[nodiscard]] std::span<const uint8_t> GetData() const override
+    {
+        if (m_address == nullptr)
+        {
+            return {};
+        }
+        return {static_cast<const uint8_t*>(m_address), static_cast<size_t>(m_size)};
+    }
+
+private:
+    void* m_address = nullptr;
+    uint64_t m_size = 0;
+};
+
+#endif
+
+} // namespace
+
+std::shared_ptr<PsarcByteSource> PsarcByteSource::OpenFile(const std::string& path)
+{
+    return std::make_shared<FileByteSource>(path);
+}
+
+std::shared_ptr<PsarcByteSource> PsarcByteSource::MapFile(const std::string& path)
+{
+    return std::make_shared<MappedByteSource>(path);
+}
+
+std::shared_ptr<PsarcByteSource> PsarcByteSource::FromMemory(std::span<const uint8_t> data)
+{
+    return std::make_shared<MemoryByteSource>(data);
+}
+
+std::shared_ptr<PsarcByteSource> PsarcByteSource::FromMemory(std::vector<uint8_t> data)
+{
+    return std::make_shared<MemoryByteSource>(std::move(data));
+}
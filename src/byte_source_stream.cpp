@@ -0,0 +1,128 @@
+#include "byte_source_stream.h"
+
+#include "psarc_format.h"
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <utility>
+
+ByteSourceBuffer::ByteSourceBuffer(std::shared_ptr<const PsarcByteSource> source)
+    : m_source(std::move(source)), m_size(m_source->GetSize()),
+      m_in_memory(!m_source->GetData().empty())
+{
+    if (m_in_memory)
+    {
+        // The get area is only ever read, so handing it the source's bytes as char* is safe
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-*)
+        auto* begin = const_cast<char*>(reinterpret_cast<const char*>(m_source->GetData().data()));
+        setg(begin, begin, begin + m_size);
+        return;
+    }
+
+    // One maximum-size block, so sequential block reads refill once per block at most
+    m_buffer.resize(g_max_block_size);
+    setg(m_buffer.data(), m_buffer.data(), m_buffer.data());
+}
+
+uint64_t ByteSourceBuffer::GetPosition() const
+{
+    return m_buffer_offset + static_cast<uint64_t>(gptr() - eback());
+}
+
+ByteSourceBuffer::int_type ByteSourceBuffer::underflow()
+{
+    if (gptr() < egptr())
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+    if (m_in_memory)
+    {
+        return traits_type::eof();
+    }
+
+    const uint64_t position = GetPosition();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const size_t count = m_source->ReadAt(
+        position, {reinterpret_cast<uint8_t*>(m_buffer.data()), m_buffer.size()});
+    m_buffer_offset = position;
+    setg(m_buffer.data(), m_buffer.data(), m_buffer.data() + count);
+    return count == 0 ? traits_type::eof() : traits_type::to_int_type(*gptr());
+}
+
+std::streamsize ByteSourceBuffer::xsgetn(char* data, std::streamsize count)
+{
+    const auto buffered = std::min<std::streamsize>(egptr() - gptr(), count);
+    std::memcpy(data, gptr(), static_cast<size_t>(buffered));
+    setg(eback(), gptr() + buffered, egptr());
+    if (buffered == count || m_in_memory)
+    {
+        return buffered;
+    }
+
+    // Reads at least a buffer long skip the buffer and land directly in the caller's memory
+    const auto remaining = count - buffered;
+    if (std::cmp_less(remaining, m_buffer.size()))
+    {
+        return buffered + std::streambuf::xsgetn(data + buffered, remaining);
+    }
+
+    const uint64_t position = GetPosition();
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const size_t read = m_source->ReadAt(
+        position, {reinterpret_cast<uint8_t*>(data + buffered), static_cast<size_t>(remaining)});
+    m_buffer_offset = position + read;
+    setg(m_buffer.data(), m_buffer.data(), m_buffer.data());
+    return buffered + static_cast<std::streamsize>(read);
+}
+
+ByteSourceBuffer::pos_type ByteSourceBuffer::seekoff(off_type offset,
+                                                     std::ios_base::seekdir direction,
+                                                     std::ios_base::openmode mode)
+{
+    off_type base = 0;
+    if (direction == std::ios_base::cur)
+    {
+        base = static_cast<off_type>(GetPosition());
+    }
+    else if (direction == std::ios_base::end)
+    {
+        base = static_cast<off_type>(m_size);
+    }
+    return seekpos(pos_type(base + offset), mode);
+}
+
+ByteSourceBuffer::pos_type ByteSourceBuffer::seekpos(pos_type position,
+                                                     std::ios_base::openmode mode)
+{
+    const auto target = static_cast<off_type>(position);
+    if ((mode & std::ios_base::in) == 0 || target < 0 || std::cmp_greater(target, m_size))
+    {
+        return pos_type(off_type(-1));
+    }
+
+    const auto offset = static_cast<uint64_t>(target);
+    if (m_in_memory)
+    {
+        setg(eback(), eback() + offset, egptr());
+        return position;
+    }
+
+    // Keep the buffered bytes when the target falls inside them
+    const auto buffered = static_cast<uint64_t>(egptr() - eback());
+    if (offset >= m_buffer_offset && offset <= m_buffer_offset + buffered)
+    {
+        setg(eback(), eback() + (offset - m_buffer_offset), egptr());
+        return position;
+    }
+
+    m_buffer_offset = offset;
+    setg(m_buffer.data(), m_buffer.data(), m_buffer.data());
+    return position;
+}
+
+ByteSourceStream::ByteSourceStream(std::shared_ptr<const PsarcByteSource> source)
+    : std::istream(nullptr), m_buffer(std::move(source))
+{
+    rdbuf(&m_buffer);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "open-psarc/psarc_byte_source.h"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <vector>
+
+// Seekable streambuf over a PsarcByteSource. Sources already in memory are read in place; others
+// go through a buffer refilled with positional reads, so each stream keeps its own position.
+class ByteSourceBuffer : public std::streambuf
+{
+public:
+    explicit ByteSourceBuffer(std::shared_ptr<const PsarcByteSource> source);
+
+protected:
+    int_type underflow() override;
+    std::streamsize xsgetn(char* data, std::streamsize count) override;
+    pos_type seekoff(off_type offset, std::ios_base::seekdir direction,
+                     std::ios_base::openmode mode) override;
+    pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+
+private:
+    [[nodiscard]] uint64_t GetPosition() const;
+
+    std::shared_ptr<const PsarcByteSource> m_source;
+    uint64_t m_size;
+    bool m_in_memory;
+    std::vector<char> m_buffer;
+    uint64_t m_buffer_offset = 0; // Source offset of the buffer's first byte
+};
+
+// Input stream with its own position over a shared source, one per reading thread
+class ByteSourceStream : public std::istream
+{
+public:
+    explicit ByteSourceStream(std::shared_ptr<const PsarcByteSource> source);
+
+private:
+    ByteSourceBuffer m_buffer;
+};
@@ -0,0 +1,319 @@
+#include "open-psarc/psarc_catalog.h"
+
+#include "psarc_format.h"
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+
+// Little-endian layout: header, archive records, entry records, hash buckets, then the strings
+// that the records point into
+constexpr uint32_t g_catalog_magic = 0x50434154; // "PCAT"
+constexpr uint32_t g_catalog_version = 1;
+constexpr uint64_t g_catalog_header_size = 32;
+constexpr uint64_t g_archive_record_size = 8;  // String offset, length
+constexpr uint64_t g_entry_record_size = 24;   // Name offset, length, archive, TOC index, size
+constexpr uint64_t g_bucket_size = 8;          // Entry number + 1 (0 = empty), name hash
+
+uint32_t HashName(std::string_view name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261U;
+    for (const char c : name)
+    {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619U;
+    }
+    return hash;
+}
+
+uint64_t GetImageSize(uint64_t archives, uint64_t entries, uint64_t buckets)
+{
+    return g_catalog_header_size + archives * g_archive_record_size +
+           entries * g_entry_record_size + buckets * g_bucket_size;
+}
+
+[[noreturn]] void ThrowCorrupt(std::string_view problem)
+{
+    throw PsarcException(std::format("Corrupt catalog: {}", problem));
+}
+
+} // namespace
+
+// ─── PsarcCatalogBuilder ──────────────────────────────────────────────────────
+
+void PsarcCatalogBuilder::AddArchive(const std::string& path)
+{
+    PsarcFile archive(path);
+    archive.Open();
+    AddArchive(path, archive);
+}
+
+void PsarcCatalogBuilder::AddArchive(const std::string& path, const PsarcFile& archive)
+{
+    if (!archive.IsOpen())
+    {
+        throw PsarcException("Archive is not open");
+    }
+
+    const auto archive_index = static_cast<uint32_t>(m_archive_paths.size());
+    m_archive_paths.push_back(path);
+    for (const auto& entry : archive.GetEntries())
+    {
+        m_entries.push_back({.name = std::string(entry.name),
+                             .archive = archive_index,
+                             .index = entry.index,
+                             .size = entry.size});
+    }
+}
+
+std::vector<uint8_t> PsarcCatalogBuilder::Build() const
+{
+    // Buckets stay at most half full so probe sequences are short and always end at a gap
+    const uint64_t bucket_count = std::bit_ceil(std::max<uint64_t>(m_entries.size() * 2, 1));
+    if (bucket_count > std::numeric_limits<uint32_t>::max())
+    {
+        throw PsarcException(std::format("Too many catalog entries: {}", m_entries.size()));
+    }
+
+    uint64_t strings_size = 0;
+    for (const auto& path : m_archive_paths)
+    {
+        strings_size += path.size();
+    }
+    for (const auto& entry : m_entries)
+    {
+        strings_size += entry.name.size();
+    }
+    if (strings_size > std::numeric_limits<uint32_t>::max())
+    {
+        throw PsarcException("Catalog names exceed 4 GiB");
+    }
+
+    const uint64_t strings_offset =
+        GetImageSize(m_archive_paths.size(), m_entries.size(), bucket_count);
+    std::vector<uint8_t> image(strings_offset + strings_size);
+    uint8_t* header = image.data();
+    WriteBE32(header, g_catalog_magic);
+    WriteLE32(header + 4, g_catalog_version);
+    WriteLE32(header + 8, static_cast<uint32_t>(m_archive_paths.size()));
+    WriteLE32(header + 12, static_cast<uint32_t>(m_entries.size()));
+    WriteLE32(header + 16, static_cast<uint32_t>(bucket_count));
+    WriteLE64(header + 24, strings_size);
+
+    uint32_t string_end = 0;
+    const auto add_string = [&](uint8_t* record, std::string_view value) {
+        WriteLE32(record, string_end);
+        WriteLE32(record + 4, static_cast<uint32_t>(value.size()));
+        std::ranges::copy(value, image.data() + strings_offset + string_end);
+        string_end += static_cast<uint32_t>(value.size());
+    };
+
+    uint8_t* record = image.data() + g_catalog_header_size;
+    for (const auto& path : m_archive_paths)
+    {
+        add_string(record, path);
+        record += g_archive_record_size;
+    }
+
+    uint8_t* buckets = record + m_entries.size() * g_entry_record_size;
+    const auto mask = static_cast<uint32_t>(bucket_count - 1);
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        const auto& entry = m_entries[i];
+        add_string(record, entry.name);
+        WriteLE32(record + 8, entry.archive);
+        WriteLE32(record + 12, static_cast<uint32_t>(entry.index));
+        WriteLE64(record + 16, entry.size);
+        record += g_entry_record_size;
+
+        // Linear probing keeps entries with the same name in the order they were added
+        const uint32_t hash = HashName(entry.name);
+        uint32_t bucket = hash & mask;
+        while (ReadLE32(buckets + bucket * g_bucket_size) != 0)
+        {
+            bucket = (bucket + 1) & mask;
+        }
+        WriteLE32(buckets + bucket * g_bucket_size, static_cast<uint32_t>(i + 1));
+        WriteLE32(buckets + bucket * g_bucket_size + 4, hash);
+    }
+    return image;
+}
+
+void PsarcCatalogBuilder::Save(const std::string& path) const
+{
+    const auto image = Build();
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw PsarcException(std::format("Failed to create file: {}", temp_path));
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        out.write(reinterpret_cast<const char*>(image.data()),
+                  static_cast<std::streamsize>(image.size()));
+        out.close();
+        if (!out)
+        {
+            fs::remove(temp_path);
+            throw PsarcException(std::format("Failed to write file: {}", temp_path));
+        }
+    }
+    fs::rename(temp_path, path);
+}
+
+// ─── PsarcCatalog ─────────────────────────────────────────────────────────────
+
+PsarcCatalog PsarcCatalog::Load(const std::string& path)
+{
+    return PsarcCatalog(PsarcByteSource::MapFile(path));
+}
+
+PsarcCatalog::PsarcCatalog(std::shared_ptr<const PsarcByteSource> source)
+    : m_source(std::move(source))
+{
+    if (!m_source)
+    {
+        throw PsarcException("PsarcCatalog needs a byte source");
+    }
+    if (m_source->GetData().empty() && m_source->GetSize() != 0)
+    {
+        std::vector<uint8_t> data(m_source->GetSize());
+        if (m_source->ReadAt(0, data) != data.size())
+        {
+            ThrowCorrupt("truncated");
+        }
+        m_source = PsarcByteSource::FromMemory(std::move(data));
+    }
+    m_data = m_source->GetData();
+
+    if (m_data.size() < g_catalog_header_size || ReadBE32(m_data.data()) != g_catalog_magic)
+    {
+        ThrowCorrupt("not a catalog file");
+    }
+    if (const uint32_t version = ReadLE32(m_data.data() + 4); version != g_catalog_version)
+    {
+        throw PsarcException(std::format("Unsupported catalog version {}", version));
+    }
+    m_archive_count = ReadLE32(m_data.data() + 8);
+    m_entry_count = ReadLE32(m_data.data() + 12);
+    m_bucket_count = ReadLE32(m_data.data() + 16);
+    m_strings_size = ReadLE64(m_data.data() + 24);
+    m_strings_offset = GetImageSize(m_archive_count, m_entry_count, m_bucket_count);
+
+    if (!std::has_single_bit(m_bucket_count) || m_bucket_count <= m_entry_count)
+    {
+        ThrowCorrupt(std::format("{} buckets for {} entries", m_bucket_count, m_entry_count));
+    }
+    if (m_strings_size > m_data.size() || m_strings_offset != m_data.size() - m_strings_size)
+    {
+        ThrowCorrupt(std::format("size {} does not match its contents", m_data.size()));
+    }
+}
+
+size_t PsarcCatalog::GetArchiveCount() const
+{
+    return m_archive_count;
+}
+
+size_t PsarcCatalog::GetEntryCount() const
+{
+    return m_entry_count;
+}
+
+std::string_view PsarcCatalog::GetArchivePath(size_t index) const
+{
+    if (index >= m_archive_count)
+    {
+        throw PsarcException(std::format("Catalog archive index {} out of range", index));
+    }
+    const uint8_t* record = m_data.data() + g_catalog_header_size + index * g_archive_record_size;
+    return GetString(ReadLE32(record), ReadLE32(record + 4));
+}
+
+std::optional<PsarcCatalogEntry> PsarcCatalog::Find(std::string_view name) const
+{
+    std::optional<PsarcCatalogEntry> result;
+    ForEachMatch(name, [&](const PsarcCatalogEntry& entry) {
+        result = entry;
+        return false;
+    });
+    return result;
+}
+
+std::vector<PsarcCatalogEntry> PsarcCatalog::FindAll(std::string_view name) const
+{
+    std::vector<PsarcCatalogEntry> result;
+    ForEachMatch(name, [&](const PsarcCatalogEntry& entry) {
+        result.push_back(entry);
+        return true;
+    });
+    return result;
+}
+
+// Calls visit for each entry named name until it returns false
+template <typename Visitor>
+void PsarcCatalog::ForEachMatch(std::string_view name, Visitor&& visit) const
+{
+    const uint8_t* entries = m_data.data() + g_catalog_header_size +
+                             uint64_t{m_archive_count} * g_archive_record_size;
+    const uint8_t* buckets = entries + uint64_t{m_entry_count} * g_entry_record_size;
+    const uint32_t hash = HashName(name);
+    const uint32_t mask = m_bucket_count - 1;
+
+    for (uint32_t bucket = hash & mask, probes = 0; probes < m_bucket_count;
+         bucket = (bucket + 1) & mask, ++probes)
+    {
+        const uint8_t* slot = buckets + uint64_t{bucket} * g_bucket_size;
+        const uint32_t slot_entry = ReadLE32(slot);
+        if (slot_entry == 0)
+        {
+            return;
+        }
+        if (ReadLE32(slot + 4) != hash)
+        {
+            continue;
+        }
+        if (slot_entry > m_entry_count)
+        {
+            ThrowCorrupt(std::format("bucket {} points past the entries", bucket));
+        }
+
+        const uint8_t* record = entries + uint64_t{slot_entry - 1} * g_entry_record_size;
+        if (GetString(ReadLE32(record), ReadLE32(record + 4)) == name &&
+            !visit(ReadEntry(slot_entry - 1)))
+        {
+            return;
+        }
+    }
+}
+
+std::string_view PsarcCatalog::GetString(uint64_t offset, uint64_t length) const
+{
+    if (offset > m_strings_size || length > m_strings_size - offset)
+    {
+        ThrowCorrupt("string out of range");
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {reinterpret_cast<const char*>(m_data.data() + m_strings_offset + offset),
+            static_cast<size_t>(length)};
+}
+
+PsarcCatalogEntry PsarcCatalog::ReadEntry(uint32_t index) const
+{
+    const uint8_t* record = m_data.data() + g_catalog_header_size +
+                            uint64_t{m_archive_count} * g_archive_record_size +
+                            uint64_t{index} * g_entry_record_size;
+    return {.archive_path = GetArchivePath(ReadLE32(record + 8)),
+            .index = static_cast<int>(ReadLE32(record + 12)),
+            .size = ReadLE64(record + 16)};
+}
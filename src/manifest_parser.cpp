@@ -0,0 +1,189 @@
+#include "manifest_parser.h"
+
+#include "trace.h"
+
+#include <initializer_list>
+#include <nlohmann/json.hpp>
+#include <type_traits>
+
+namespace
+{
+
+const nlohmann::json* FindJsonKey(const nlohmann::json& obj,
+                                  std::initializer_list<std::string_view> keys)
+{
+    if (!obj.is_object())
+    {
+        return nullptr;
+    }
+
+    for (const auto key : keys)
+    {
+        const std::string key_str(key);
+        if (obj.contains(key_str))
+        {
+            return &obj.at(key_str);
+        }
+    }
+    return nullptr;
+}
+
+const nlohmann::json* ResolveManifestSource(const nlohmann::json& root)
+{
+    if (!root.is_object())
+    {
+        return nullptr;
+    }
+
+    const auto* entries = FindJsonKey(root, {"Entries", "entries"});
+    if (!entries || !entries->is_object() || entries->empty())
+    {
+        return nullptr;
+    }
+
+    const auto first = entries->begin();
+    if (!first.value().is_object())
+    {
+        return nullptr;
+    }
+
+    const auto* attributes = FindJsonKey(first.value(), {"Attributes", "attributes"});
+    if (!attributes || !attributes->is_object())
+    {
+        return nullptr;
+    }
+
+    return attributes;
+}
+
+template <typename T>
+std::optional<T> ReadJsonValue(const nlohmann::json& obj,
+                               std::initializer_list<std::string_view> keys)
+{
+    const auto* value = FindJsonKey(obj, keys);
+    if (!value || value->is_null())
+    {
+        return std::nullopt;
+    }
+
+    if constexpr (std::is_same_v<T, std::string>)
+    {
+        if (value->is_string())
+        {
+            return value->get<std::string>();
+        }
+        return std::nullopt;
+    }
+    if constexpr (std::is_same_v<T, float>)
+    {
+        if (value->is_number())
+        {
+            return static_cast<float>(value->get<double>());
+        }
+        return std::nullopt;
+    }
+    if constexpr (std::is_same_v<T, int>)
+    {
+        if (value->is_number_integer() || value->is_number_unsigned())
+        {
+            return value->get<int>();
+        }
+        if (value->is_number_float())
+        {
+            return static_cast<int>(value->get<double>());
+        }
+        return std::nullopt;
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
+SngManifestMetadata ManifestParser::Parse(std::string_view json_text)
+{
+    PSARC_TRACE_SCOPE("ManifestParser::Parse");
+    SngManifestMetadata metadata;
+
+    nlohmann::json root;
+    try
+    {
+        constexpr std::string_view utf8_bom("\xEF\xBB\xBF");
+        std::string_view payload = json_text;
+        if (payload.starts_with(utf8_bom))
+        {
+            payload.remove_prefix(utf8_bom.size());
+        }
+        root = nlohmann::json::parse(payload);
+    }
+    catch (const std::exception&)
+    {
+        return metadata;
+    }
+
+    const nlohmann::json* source = ResolveManifestSource(root);
+    if (!source)
+    {
+        return metadata;
+    }
+
+    metadata.title = ReadJsonValue<std::string>(*source, {"SongName", "songName"});
+    metadata.arrangement =
+        ReadJsonValue<std::string>(*source, {"ArrangementName", "arrangementName"});
+    metadata.cent_offset = ReadJsonValue<float>(*source, {"CentOffset", "centOffset"});
+    metadata.song_name_sort = ReadJsonValue<std::string>(*source, {"SongNameSort", "songNameSort"});
+    metadata.average_tempo =
+        ReadJsonValue<float>(*source, {"SongAverageTempo", "songAverageTempo"});
+    metadata.artist_name = ReadJsonValue<std::string>(*source, {"ArtistName", "artistName"});
+    metadata.artist_name_sort =
+        ReadJsonValue<std::string>(*source, {"ArtistNameSort", "artistNameSort"});
+    metadata.album_name = ReadJsonValue<std::string>(*source, {"AlbumName", "albumName"});
+    metadata.album_name_sort =
+        ReadJsonValue<std::string>(*source, {"AlbumNameSort", "albumNameSort"});
+    metadata.album_year = ReadJsonValue<int>(*source, {"SongYear", "songYear"});
+    metadata.tone_base = ReadJsonValue<std::string>(*source, {"Tone_Base", "toneBase"});
+    metadata.tone_names[0] = ReadJsonValue<std::string>(*source, {"Tone_A", "toneA"});
+    metadata.tone_names[1] = ReadJsonValue<std::string>(*source, {"Tone_B", "toneB"});
+    metadata.tone_names[2] = ReadJsonValue<std::string>(*source, {"Tone_C", "toneC"});
+    metadata.tone_names[3] = ReadJsonValue<std::string>(*source, {"Tone_D", "toneD"});
+
+    const auto* props = FindJsonKey(*source, {"ArrangementProperties", "arrangementProperties"});
+    if (props && props->is_object())
+    {
+        SngManifestArrangementProperties parsed;
+        parsed.represent = ReadJsonValue<int>(*props, {"represent"}).value_or(0);
+        parsed.bonus_arr = ReadJsonValue<int>(*props, {"bonusArr"}).value_or(0);
+        parsed.standard_tuning = ReadJsonValue<int>(*props, {"standardTuning"}).value_or(0);
+        parsed.non_standard_chords = ReadJsonValue<int>(*props, {"nonStandardChords"}).value_or(0);
+        parsed.barre_chords = ReadJsonValue<int>(*props, {"barreChords"}).value_or(0);
+        parsed.power_chords = ReadJsonValue<int>(*props, {"powerChords"}).value_or(0);
+        parsed.drop_d_power = ReadJsonValue<int>(*props, {"dropDPower"}).value_or(0);
+        parsed.open_chords = ReadJsonValue<int>(*props, {"openChords"}).value_or(0);
+        parsed.finger_picking = ReadJsonValue<int>(*props, {"fingerPicking"}).value_or(0);
+        parsed.pick_direction = ReadJsonValue<int>(*props, {"pickDirection"}).value_or(0);
+        parsed.double_stops = ReadJsonValue<int>(*props, {"doubleStops"}).value_or(0);
+        parsed.palm_mutes = ReadJsonValue<int>(*props, {"palmMutes"}).value_or(0);
+        parsed.harmonics = ReadJsonValue<int>(*props, {"harmonics"}).value_or(0);
+        parsed.pinch_harmonics = ReadJsonValue<int>(*props, {"pinchHarmonics"}).value_or(0);
+        parsed.hopo = ReadJsonValue<int>(*props, {"hopo"}).value_or(0);
+        parsed.tremolo = ReadJsonValue<int>(*props, {"tremolo"}).value_or(0);
+        parsed.slides = ReadJsonValue<int>(*props, {"slides"}).value_or(0);
+        parsed.unpitched_slides = ReadJsonValue<int>(*props, {"unpitchedSlides"}).value_or(0);
+        parsed.bends = ReadJsonValue<int>(*props, {"bends"}).value_or(0);
+        parsed.tapping = ReadJsonValue<int>(*props, {"tapping"}).value_or(0);
+        parsed.vibrato = ReadJsonValue<int>(*props, {"vibrato"}).value_or(0);
+        parsed.fret_hand_mutes = ReadJsonValue<int>(*props, {"fretHandMutes"}).value_or(0);
+        parsed.slap_pop = ReadJsonValue<int>(*props, {"slapPop"}).value_or(0);
+        parsed.two_finger_picking = ReadJsonValue<int>(*props, {"twoFingerPicking"}).value_or(0);
+        parsed.fifths_and_octaves = ReadJsonValue<int>(*props, {"fifthsAndOctaves"}).value_or(0);
+        parsed.syncopation = ReadJsonValue<int>(*props, {"syncopation"}).value_or(0);
+        parsed.bass_pick = ReadJsonValue<int>(*props, {"bassPick"}).value_or(0);
+        parsed.sustain = ReadJsonValue<int>(*props, {"sustain"}).value_or(0);
+        parsed.path_lead = ReadJsonValue<int>(*props, {"pathLead"}).value_or(0);
+        parsed.path_rhythm = ReadJsonValue<int>(*props, {"pathRhythm"}).value_or(0);
+        parsed.path_bass = ReadJsonValue<int>(*props, {"pathBass"}).value_or(0);
+        metadata.arrangement_properties = parsed;
+    }
+
+    return metadata;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "sng_xml_writer.h"
+
+#include <string_view>
+
+class ManifestParser
+{
+public:
+    // Reads the song metadata SngXmlWriter embeds from a manifest JSON's first entry. Malformed or
+    // unrecognized manifests yield empty metadata rather than an error.
+    [[nodiscard]] static SngManifestMetadata Parse(std::string_view json_text);
+};
@@ -0,0 +1,50 @@
+#include "memory_budget.h"
+
+#include <algorithm>
+
+MemoryBudget::MemoryBudget(uint64_t capacity) : m_capacity(capacity)
+{
+}
+
+void MemoryBudget::Acquire(uint64_t bytes)
+{
+    if (m_capacity == 0)
+    {
+        return;
+    }
+
+    bytes = Clamp(bytes);
+    std::unique_lock lock(m_mutex);
+    m_released.wait(lock, [&] { return m_in_use + bytes <= m_capacity; });
+    m_in_use += bytes;
+}
+
+void MemoryBudget::Release(uint64_t bytes)
+{
+    if (m_capacity == 0)
+    {
+        return;
+    }
+
+    {
+        const std::scoped_lock lock(m_mutex);
+        m_in_use -= Clamp(bytes);
+    }
+    m_released.notify_all();
+}
+
+uint64_t MemoryBudget::Clamp(uint64_t bytes) const
+{
+    return std::min(bytes, m_capacity);
+}
+
+MemoryBudget::Reservation::Reservation(MemoryBudget& budget, uint64_t bytes)
+    : m_budget(budget), m_bytes(bytes)
+{
+    m_budget.Acquire(m_bytes);
+}
+
+MemoryBudget::Reservation::~Reservation()
+{
+    m_budget.Release(m_bytes);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// Counting semaphore over bytes held by in-flight work. A capacity of zero means unlimited.
+class MemoryBudget
+{
+public:
+    explicit MemoryBudget(uint64_t capacity);
+
+    // Blocks until the bytes fit. Requests larger than the whole budget are clamped to it, so they
+    // wait for everything else to drain and then run alone.
+    void Acquire(uint64_t bytes);
+    void Release(uint64_t bytes);
+
+    class Reservation
+    {
+    public:
+        Reservation(MemoryBudget& budget, uint64_t bytes);
+        ~Reservation();
+
+        Reservation(const Reservation&) = delete;
+        Reservation& operator=(const Reservation&) = delete;
+
+    private:
+        MemoryBudget& m_budget;
+        uint64_t m_bytes;
+    };
+
+private:
+    [[nodiscard]] uint64_t Clamp(uint64_t bytes) const;
+
+    std::mutex m_mutex;
+    std::condition_variable m_released;
+    uint64_t m_capacity;
+    uint64_t m_in_use = 0;
+};
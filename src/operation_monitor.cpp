@@ -0,0 +1,87 @@
+#include "operation_monitor.h"
+
+#include <algorithm>
+#include <exception>
+
+OperationMonitor::OperationMonitor(const PsarcOptions& options, uint64_t entries_total,
+                                   uint64_t bytes_total)
+    : m_callback(options.progress), m_stop_token(options.stop_token)
+{
+    m_progress.entries_total = entries_total;
+    m_progress.bytes_total = bytes_total;
+
+    const std::scoped_lock lock(m_mutex);
+    Report();
+}
+
+void OperationMonitor::ThrowIfCancelled() const
+{
+    if (m_stop_token.stop_requested())
+    {
+        throw PsarcCancelledException("Operation cancelled");
+    }
+}
+
+void OperationMonitor::AddBytes(uint64_t bytes)
+{
+    if (bytes == 0)
+    {
+        return;
+    }
+
+    const std::scoped_lock lock(m_mutex);
+    m_progress.bytes_done += bytes;
+    Report();
+}
+
+void OperationMonitor::CompleteEntry()
+{
+    const std::scoped_lock lock(m_mutex);
+    ++m_progress.entries_done;
+    Report();
+}
+
+void OperationMonitor::Report()
+{
+    if (m_callback)
+    {
+        m_callback(m_progress);
+    }
+}
+
+OperationMonitor::Task::Task(OperationMonitor& monitor, uint64_t weight)
+    : m_monitor(monitor), m_weight(weight), m_uncaught(std::uncaught_exceptions())
+{
+}
+
+OperationMonitor::Task::~Task()
+{
+    // Unwinding past a task means the operation was abandoned (cancelled) rather than that the
+    // entry finished, so it is not counted
+    if (std::uncaught_exceptions() > m_uncaught)
+    {
+        return;
+    }
+
+    // Callbacks may throw, but never out of a destructor
+    try
+    {
+        m_monitor.AddBytes(m_weight - m_reported);
+        m_monitor.CompleteEntry();
+    }
+    catch (...) // NOLINT(bugprone-empty-catch)
+    {
+    }
+}
+
+void OperationMonitor::Task::ThrowIfCancelled() const
+{
+    m_monitor.ThrowIfCancelled();
+}
+
+void OperationMonitor::Task::AddBytes(uint64_t bytes)
+{
+    bytes = std::min(bytes, m_weight - m_reported);
+    m_reported += bytes;
+    m_monitor.AddBytes(bytes);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "open-psarc/psarc_file.h"
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+
+// Aggregates progress from the workers of one bulk operation, forwards it to the caller's
+// callback one call at a time, and polls the caller's stop token
+class OperationMonitor
+{
+public:
+    OperationMonitor(const PsarcOptions& options, uint64_t entries_total, uint64_t bytes_total);
+
+    // Throws PsarcCancelledException once a stop has been requested
+    void ThrowIfCancelled() const;
+
+    void AddBytes(uint64_t bytes);
+    void CompleteEntry();
+
+    // Progress of a single entry. Bytes reported through it are capped at the entry's weight, and
+    // whatever was not reported (cache hits, failures) is credited when the task ends normally.
+    class Task
+    {
+    public:
+        Task(OperationMonitor& monitor, uint64_t weight);
+        ~Task();
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        void ThrowIfCancelled() const;
+        void AddBytes(uint64_t bytes);
+
+    private:
+        OperationMonitor& m_monitor;
+        uint64_t m_weight;
+        uint64_t m_reported = 0;
+        int m_uncaught;
+    };
+
+private:
+    void Report();
+
+    std::function<void(const PsarcProgress&)> m_callback;
+    std::stop_token m_stop_token;
+    std::mutex m_mutex;
+    PsarcProgress m_progress;
+};
@@ -2,19 +2,36 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
 #include <optional>
+#include <random>
+#include <span>
 #include <sstream>
 #include <string_view>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
+#include "byte_source_stream.h"
+#include "manifest_parser.h"
+#include "memory_budget.h"
+#include "operation_monitor.h"
+#include "psarc_format.h"
+#include "psarc_writer.h"
 #include "sng_parser.h"
 #include "sng_xml_writer.h"
+#include "stats_collector.h"
+#include "trace.h"
 
 #include <lzma.h>
 #include <nlohmann/json.hpp>
@@ -22,230 +39,373 @@
 #include <wwtools/wwtools.h>
 #include <zlib.h>
 
-namespace fs = std::filesystem;
-
-static constexpr std::array<uint8_t, 32> g_psarc_key = {
-    0xC5, 0x3D, 0xB2, 0x38, 0x70, 0xA1, 0xA2, 0xF7, 0x1C, 0xAE, 0x64, 0x06, 0x1F, 0xDD, 0x0E, 0x11,
-    0x57, 0x30, 0x9D, 0xC8, 0x52, 0x04, 0xD4, 0xC5, 0xBF, 0xDF, 0x25, 0x09, 0x0D, 0xF2, 0x57, 0x2C};
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
-static constexpr std::array<uint8_t, 16> g_psarc_iv = {
-    0xE9, 0x15, 0xAA, 0x01, 0x8F, 0xEF, 0x71, 0xFC, 0x50, 0x81, 0x32, 0xE4, 0xBB, 0x4C, 0xEB, 0x42};
+namespace fs = std::filesystem;
 
-static constexpr std::array<uint8_t, 32> g_sng_key = {
-    0xCB, 0x64, 0x8D, 0xF3, 0xD1, 0x2A, 0x16, 0xBF, 0x71, 0x70, 0x14, 0x14, 0xE6, 0x96, 0x19, 0xEC,
-    0x17, 0x1C, 0xCA, 0x5D, 0x2A, 0x14, 0x2E, 0x3E, 0x59, 0xDE, 0x7A, 0xDD, 0xA1, 0x8A, 0x3A, 0x30};
+bool IsLikelyManifestFile(std::string_view path)
+{
+    return path.ends_with(".json") && path.find("songs_dlc_") != std::string_view::npos;
+}
 
-static constexpr uint32_t g_psarc_magic = 0x50534152;
-static constexpr uint32_t g_sng_magic = 0x4A;
-static constexpr uint32_t g_toc_encrypted_flag = 0x04;
-static constexpr uint32_t g_sng_compressed_flag = 0x01;
+bool IsSngFile(std::string_view path)
+{
+    return path.find("songs/bin/generic/") != std::string_view::npos && path.ends_with(".sng");
+}
 
-[[nodiscard]] static constexpr uint16_t ReadLE16(const uint8_t* data) noexcept
+// Distinguishes every opened archive, and every reopening of one, in a shared block cache
+uint64_t NextArchiveId()
 {
-    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    static std::atomic<uint64_t> next_id{1};
+    return next_id++;
 }
 
-[[nodiscard]] static constexpr uint32_t ReadLE32(const uint8_t* data) noexcept
+std::string ToLower(std::string value)
 {
-    return data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
+    std::ranges::transform(value, value.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
 }
 
-[[nodiscard]] static constexpr uint16_t ReadBE16(const uint8_t* data) noexcept
+std::string ToHex(std::span<const uint8_t> bytes)
 {
-    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (const uint8_t b : bytes)
+    {
+        hex += std::format("{:02x}", b);
+    }
+    return hex;
 }
 
-[[nodiscard]] static constexpr uint32_t ReadBE32(const uint8_t* data) noexcept
+template <typename Container> void WriteFile(const fs::path& path, const Container& data)
 {
-    return (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+    {
+        throw PsarcException(std::format("Failed to create file: {}", path.string()));
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    out.write(reinterpret_cast<const char*>(data.data()),
+              static_cast<std::streamsize>(data.size()));
+
+    if (!out.good())
+    {
+        throw PsarcException(std::format("Failed to write file: {}", path.string()));
+    }
 }
 
-const nlohmann::json* FindJsonKey(const nlohmann::json& obj,
-                                  std::initializer_list<std::string_view> keys)
+// Forces a file's data out to the storage device, so that nothing written afterwards can reach
+// the disk ahead of it. On POSIX, directories can be synced too, making renames and removals in
+// them durable; Windows has no equivalent and syncs files only.
+void SyncToDisk(const fs::path& path)
 {
-    if (!obj.is_object())
+#ifdef _WIN32
+    if (fs::is_directory(path))
+    {
+        return;
+    }
+    const int fd = ::_wopen(path.c_str(), _O_RDWR | _O_BINARY);
+    const bool synced = fd >= 0 && ::_commit(fd) == 0;
+    if (fd >= 0)
+    {
+        ::_close(fd);
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    const bool synced = fd >= 0 && ::fsync(fd) == 0;
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+#endif
+    if (!synced)
     {
-        return nullptr;
+        throw PsarcException(std::format("Failed to sync file: {}", path.string()));
     }
+}
 
-    for (const auto key : keys)
+// CRC-32 of count bytes at offset, or nullopt if the stream ends before them
+std::optional<uint32_t> ComputeCrc32(std::istream& stream, uint64_t offset, uint64_t count)
+{
+    stream.clear();
+    stream.seekg(static_cast<std::streamoff>(offset));
+    std::vector<uint8_t> buffer(static_cast<size_t>(std::min<uint64_t>(count, 1 << 20)));
+    uLong crc = crc32(0L, nullptr, 0);
+    while (count > 0)
     {
-        const std::string key_str(key);
-        if (obj.contains(key_str))
+        const auto size = static_cast<size_t>(std::min<uint64_t>(count, buffer.size()));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (!stream.read(reinterpret_cast<char*>(buffer.data()),
+                         static_cast<std::streamsize>(size)))
         {
-            return &obj.at(key_str);
+            return std::nullopt;
         }
+        crc = crc32(crc, buffer.data(), static_cast<uInt>(size));
+        count -= size;
     }
-    return nullptr;
+    return static_cast<uint32_t>(crc);
 }
 
-const nlohmann::json* ResolveManifestSource(const nlohmann::json& root)
+// Identifies the archive a TOC journal belongs to by state that the TOC rewrite leaves alone
+// or can be checked against: its size, the header and TOC it replaces, and the blocks appended
+// for it beyond both TOCs
+struct TocJournalTarget
+{
+    static constexpr size_t g_size = 28;
+
+    uint64_t archive_size = 0;
+    uint32_t old_toc_length = 0;
+    uint32_t old_toc_crc = 0;
+    uint64_t appended_offset = 0;
+    uint32_t appended_crc = 0;
+
+    void Write(uint8_t* data) const
+    {
+        WriteBE64(data, archive_size);
+        WriteBE32(data + 8, old_toc_length);
+        WriteBE32(data + 12, old_toc_crc);
+        WriteBE64(data + 16, appended_offset);
+        WriteBE32(data + 24, appended_crc);
+    }
+
+    [[nodiscard]] static TocJournalTarget Read(const uint8_t* data)
+    {
+        return {.archive_size = ReadBE64(data),
+                .old_toc_length = ReadBE32(data + 8),
+                .old_toc_crc = ReadBE32(data + 12),
+                .appended_offset = ReadBE64(data + 16),
+                .appended_crc = ReadBE32(data + 24)};
+    }
+};
+
+// Largest stored entry the output cache keeps in memory between hashing and extracting it
+constexpr uint64_t g_max_pinned_size = 64ULL * 1024 * 1024;
+
+// An archive with one range of it already read into memory, so extracting an entry right after
+// hashing its stored bytes does not read them a second time
+class PinnedRangeSource : public PsarcByteSource
 {
-    if (!root.is_object())
+public:
+    PinnedRangeSource(std::shared_ptr<const PsarcByteSource> source, uint64_t offset,
+                      std::vector<uint8_t> data)
+        : m_source(std::move(source)), m_offset(offset), m_data(std::move(data))
+    {
+    }
+
+    [[nodiscard]] uint64_t GetSize() const override
     {
-        return nullptr;
+        return m_source->GetSize();
+    }
+
+    [[nodiscard]] size_t ReadAt(uint64_t offset, std::span<uint8_t> buffer) const override
+    {
+        const uint64_t pinned_end = m_offset + m_data.size();
+        size_t done = 0;
+        while (done < buffer.size())
+        {
+            const uint64_t position = offset + done;
+            const auto rest = buffer.subspan(done);
+            if (position >= m_offset && position < pinned_end)
+            {
+                const auto count = static_cast<size_t>(
+                    std::min<uint64_t>(rest.size(), pinned_end - position));
+                std::copy_n(m_data.begin() + static_cast<std::ptrdiff_t>(position - m_offset),
+                            count, rest.begin());
+                done += count;
+                continue;
+            }
+
+            const auto limit = position < m_offset
+                                   ? static_cast<size_t>(
+                                         std::min<uint64_t>(rest.size(), m_offset - position))
+                                   : rest.size();
+            const size_t count = m_source->ReadAt(position, rest.first(limit));
+            done += count;
+            if (count < limit)
+            {
+                break;
+            }
+        }
+        return done;
     }
 
-    const auto* entries = FindJsonKey(root, {"Entries", "entries"});
-    if (!entries || !entries->is_object() || entries->empty())
+    void Prefetch(uint64_t offset, uint64_t length) const override
     {
-        return nullptr;
+        m_source->Prefetch(offset, length);
     }
 
-    const auto first = entries->begin();
-    if (!first.value().is_object())
+private:
+    std::shared_ptr<const PsarcByteSource> m_source;
+    uint64_t m_offset;
+    std::vector<uint8_t> m_data;
+};
+
+// Sidecar written by incremental ExtractAll: entry name -> {fingerprint, output_size}
+nlohmann::json LoadIncrementalState(const fs::path& path)
+{
+    std::ifstream in(path);
+    if (!in)
     {
-        return nullptr;
+        return nlohmann::json::object();
     }
 
-    const auto* attributes = FindJsonKey(first.value(), {"Attributes", "attributes"});
-    if (!attributes || !attributes->is_object())
+    // A damaged sidecar only costs a full re-extraction
+    auto state = nlohmann::json::parse(in, nullptr, false);
+    if (state.is_discarded() || !state.is_object() || state.value("version", 0) != 1 ||
+        !state.contains("entries") || !state["entries"].is_object())
     {
-        return nullptr;
+        return nlohmann::json::object();
     }
+    return std::move(state["entries"]);
+}
 
-    return attributes;
+void SaveIncrementalState(const fs::path& path, const nlohmann::json& entries)
+{
+    const nlohmann::json state = {{"version", 1}, {"entries", entries}};
+    const std::string text = state.dump(1);
+
+    const fs::path temp_path = path.string() + ".tmp";
+    WriteFile(temp_path, text);
+    fs::rename(temp_path, path);
 }
 
-template <typename T>
-std::optional<T> ReadJsonValue(const nlohmann::json& obj,
-                               std::initializer_list<std::string_view> keys)
+bool IsOutputUpToDate(const nlohmann::json& state, const std::string& name,
+                      const std::string& fingerprint, const fs::path& output_path)
 {
-    const auto* value = FindJsonKey(obj, keys);
-    if (!value || value->is_null())
+    const auto it = state.find(name);
+    if (it == state.end() || !it->is_object() ||
+        it->value("fingerprint", std::string()) != fingerprint)
     {
-        return std::nullopt;
+        return false;
     }
 
-    if constexpr (std::is_same_v<T, std::string>)
+    std::error_code ec;
+    const auto size = fs::file_size(output_path, ec);
+    return !ec && size == it->value("output_size", uint64_t{0});
+}
+
+// Whether PsarcOptions::entries (as a set) admits an entry; an empty selection admits all
+bool IsSelected(const std::unordered_set<std::string>& selected, const std::string& name)
+{
+    return selected.empty() || selected.contains(name);
+}
+
+// Times body(result) and records any failure other than cancellation in the result. The body
+// advances result.error_code as it moves from reading to converting to writing, so a failed
+// result carries the code of the stage that threw.
+template <typename Body>
+PsarcEntryResult RunEntry(const std::string& name, const fs::path& output, Body&& body)
+{
+    PSARC_TRACE_SCOPE_DETAIL("Entry", name);
+    PsarcEntryResult result;
+    result.name = name;
+    result.output = output.string();
+    result.error_code = PsarcErrorCode::ReadFailed;
+
+    const auto start = std::chrono::steady_clock::now();
+    try
     {
-        if (value->is_string())
-        {
-            return value->get<std::string>();
-        }
-        return std::nullopt;
+        body(result);
+        result.error_code = PsarcErrorCode::None;
     }
-    if constexpr (std::is_same_v<T, float>)
+    catch (const PsarcCancelledException&)
     {
-        if (value->is_number())
-        {
-            return static_cast<float>(value->get<double>());
-        }
-        return std::nullopt;
+        throw;
     }
-    if constexpr (std::is_same_v<T, int>)
+    catch (const fs::filesystem_error& e)
     {
-        if (value->is_number_integer() || value->is_number_unsigned())
-        {
-            return value->get<int>();
-        }
-        if (value->is_number_float())
-        {
-            return static_cast<int>(value->get<double>());
-        }
-        return std::nullopt;
+        result.status = PsarcEntryStatus::Failed;
+        result.error_code = PsarcErrorCode::WriteFailed;
+        result.message = e.what();
+    }
+    catch (const std::exception& e)
+    {
+        result.status = PsarcEntryStatus::Failed;
+        result.message = e.what();
     }
+    result.duration = std::chrono::steady_clock::now() - start;
+    return result;
+}
 
-    return std::nullopt;
+void SetOutcome(PsarcEntryResult& result, bool cached, uint64_t bytes_read,
+                const fs::path& output_path)
+{
+    result.status = cached ? PsarcEntryStatus::Cached : PsarcEntryStatus::Succeeded;
+    result.bytes_read = cached ? 0 : bytes_read;
+    result.bytes_written = fs::file_size(output_path);
 }
 
-SngManifestMetadata ParseManifestMetadata(const std::string& json_text)
+void FinishReport(PsarcReport& report, std::chrono::steady_clock::time_point start)
 {
-    SngManifestMetadata metadata;
+    std::ranges::sort(report.entries, {}, [](const PsarcEntryResult& result) {
+        return std::tie(result.name, result.output);
+    });
+    report.duration = std::chrono::steady_clock::now() - start;
+}
 
-    nlohmann::json root;
-    try
+// Legacy behaviour of the bulk operations: one exception listing every failed entry
+void ThrowIfFailed(const PsarcReport& report, std::string_view verb, std::string_view noun)
+{
+    if (report.Succeeded())
+    {
+        return;
+    }
+
+    std::string error_msg = std::format("Failed to {} {} {}(s):\n", verb,
+                                        report.Count(PsarcEntryStatus::Failed), noun);
+    for (const auto& result : report.entries)
     {
-        constexpr std::string_view utf8_bom("\xEF\xBB\xBF");
-        std::string_view payload(json_text);
-        if (payload.starts_with(utf8_bom))
-        {
-            payload.remove_prefix(utf8_bom.size());
-        }
-        root = nlohmann::json::parse(payload);
-    }
-    catch (const std::exception&)
-    {
-        return metadata;
-    }
-
-    const nlohmann::json* source = ResolveManifestSource(root);
-    if (!source)
-    {
-        return metadata;
-    }
-
-    metadata.title = ReadJsonValue<std::string>(*source, {"SongName", "songName"});
-    metadata.arrangement =
-        ReadJsonValue<std::string>(*source, {"ArrangementName", "arrangementName"});
-    metadata.cent_offset = ReadJsonValue<float>(*source, {"CentOffset", "centOffset"});
-    metadata.song_name_sort = ReadJsonValue<std::string>(*source, {"SongNameSort", "songNameSort"});
-    metadata.average_tempo =
-        ReadJsonValue<float>(*source, {"SongAverageTempo", "songAverageTempo"});
-    metadata.artist_name = ReadJsonValue<std::string>(*source, {"ArtistName", "artistName"});
-    metadata.artist_name_sort =
-        ReadJsonValue<std::string>(*source, {"ArtistNameSort", "artistNameSort"});
-    metadata.album_name = ReadJsonValue<std::string>(*source, {"AlbumName", "albumName"});
-    metadata.album_name_sort =
-        ReadJsonValue<std::string>(*source, {"AlbumNameSort", "albumNameSort"});
-    metadata.album_year = ReadJsonValue<int>(*source, {"SongYear", "songYear"});
-    metadata.tone_base = ReadJsonValue<std::string>(*source, {"Tone_Base", "toneBase"});
-    metadata.tone_names[0] = ReadJsonValue<std::string>(*source, {"Tone_A", "toneA"});
-    metadata.tone_names[1] = ReadJsonValue<std::string>(*source, {"Tone_B", "toneB"});
-    metadata.tone_names[2] = ReadJsonValue<std::string>(*source, {"Tone_C", "toneC"});
-    metadata.tone_names[3] = ReadJsonValue<std::string>(*source, {"Tone_D", "toneD"});
-
-    const auto* props = FindJsonKey(*source, {"ArrangementProperties", "arrangementProperties"});
-    if (props && props->is_object())
-    {
-        SngManifestArrangementProperties parsed;
-        parsed.represent = ReadJsonValue<int>(*props, {"represent"}).value_or(0);
-        parsed.bonus_arr = ReadJsonValue<int>(*props, {"bonusArr"}).value_or(0);
-        parsed.standard_tuning = ReadJsonValue<int>(*props, {"standardTuning"}).value_or(0);
-        parsed.non_standard_chords = ReadJsonValue<int>(*props, {"nonStandardChords"}).value_or(0);
-        parsed.barre_chords = ReadJsonValue<int>(*props, {"barreChords"}).value_or(0);
-        parsed.power_chords = ReadJsonValue<int>(*props, {"powerChords"}).value_or(0);
-        parsed.drop_d_power = ReadJsonValue<int>(*props, {"dropDPower"}).value_or(0);
-        parsed.open_chords = ReadJsonValue<int>(*props, {"openChords"}).value_or(0);
-        parsed.finger_picking = ReadJsonValue<int>(*props, {"fingerPicking"}).value_or(0);
-        parsed.pick_direction = ReadJsonValue<int>(*props, {"pickDirection"}).value_or(0);
-        parsed.double_stops = ReadJsonValue<int>(*props, {"doubleStops"}).value_or(0);
-        parsed.palm_mutes = ReadJsonValue<int>(*props, {"palmMutes"}).value_or(0);
-        parsed.harmonics = ReadJsonValue<int>(*props, {"harmonics"}).value_or(0);
-        parsed.pinch_harmonics = ReadJsonValue<int>(*props, {"pinchHarmonics"}).value_or(0);
-        parsed.hopo = ReadJsonValue<int>(*props, {"hopo"}).value_or(0);
-        parsed.tremolo = ReadJsonValue<int>(*props, {"tremolo"}).value_or(0);
-        parsed.slides = ReadJsonValue<int>(*props, {"slides"}).value_or(0);
-        parsed.unpitched_slides = ReadJsonValue<int>(*props, {"unpitchedSlides"}).value_or(0);
-        parsed.bends = ReadJsonValue<int>(*props, {"bends"}).value_or(0);
-        parsed.tapping = ReadJsonValue<int>(*props, {"tapping"}).value_or(0);
-        parsed.vibrato = ReadJsonValue<int>(*props, {"vibrato"}).value_or(0);
-        parsed.fret_hand_mutes = ReadJsonValue<int>(*props, {"fretHandMutes"}).value_or(0);
-        parsed.slap_pop = ReadJsonValue<int>(*props, {"slapPop"}).value_or(0);
-        parsed.two_finger_picking = ReadJsonValue<int>(*props, {"twoFingerPicking"}).value_or(0);
-        parsed.fifths_and_octaves = ReadJsonValue<int>(*props, {"fifthsAndOctaves"}).value_or(0);
-        parsed.syncopation = ReadJsonValue<int>(*props, {"syncopation"}).value_or(0);
-        parsed.bass_pick = ReadJsonValue<int>(*props, {"bassPick"}).value_or(0);
-        parsed.sustain = ReadJsonValue<int>(*props, {"sustain"}).value_or(0);
-        parsed.path_lead = ReadJsonValue<int>(*props, {"pathLead"}).value_or(0);
-        parsed.path_rhythm = ReadJsonValue<int>(*props, {"pathRhythm"}).value_or(0);
-        parsed.path_bass = ReadJsonValue<int>(*props, {"pathBass"}).value_or(0);
-        metadata.arrangement_properties = parsed;
-    }
-
-    return metadata;
+        if (result.status == PsarcEntryStatus::Failed)
+        {
+            error_msg += std::format("  {}: {}\n", result.name, result.message);
+        }
+    }
+    throw PsarcException(error_msg);
 }
 
-bool IsLikelyManifestFile(std::string_view path)
+// ─── PsarcArchiveInfo ─────────────────────────────────────────────────────────
+
+double PsarcArchiveInfo::GetCompressionRatio() const
 {
-    return path.ends_with(".json") && path.find("songs_dlc_") != std::string_view::npos;
+    if (uncompressed_size == 0)
+    {
+        return 1.0;
+    }
+    return static_cast<double>(compressed_size) / static_cast<double>(uncompressed_size);
 }
 
-std::string ToLower(std::string value)
+// ─── PsarcReport ──────────────────────────────────────────────────────────────
+
+bool PsarcReport::Succeeded() const
 {
-    std::ranges::transform(value, value.begin(),
-                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-    return value;
+    return Count(PsarcEntryStatus::Failed) == 0;
+}
+
+size_t PsarcReport::Count(PsarcEntryStatus status) const
+{
+    return static_cast<size_t>(std::ranges::count(entries, status, &PsarcEntryResult::status));
+}
+
+std::vector<std::string> PsarcReport::GetFailedEntries() const
+{
+    std::vector<std::string> names;
+    for (const auto& result : entries)
+    {
+        if (result.status == PsarcEntryStatus::Failed &&
+            (names.empty() || names.back() != result.name))
+        {
+            names.push_back(result.name);
+        }
+    }
+    return names;
 }
 
 // ─── PsarcFile::Impl ──────────────────────────────────────────────────────────
@@ -256,19 +416,34 @@ struct PsarcFile::Impl
     {
     }
 
+    Impl(std::shared_ptr<PsarcByteSource> source, std::string name)
+        : m_file_path(std::move(name)), m_source(std::move(source)), m_external_source(true)
+    {
+        if (!m_source)
+        {
+            throw PsarcException("PsarcFile needs a byte source");
+        }
+    }
+
     void Open()
     {
+        PSARC_TRACE_SCOPE_DETAIL("PsarcFile::Open", m_file_path);
+
         if (m_is_open)
         {
             return;
         }
+        const StatsCollector::PhaseTimer timer(m_stats, StatsCollector::Phase::Open);
 
-        m_file = std::make_unique<std::ifstream>(m_file_path, std::ios::binary);
-        if (!m_file->is_open())
+        if (!m_external_source)
         {
-            throw PsarcException(std::format("Failed to open file: {}", m_file_path));
+            ReplayTocJournal();
+            m_source = PsarcByteSource::OpenFile(m_file_path);
         }
+        m_file = std::make_unique<ByteSourceStream>(m_source);
+        m_archive_size = m_source->GetSize();
 
+        m_archive_id = NextArchiveId();
         ReadHeader();
         ReadToc();
         ReadManifest();
@@ -277,12 +452,14 @@ struct PsarcFile::Impl
 
     void Close()
     {
-        if (m_file)
+        m_file.reset();
+        m_idle_streams.clear();
+        if (!m_external_source)
         {
-            m_file->close();
-            m_file.reset();
+            m_source.reset();
         }
         m_entries.clear();
+        m_entry_views.clear();
         m_file_map.clear();
         m_z_lengths.clear();
         m_is_open = false;
@@ -293,6 +470,11 @@ struct PsarcFile::Impl
         return m_is_open;
     }
 
+    void SetBlockCache(std::shared_ptr<PsarcBlockCache> cache)
+    {
+        m_block_cache = std::move(cache);
+    }
+
     [[nodiscard]] int GetFileCount() const
     {
         return static_cast<int>(m_entries.size());
@@ -301,19 +483,34 @@ struct PsarcFile::Impl
     [[nodiscard]] std::vector<std::string> GetFileList() const
     {
         std::vector<std::string> files;
-        files.reserve(m_entries.size());
+        files.reserve(m_entry_views.size());
 
-        for (const auto& entry : m_entries)
+        for (const auto& view : m_entry_views)
         {
-            if (!entry.name.empty())
-            {
-                files.push_back(entry.name);
-            }
+            files.emplace_back(view.name);
         }
 
         return files;
     }
 
+    [[nodiscard]] std::span<const PsarcEntryView> GetEntries() const
+    {
+        return m_entry_views;
+    }
+
+    [[nodiscard]] PsarcEntryView GetEntry(int index) const
+    {
+        CheckIndex(index);
+        const auto& entry = m_entries[index];
+        return {.name = entry.name, .size = entry.uncompressed_size, .index = index};
+    }
+
+    [[nodiscard]] PsarcEntryInfo GetEntryInfo(int index) const
+    {
+        CheckIndex(index);
+        return MakeEntryInfo(index);
+    }
+
     [[nodiscard]] bool FileExists(const std::string& file_name) const
     {
         return m_file_map.contains(file_name);
@@ -329,42 +526,150 @@ struct PsarcFile::Impl
         return m_entries[it->second].uncompressed_size;
     }
 
-    [[nodiscard]] std::vector<uint8_t> ExtractFile(const std::string& file_name)
+    [[nodiscard]] PsarcEntryInfo GetEntryInfo(const std::string& file_name) const
     {
         const auto it = m_file_map.find(file_name);
         if (it == m_file_map.end())
         {
             throw PsarcException(std::format("File not found: {}", file_name));
         }
-        return ExtractFileByIndex(it->second);
+        return MakeEntryInfo(it->second);
     }
 
-    void ExtractFileTo(const std::string& file_name, const std::string& output_path)
+    [[nodiscard]] std::vector<PsarcEntryInfo> GetEntryInfoList() const
     {
-        const auto data = ExtractFile(file_name);
+        std::vector<PsarcEntryInfo> infos;
+        infos.reserve(m_entry_views.size());
+        for (const auto& view : m_entry_views)
+        {
+            infos.push_back(MakeEntryInfo(view.index));
+        }
+        return infos;
+    }
 
-        std::ofstream out(output_path, std::ios::binary);
-        if (!out)
+    [[nodiscard]] uint64_t GetMemoryUsage() const
+    {
+        // Names are counted twice: once in the TOC entries and once as map keys
+        constexpr size_t map_node_size =
+            sizeof(std::pair<const std::string, int>) + 2 * sizeof(void*);
+        uint64_t usage = sizeof(Impl) + m_entries.capacity() * sizeof(FileEntry) +
+                         m_entry_views.capacity() * sizeof(PsarcEntryView) +
+                         m_z_lengths.capacity() * sizeof(uint16_t) +
+                         m_file_map.bucket_count() * sizeof(void*) +
+                         m_file_map.size() * map_node_size;
+        for (const auto& entry : m_entries)
         {
-            throw PsarcException(std::format("Failed to create file: {}", output_path));
+            usage += 2 * entry.name.size();
         }
+        return usage;
+    }
 
-        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-        out.write(reinterpret_cast<const char*>(data.data()),
-                  static_cast<std::streamsize>(data.size()));
+    [[nodiscard]] PsarcArchiveInfo GetArchiveInfo(size_t largest_entry_count) const
+    {
+        if (!m_is_open)
+        {
+            throw PsarcException("Archive is not open");
+        }
 
-        if (!out.good())
+        PsarcArchiveInfo info;
+        info.archive_size = m_archive_size;
+        info.block_size = m_header.block_size;
+        info.compression_method.assign(m_header.compression_method.begin(),
+                                       m_header.compression_method.end());
+        info.toc_encrypted = (m_header.archive_flags & g_toc_encrypted_flag) != 0;
+
+        std::unordered_map<std::string, PsarcExtensionInfo> extensions;
+        std::vector<PsarcEntryInfo> entries = GetEntryInfoList();
+        for (const auto& entry_info : entries)
+        {
+            ++info.entry_count;
+            info.uncompressed_size += entry_info.uncompressed_size;
+            info.compressed_size += entry_info.compressed_size;
+            info.block_count += entry_info.block_count;
+            info.stored_blocks += entry_info.stored_blocks;
+
+            auto extension = ToLower(fs::path(entry_info.name).extension().string());
+            auto& totals = extensions[extension];
+            totals.extension = std::move(extension);
+            ++totals.entry_count;
+            totals.uncompressed_size += entry_info.uncompressed_size;
+            totals.compressed_size += entry_info.compressed_size;
+        }
+
+        for (auto& [extension, totals] : extensions)
+        {
+            info.extensions.push_back(std::move(totals));
+        }
+        std::ranges::sort(info.extensions, [](const auto& a, const auto& b) {
+            return std::tie(b.compressed_size, a.extension) <
+                   std::tie(a.compressed_size, b.extension);
+        });
+
+        const auto largest = std::min(largest_entry_count, entries.size());
+        const auto by_size = [](const PsarcEntryInfo& a, const PsarcEntryInfo& b) {
+            return std::tie(b.uncompressed_size, a.name) < std::tie(a.uncompressed_size, b.name);
+        };
+        std::ranges::partial_sort(entries, entries.begin() + static_cast<std::ptrdiff_t>(largest),
+                                  by_size);
+        entries.resize(largest);
+        info.largest_entries = std::move(entries);
+        return info;
+    }
+
+    [[nodiscard]] std::vector<uint8_t> ExtractFile(const std::string& file_name) const
+    {
+        std::vector<uint8_t> result;
+        ExtractFile(file_name, result);
+        return result;
+    }
+
+    void ExtractFile(const std::string& file_name, std::vector<uint8_t>& output) const
+    {
+        const auto it = m_file_map.find(file_name);
+        if (it == m_file_map.end())
+        {
+            throw PsarcException(std::format("File not found: {}", file_name));
+        }
+        const StreamLease stream(*this);
+        ExtractFileByIndex(it->second, stream.Get(), output, nullptr, m_block_cache.get());
+    }
+
+    void Prefetch(const std::vector<std::string>& names) const
+    {
+        std::vector<int> indices;
+        indices.reserve(names.size());
+        for (const auto& name : names)
         {
-            throw PsarcException(std::format("Failed to write file: {}", output_path));
+            if (const auto it = m_file_map.find(name); it != m_file_map.end())
+            {
+                indices.push_back(it->second);
+            }
         }
+        PrefetchEntries(indices);
+    }
+
+    void ExtractFileTo(const std::string& file_name, const std::string& output_path) const
+    {
+        WriteOutput(output_path, ExtractFile(file_name));
     }
 
-    void ExtractAll(const std::string& output_directory)
+    PsarcReport ExtractAll(const std::string& output_directory, const PsarcOptions& options)
     {
+        PSARC_TRACE_SCOPE("PsarcFile::ExtractAll");
+        const StatsCollector::PhaseTimer timer(m_stats, StatsCollector::Phase::Extract);
+        const auto start = std::chrono::steady_clock::now();
         fs::create_directories(output_directory);
 
-        std::vector<std::string> failed_files;
+        const fs::path state_path = GetIncrementalStatePath(output_directory);
+        const nlohmann::json previous_state =
+            options.incremental ? LoadIncrementalState(state_path) : nlohmann::json::object();
+        nlohmann::json state = nlohmann::json::object();
+        const std::unordered_set<std::string> selected(options.entries.begin(),
+                                                       options.entries.end());
 
+        PsarcReport report;
+        std::vector<int> pending;
+        std::vector<std::string> fingerprints(m_entries.size());
         for (size_t i = 0; i < m_entries.size(); ++i)
         {
             const auto& entry = m_entries[i];
@@ -373,52 +678,115 @@ struct PsarcFile::Impl
                 continue;
             }
 
-            const fs::path output_path = fs::path(output_directory) / entry.name;
-
-            try
+            // Entries outside the selection keep their sidecar records for later runs
+            if (!IsSelected(selected, entry.name))
             {
-                fs::create_directories(output_path.parent_path());
-
-                const auto data = ExtractFileByIndex(static_cast<int>(i));
-
-                std::ofstream out(output_path, std::ios::binary);
-                if (!out)
-                {
-                    failed_files.push_back(std::format("{}: failed to create file", entry.name));
-                    continue;
-                }
-
-                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-                out.write(reinterpret_cast<const char*>(data.data()),
-                          static_cast<std::streamsize>(data.size()));
-
-                if (!out.good())
+                if (previous_state.contains(entry.name))
                 {
-                    failed_files.push_back(std::format("{}: failed to write data", entry.name));
+                    state[entry.name] = previous_state.at(entry.name);
                 }
+                continue;
             }
-            catch (const std::exception& e)
+
+            fingerprints[i] = GetEntryFingerprint(entry);
+            const fs::path output_path = fs::path(output_directory) / entry.name;
+            if (options.incremental &&
+                IsOutputUpToDate(previous_state, entry.name, fingerprints[i], output_path))
             {
-                failed_files.push_back(std::format("{}: {}", entry.name, e.what()));
+                state[entry.name] = previous_state.at(entry.name);
+
+                PsarcEntryResult result;
+                result.name = entry.name;
+                result.output = output_path.string();
+                result.status = PsarcEntryStatus::Skipped;
+                report.entries.push_back(std::move(result));
+                continue;
             }
+            pending.push_back(static_cast<int>(i));
         }
 
-        if (!failed_files.empty())
+        uint64_t bytes_total = 0;
+        for (const int index : pending)
         {
-            std::string error_msg =
-                std::format("Failed to extract {} file(s):\n", failed_files.size());
-            for (const auto& msg : failed_files)
+            bytes_total += m_entries[index].uncompressed_size;
+        }
+        OperationMonitor monitor(options, pending.size(), bytes_total);
+
+        std::mutex mutex; // Guards state
+        std::vector<PsarcEntryResult> results(pending.size());
+
+        // Entries finished before a cancellation are still recorded, so a rerun resumes from them
+        const auto save_state = [&] {
+            if (options.incremental)
             {
-                error_msg += "  " + msg + "\n";
+                SaveIncrementalState(state_path, state);
             }
-            throw PsarcException(error_msg);
+        };
+
+        try
+        {
+            RunTasks(
+                pending.size(), options, monitor,
+                [&](size_t task) {
+                    return GetExtractionCost(m_entries[pending[task]]) +
+                           GetCacheCost(pending[task], options);
+                },
+                [&](size_t task, std::istream& stream) {
+                    const int index = pending[task];
+                    const auto& entry = m_entries[index];
+                    const fs::path output_path = fs::path(output_directory) / entry.name;
+                    OperationMonitor::Task progress(monitor, entry.uncompressed_size);
+
+                    results[task] = RunEntry(entry.name, output_path, [&](auto& result) {
+                        try
+                        {
+                            fs::create_directories(output_path.parent_path());
+
+                            const std::string_view kind = IsSngFile(entry.name) ? "sng" : "file";
+                            const bool cached = WriteCachedOutput(
+                                output_path, options, index, kind, stream,
+                                [&](const fs::path& path, std::istream& input) {
+                                    ExtractFileByIndexTo(index, input, path, &progress);
+                                });
+                            SetOutcome(result, cached, entry.uncompressed_size, output_path);
+                        }
+                        catch (const PsarcCancelledException&)
+                        {
+                            // A partially written output would look current to the next run
+                            std::error_code ec;
+                            fs::remove(output_path, ec);
+                            throw;
+                        }
+
+                        const std::scoped_lock lock(mutex);
+                        state[entry.name] = {{"fingerprint", fingerprints[index]},
+                                             {"output_size", result.bytes_written}};
+                    });
+                });
+        }
+        catch (const PsarcCancelledException&)
+        {
+            save_state();
+            throw;
         }
+
+        save_state();
+
+        std::ranges::move(results, std::back_inserter(report.entries));
+        FinishReport(report, start);
+        return report;
     }
 
-    void ConvertAudio(const std::string& output_directory)
+    PsarcReport ConvertAudio(const std::string& output_directory, const PsarcOptions& options)
     {
+        PSARC_TRACE_SCOPE("PsarcFile::ConvertAudio");
+        const StatsCollector::PhaseTimer timer(m_stats, StatsCollector::Phase::Audio);
+        const auto start = std::chrono::steady_clock::now();
         fs::create_directories(output_directory);
 
+        const std::unordered_set<std::string> selected(options.entries.begin(),
+                                                       options.entries.end());
+
         // Track which WEM IDs are referenced by BNK files so we don't convert them twice
         std::unordered_map<std::string, bool> referenced_wems;
 
@@ -443,181 +811,260 @@ struct PsarcFile::Impl
             }
         }
 
-        std::vector<std::string> failed_files;
+        PsarcReport report;
+        std::vector<AudioJob> jobs;
 
-        // Process BNK files
+        std::vector<int> bnk_indices;
+        bnk_indices.reserve(bnk_files.size());
         for (const auto& bnk_name : bnk_files)
         {
-            try
-            {
-                const auto bnk_data = ExtractFile(bnk_name);
-                const std::string_view bnk_view(
-                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-                    reinterpret_cast<const char*>(bnk_data.data()), bnk_data.size());
-                const auto entries = wwtools::BnkExtract(bnk_view);
+            bnk_indices.push_back(m_file_map.at(bnk_name));
+        }
 
-                // Use the BNK stem as the song name
-                const fs::path bnk_path(bnk_name);
-                const std::string song_name = bnk_path.stem().string();
+        // Resolve BNK entries to conversion jobs, which then run in parallel below. Every BNK is
+        // resolved, even outside the selection, so that the WEMs it streams are not mistaken for
+        // standalone ones. Embedded WEMs are not kept: their jobs extract them from the BNK again,
+        // so audio is only held in memory by the tasks converting it.
+        struct BnkScan
+        {
+            PsarcEntryResult result;
+            std::vector<AudioJob> jobs;
+            std::vector<PsarcEntryResult> missing;
+        };
+        std::vector<BnkScan> scans(bnk_files.size());
+
+        PsarcOptions scan_options = options;
+        scan_options.progress = nullptr; // Progress covers the conversions
+        OperationMonitor scan_monitor(scan_options, bnk_files.size(), 0);
+
+        // The BNK and the entries extracted from it are held at once
+        RunTasks(
+            bnk_files.size(), scan_options, scan_monitor,
+            [&](size_t task) {
+                return 2 * m_entries[bnk_indices[task]].uncompressed_size +
+                       2 * uint64_t{m_header.block_size};
+            },
+            [&](size_t task, std::istream& stream) {
+                const auto& bnk_name = bnk_files[task];
+                auto& scan = scans[task];
+                scan.result = RunEntry(bnk_name, {}, [&](auto& result) {
+                    const auto bnk_data = ExtractFileByIndex(bnk_indices[task], stream);
+                    result.bytes_read = bnk_data.size();
+                    result.error_code = PsarcErrorCode::ConversionFailed;
+
+                    const std::string_view bnk_view(
+                        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                        reinterpret_cast<const char*>(bnk_data.data()), bnk_data.size());
+                    const auto entries = wwtools::BnkExtract(bnk_view);
+
+                    // Use the BNK stem as the song name
+                    const fs::path bnk_path(bnk_name);
+                    const std::string song_name = bnk_path.stem().string();
+
+                    for (size_t i = 0; i < entries.size(); ++i)
+                    {
+                        const auto& bnk_entry = entries[i];
 
-                for (size_t i = 0; i < entries.size(); ++i)
-                {
-                    const auto& bnk_entry = entries[i];
+                        // Name the OGG after the song (BNK stem), with a suffix if multiple
+                        // entries
+                        std::string ogg_name = song_name;
+                        if (entries.size() > 1)
+                        {
+                            ogg_name += std::format("_{}", i);
+                        }
+                        ogg_name += ".ogg";
 
-                    try
-                    {
-                        std::string wem_data;
+                        AudioJob job;
+                        job.ogg_path =
+                            fs::path(output_directory) / bnk_path.parent_path() / ogg_name;
 
                         if (bnk_entry.streamed)
                         {
                             // Find the corresponding WEM file in the archive by ID
                             const std::string wem_id = std::to_string(bnk_entry.id);
-                            std::string found_wem;
-
-                            for (const auto& wem_name : wem_files)
-                            {
-                                if (fs::path(wem_name).stem().string() == wem_id)
-                                {
-                                    found_wem = wem_name;
-                                    break;
-                                }
-                            }
+                            const auto found_wem =
+                                std::ranges::find_if(wem_files, [&](const std::string& wem_name) {
+                                    return fs::path(wem_name).stem().string() == wem_id;
+                                });
 
-                            if (found_wem.empty())
+                            if (found_wem == wem_files.end())
                             {
-                                failed_files.push_back(
-                                    std::format("{}: streamed WEM {} not found in archive",
-                                                bnk_name, bnk_entry.id));
+                                PsarcEntryResult missing;
+                                missing.name = bnk_name;
+                                missing.output = job.ogg_path.string();
+                                missing.status = PsarcEntryStatus::Failed;
+                                missing.error_code = PsarcErrorCode::MissingEntry;
+                                missing.message = std::format(
+                                    "streamed WEM {} not found in archive", bnk_entry.id);
+                                scan.missing.push_back(std::move(missing));
                                 continue;
                             }
 
-                            referenced_wems[found_wem] = true;
-                            const auto raw = ExtractFile(found_wem);
-                            wem_data.assign(
-                                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-                                reinterpret_cast<const char*>(raw.data()), raw.size());
+                            job.name = *found_wem;
+                            job.wem_index = m_file_map.at(*found_wem);
+                            job.cache_index = job.wem_index;
+                            job.cache_kind = "ogg";
                         }
                         else
                         {
-                            wem_data = bnk_entry.data;
-                        }
-
-                        if (wem_data.empty())
-                        {
-                            continue;
-                        }
-
-                        const auto ogg_data = wwtools::Wem2Ogg(wem_data);
-
-                        // Name the OGG after the song (BNK stem), with a suffix if multiple entries
-                        std::string ogg_name = song_name;
-                        if (entries.size() > 1)
-                        {
-                            ogg_name += std::format("_{}", i);
-                        }
-                        ogg_name += ".ogg";
-
-                        const fs::path ogg_path =
-                            fs::path(output_directory) / bnk_path.parent_path() / ogg_name;
-                        fs::create_directories(ogg_path.parent_path());
-
-                        std::ofstream out(ogg_path, std::ios::binary);
-                        if (!out)
-                        {
-                            failed_files.push_back(
-                                std::format("{}: failed to create file", ogg_name));
-                            continue;
-                        }
+                            if (bnk_entry.data.empty())
+                            {
+                                continue;
+                            }
 
-                        out.write(ogg_data.data(), static_cast<std::streamsize>(ogg_data.size()));
-                        if (!out.good())
-                        {
-                            failed_files.push_back(
-                                std::format("{}: failed to write data", ogg_name));
+                            job.name = bnk_name;
+                            job.bnk_index = bnk_indices[task];
+                            job.bnk_entry = i;
+                            job.embedded_size = bnk_entry.data.size();
+                            job.cache_index = job.bnk_index;
+                            job.cache_kind = std::format("ogg:{}", i);
                         }
+                        scan.jobs.push_back(std::move(job));
                     }
-                    catch (const std::exception& e)
-                    {
-                        failed_files.push_back(
-                            std::format("{} (WEM {}): {}", bnk_name, bnk_entry.id, e.what()));
-                    }
-                }
+                });
+            },
+            [&](size_t task) { PrefetchEntries(std::span(&bnk_indices[task], 1)); });
+
+        for (size_t task = 0; task < bnk_files.size(); ++task)
+        {
+            auto& scan = scans[task];
+            const bool selected_bnk = IsSelected(selected, bnk_files[task]);
+            if (scan.result.status == PsarcEntryStatus::Failed && selected_bnk)
+            {
+                report.entries.push_back(std::move(scan.result));
+            }
+            if (selected_bnk)
+            {
+                std::ranges::move(scan.missing, std::back_inserter(report.entries));
             }
-            catch (const std::exception& e)
+            for (auto& job : scan.jobs)
             {
-                failed_files.push_back(std::format("{}: {}", bnk_name, e.what()));
+                if (job.wem_index >= 0)
+                {
+                    referenced_wems[job.name] = true;
+                }
+                if (IsSelected(selected, job.name))
+                {
+                    jobs.push_back(std::move(job));
+                }
             }
         }
 
         // Convert standalone WEM files not referenced by any BNK
         for (const auto& wem_name : wem_files)
         {
-            if (referenced_wems.contains(wem_name))
+            if (referenced_wems.contains(wem_name) || !IsSelected(selected, wem_name))
             {
                 continue;
             }
 
-            try
-            {
-                const auto raw = ExtractFile(wem_name);
-                const std::string_view wem_view(
-                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-                    reinterpret_cast<const char*>(raw.data()), raw.size());
-                const auto ogg_data = wwtools::Wem2Ogg(wem_view);
+            const fs::path wem_path(wem_name);
+            const std::string ogg_name = wem_path.stem().string() + ".ogg";
 
-                const fs::path wem_path(wem_name);
-                const std::string ogg_name = wem_path.stem().string() + ".ogg";
-                const fs::path ogg_path =
-                    fs::path(output_directory) / wem_path.parent_path() / ogg_name;
-                fs::create_directories(ogg_path.parent_path());
-
-                std::ofstream out(ogg_path, std::ios::binary);
-                if (!out)
-                {
-                    failed_files.push_back(std::format("{}: failed to create file", ogg_name));
-                    continue;
-                }
-
-                out.write(ogg_data.data(), static_cast<std::streamsize>(ogg_data.size()));
-                if (!out.good())
-                {
-                    failed_files.push_back(std::format("{}: failed to write data", ogg_name));
-                }
-            }
-            catch (const std::exception& e)
-            {
-                failed_files.push_back(std::format("{}: {}", wem_name, e.what()));
-            }
+            AudioJob job;
+            job.name = wem_name;
+            job.ogg_path = fs::path(output_directory) / wem_path.parent_path() / ogg_name;
+            job.wem_index = m_file_map.at(wem_name);
+            job.cache_index = job.wem_index;
+            job.cache_kind = "ogg";
+            jobs.push_back(std::move(job));
         }
 
-        if (!failed_files.empty())
+        const auto wem_size = [&](const AudioJob& job) -> uint64_t {
+            return job.wem_index >= 0 ? m_entries[job.wem_index].uncompressed_size
+                                      : job.embedded_size;
+        };
+        const auto bnk_size = [&](const AudioJob& job) -> uint64_t {
+            return job.bnk_index >= 0 ? m_entries[job.bnk_index].uncompressed_size : 0;
+        };
+
+        uint64_t bytes_total = 0;
+        for (const auto& job : jobs)
         {
-            std::string error_msg =
-                std::format("Failed to convert {} audio file(s):\n", failed_files.size());
-            for (const auto& msg : failed_files)
-            {
-                error_msg += "  " + msg + "\n";
-            }
-            throw PsarcException(error_msg);
+            bytes_total += wem_size(job);
         }
+        OperationMonitor monitor(options, jobs.size(), bytes_total);
+
+        std::vector<PsarcEntryResult> results(jobs.size());
+
+        // The WEM, its decoded form and the OGG output are all held at once, along with the BNK
+        // and its extracted entries for embedded WEMs
+        RunTasks(
+            jobs.size(), options, monitor,
+            [&](size_t task) {
+                return 3 * wem_size(jobs[task]) + 2 * bnk_size(jobs[task]) +
+                       2 * uint64_t{m_header.block_size} +
+                       GetCacheCost(jobs[task].cache_index, options);
+            },
+            [&](size_t task, std::istream& stream) {
+                const auto& job = jobs[task];
+                OperationMonitor::Task progress(monitor, wem_size(job));
+
+                results[task] = RunEntry(job.name, job.ogg_path, [&](auto& result) {
+                    fs::create_directories(job.ogg_path.parent_path());
+                    const bool cached = WriteCachedOutput(
+                        job.ogg_path, options, job.cache_index, job.cache_kind, stream,
+                        [&](const fs::path& path, std::istream& input) {
+                            std::vector<uint8_t> raw;
+                            const int raw_index = job.wem_index >= 0 ? job.wem_index
+                                                                     : job.bnk_index;
+                            ExtractFileByIndex(raw_index, input, raw,
+                                               job.wem_index >= 0 ? &progress : nullptr);
+                            std::string_view wem_view(
+                                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                                reinterpret_cast<const char*>(raw.data()), raw.size());
+
+                            decltype(wwtools::BnkExtract(wem_view)) bnk_entries;
+                            if (job.bnk_index >= 0)
+                            {
+                                result.error_code = PsarcErrorCode::ConversionFailed;
+                                bnk_entries = wwtools::BnkExtract(wem_view);
+                                wem_view = bnk_entries.at(job.bnk_entry).data;
+                            }
+
+                            result.error_code = PsarcErrorCode::ConversionFailed;
+                            std::string ogg;
+                            {
+                                PSARC_TRACE_SCOPE("Wem2Ogg");
+                                ogg = wwtools::Wem2Ogg(wem_view);
+                            }
+
+                            result.error_code = PsarcErrorCode::WriteFailed;
+                            WriteOutput(path, ogg);
+                        });
+                    SetOutcome(result, cached, wem_size(job), job.ogg_path);
+                });
+            },
+            [&](size_t task) {
+                const auto& job = jobs[task];
+                PrefetchEntries(std::span(job.wem_index >= 0 ? &job.wem_index : &job.bnk_index, 1));
+            });
+
+        std::ranges::move(results, std::back_inserter(report.entries));
+        FinishReport(report, start);
+        return report;
     }
 
-    void ConvertSng(const std::string& output_directory)
+    PsarcReport ConvertSng(const std::string& output_directory, const PsarcOptions& options)
     {
+        PSARC_TRACE_SCOPE("PsarcFile::ConvertSng");
+        const StatsCollector::PhaseTimer timer(m_stats, StatsCollector::Phase::Sng);
+        const auto start = std::chrono::steady_clock::now();
         fs::create_directories(output_directory);
 
+        const std::unordered_set<std::string> selected(options.entries.begin(),
+                                                       options.entries.end());
+
         // Collect SNG files from songs/bin/generic/
         std::vector<std::string> sng_files;
         for (const auto& entry : m_entries)
         {
-            if (entry.name.find("songs/bin/generic/") != std::string::npos &&
-                entry.name.ends_with(".sng"))
+            if (IsSngFile(entry.name) && IsSelected(selected, entry.name))
             {
                 sng_files.push_back(entry.name);
             }
         }
 
-        std::vector<std::string> failed_files;
         std::vector<int> manifest_indices;
         manifest_indices.reserve(m_entries.size());
         for (size_t i = 0; i < m_entries.size(); ++i)
@@ -628,84 +1075,369 @@ struct PsarcFile::Impl
             }
         }
 
-        for (const auto& sng_name : sng_files)
+        std::vector<int> matched_manifests(sng_files.size(), -1);
+        for (size_t s = 0; s < sng_files.size(); ++s)
         {
-            try
-            {
-                const auto data = ExtractFile(sng_name);
-
-                const auto sng_data = SngParser::Parse(data);
+            const std::string sng_stem = ToLower(fs::path(sng_files[s]).stem().string());
 
-                const std::string sng_stem = ToLower(fs::path(sng_name).stem().string());
-                std::optional<SngManifestMetadata> manifest;
+            int matched_manifest = -1;
+            for (const int idx : manifest_indices)
+            {
+                const std::string json_stem =
+                    ToLower(fs::path(m_entries[idx].name).stem().string());
+                if (json_stem == sng_stem)
+                {
+                    matched_manifest = idx;
+                    break;
+                }
+            }
 
-                int matched_manifest = -1;
+            if (matched_manifest < 0)
+            {
                 for (const int idx : manifest_indices)
                 {
-                    const std::string json_stem =
-                        ToLower(fs::path(m_entries[idx].name).stem().string());
-                    if (json_stem == sng_stem)
+                    const std::string json_name = ToLower(m_entries[idx].name);
+                    if (json_name.find(sng_stem) != std::string::npos)
                     {
                         matched_manifest = idx;
                         break;
                     }
                 }
+            }
 
-                if (matched_manifest < 0)
-                {
-                    for (const int idx : manifest_indices)
-                    {
-                        const std::string json_name = ToLower(m_entries[idx].name);
-                        if (json_name.find(sng_stem) != std::string::npos)
-                        {
-                            matched_manifest = idx;
-                            break;
-                        }
-                    }
-                }
+            matched_manifests[s] = matched_manifest;
+        }
 
-                if (matched_manifest >= 0)
-                {
-                    const auto json_data = ExtractFileByIndex(matched_manifest);
-                    std::string json_text(json_data.begin(), json_data.end());
-                    manifest = ParseManifestMetadata(json_text);
-                }
+        const auto sng_size = [&](size_t task) -> uint64_t {
+            return m_entries[m_file_map.at(sng_files[task])].uncompressed_size;
+        };
+        const auto manifest_size = [&](size_t task) -> uint64_t {
+            const int manifest = matched_manifests[task];
+            return manifest >= 0 ? m_entries[manifest].uncompressed_size : 0;
+        };
+
+        uint64_t bytes_total = 0;
+        for (size_t s = 0; s < sng_files.size(); ++s)
+        {
+            bytes_total += sng_size(s) + manifest_size(s);
+        }
+        OperationMonitor monitor(options, sng_files.size(), bytes_total);
+
+        std::vector<PsarcEntryResult> results(sng_files.size());
+
+        // Encrypted, decrypted and inflated SNG plus the parsed arrangement
+        RunTasks(
+            sng_files.size(), options, monitor,
+            [&](size_t task) {
+                return 4 * sng_size(task) + 2 * manifest_size(task) +
+                       GetCacheCost(m_file_map.at(sng_files[task]), options);
+            },
+            [&](size_t task, std::istream& stream) {
+                const auto& sng_name = sng_files[task];
+                const int matched_manifest = matched_manifests[task];
+                OperationMonitor::Task progress(monitor, sng_size(task) + manifest_size(task));
 
                 // Output path: songs/bin/generic/foo.sng -> {output_dir}/songs/arr/foo.xml
                 const fs::path sng_path(sng_name);
                 const std::string xml_name = sng_path.stem().string() + ".xml";
                 const fs::path xml_path = fs::path(output_directory) / "songs" / "arr" / xml_name;
-                fs::create_directories(xml_path.parent_path());
 
-                SngXmlWriter::Write(sng_data, xml_path, manifest ? &(*manifest) : nullptr);
+                results[task] = RunEntry(sng_name, xml_path, [&](auto& result) {
+                    fs::create_directories(xml_path.parent_path());
+
+                    // The XML embeds manifest metadata, so the manifest is part of the cache key
+                    std::string kind = "xml";
+                    if (matched_manifest >= 0 && !options.cache_directory.empty())
+                    {
+                        kind += ":" + GetContentDigest(matched_manifest, "manifest", stream);
+                    }
+
+                    const int sng_index = m_file_map.at(sng_name);
+                    const bool cached = WriteCachedOutput(
+                        xml_path, options, sng_index, kind, stream,
+                        [&](const fs::path& path, std::istream& input) {
+                            const auto sng_bytes = ExtractFileByIndex(sng_index, input, &progress);
+                            std::vector<uint8_t> json_data;
+                            if (matched_manifest >= 0)
+                            {
+                                json_data = ExtractFileByIndex(matched_manifest, input, &progress);
+                            }
+
+                            result.error_code = PsarcErrorCode::ConversionFailed;
+                            const auto sng_data = SngParser::Parse(sng_bytes);
+
+                            std::optional<SngManifestMetadata> manifest;
+                            if (matched_manifest >= 0)
+                            {
+                                std::string json_text(json_data.begin(), json_data.end());
+                                manifest = ManifestParser::Parse(json_text);
+                            }
+
+                            result.error_code = PsarcErrorCode::WriteFailed;
+                            SngXmlWriter::Write(sng_data, path,
+                                                manifest ? &(*manifest) : nullptr);
+                            CountOutput(fs::file_size(path));
+                        });
+                    SetOutcome(result, cached, sng_size(task) + manifest_size(task), xml_path);
+                });
+            },
+            [&](size_t task) {
+                const std::array indices = {m_file_map.at(sng_files[task]),
+                                            matched_manifests[task]};
+                PrefetchEntries(indices);
+            });
+
+        PsarcReport report;
+        report.entries = std::move(results);
+        FinishReport(report, start);
+        return report;
+    }
+
+    void ReplaceFile(const std::string& file_name, std::span<const uint8_t> data)
+    {
+        PSARC_TRACE_SCOPE_DETAIL("PsarcFile::ReplaceFile", file_name);
+        const auto it = m_file_map.find(file_name);
+        if (it == m_file_map.end())
+        {
+            throw PsarcException(std::format("File not found: {}", file_name));
+        }
+
+        ThrowIfExternalSource("ReplaceFile");
+        PsarcTocLayout layout = BuildTocLayout();
+
+        std::fstream file(m_file_path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file)
+        {
+            throw PsarcException(std::format("Failed to open file for writing: {}", m_file_path));
+        }
+
+        file.seekp(0, std::ios::end);
+        auto end_offset = static_cast<uint64_t>(file.tellp());
+        const uint64_t appended_offset = end_offset;
+
+        // Append the new blocks; the old ones become dead space until Compact(). Renumbering
+        // drops the old blocks' z-lengths, so the TOC only grows by the difference in blocks.
+        auto& replaced = layout.entries[it->second];
+        replaced.start_chunk_index = static_cast<uint32_t>(layout.z_lengths.size());
+        replaced.uncompressed_size = data.size();
+        replaced.offset = end_offset;
+
+        const auto blocks = PsarcWriter::CompressBlocks(data, m_header.block_size,
+                                                        m_header.compression_method,
+                                                        layout.z_lengths);
+        WriteAt(file, end_offset, blocks);
+        end_offset += blocks.size();
+        RenumberChunks(layout);
+
+        // If the TOC grows, copy whichever entries sit directly behind it to the end of the
+        // archive until the new TOC fits in front of the data. The copies stay unreferenced until
+        // the new TOC is in place, so the current one remains valid throughout.
+        const uint64_t toc_length = PsarcWriter::GetTocLength(layout);
+        while (true)
+        {
+            PsarcTocEntry* first = nullptr;
+            for (auto& entry : layout.entries)
+            {
+                if (entry.uncompressed_size > 0 && (!first || entry.offset < first->offset))
+                {
+                    first = &entry;
+                }
+            }
+
+            if (!first || first->offset >= toc_length)
+            {
+                break;
+            }
+
+            const auto raw = ReadAt(file, first->offset, GetCompressedSize(layout, *first));
+            WriteAt(file, end_offset, raw);
+            first->offset = end_offset;
+            end_offset += raw.size();
+        }
+
+        // The new TOC may overlap the first appended blocks on small archives
+        TocJournalTarget target{.archive_size = end_offset,
+                                .old_toc_length = m_header.toc_length,
+                                .appended_offset = std::max(appended_offset, toc_length)};
+        const auto old_toc_crc = ComputeCrc32(file, 0, target.old_toc_length);
+        const auto appended_crc =
+            ComputeCrc32(file, target.appended_offset, end_offset - target.appended_offset);
+        file.close();
+        if (!file || !old_toc_crc || !appended_crc)
+        {
+            throw PsarcException(std::format("Failed to write file: {}", m_file_path));
+        }
+        target.old_toc_crc = *old_toc_crc;
+        target.appended_crc = *appended_crc;
+        SyncToDisk(m_file_path);
+
+        // Overwriting the TOC in place is the one step that can leave the archive unreadable, so
+        // it is journaled first: Open() finishes the rewrite if it is interrupted
+        const auto header_and_toc = PsarcWriter::EncodeHeaderAndToc(layout);
+        const fs::path journal_path = GetTocJournalPath();
+        WriteTocJournal(journal_path, target, header_and_toc);
+        WriteHeaderAndToc(header_and_toc);
+        fs::remove(journal_path);
+
+        Reload();
+    }
+
+    void Compact()
+    {
+        PSARC_TRACE_SCOPE("PsarcFile::Compact");
+        if (!m_is_open)
+        {
+            throw PsarcException("Archive is not open");
+        }
+        ThrowIfExternalSource("Compact");
+
+        const PsarcTocLayout layout = BuildTocLayout();
+        PsarcTocLayout compacted = layout;
+        RenumberChunks(compacted);
+
+        uint64_t offset = PsarcWriter::GetTocLength(compacted);
+        for (auto& entry : compacted.entries)
+        {
+            entry.offset = offset;
+            offset += GetCompressedSize(compacted, entry);
+        }
+
+        const std::string temp_path = m_file_path + ".compact";
+        {
+            std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                throw PsarcException(std::format("Failed to create file: {}", temp_path));
+            }
+
+            WriteAt(out, 0, PsarcWriter::EncodeHeaderAndToc(compacted));
+            for (size_t i = 0; i < layout.entries.size(); ++i)
+            {
+                const auto& entry = layout.entries[i];
+                const auto raw = ReadAt(*m_file, entry.offset, GetCompressedSize(layout, entry));
+                WriteAt(out, compacted.entries[i].offset, raw);
             }
-            catch (const std::exception& e)
+
+            out.close();
+            if (!out)
             {
-                failed_files.push_back(std::format("{}: {}", sng_name, e.what()));
+                fs::remove(temp_path);
+                throw PsarcException(std::format("Failed to write file: {}", temp_path));
             }
         }
 
-        if (!failed_files.empty())
+        SyncToDisk(temp_path);
+
+        Close();
+        std::error_code ec;
+        fs::rename(temp_path, m_file_path, ec);
+        if (ec)
         {
-            std::string error_msg =
-                std::format("Failed to convert {} SNG file(s):\n", failed_files.size());
-            for (const auto& msg : failed_files)
+            // The archive itself is untouched, so carry on with it
+            std::error_code ignored;
+            fs::remove(temp_path, ignored);
+            Open();
+            throw PsarcException(
+                std::format("Failed to replace {}: {}", m_file_path, ec.message()));
+        }
+        Open();
+    }
+
+    [[nodiscard]] PsarcStats GetStats() const
+    {
+        return m_stats.GetStats();
+    }
+
+    void ResetStats()
+    {
+        m_stats.Reset();
+    }
+
+    [[nodiscard]] std::vector<std::string> Verify(const PsarcOptions& options) const
+    {
+        PSARC_TRACE_SCOPE("PsarcFile::Verify");
+        if (!m_is_open)
+        {
+            throw PsarcException("Archive is not open");
+        }
+        const StatsCollector::PhaseTimer timer(m_stats, StatsCollector::Phase::Verify);
+
+        const std::unordered_set<std::string> selected(options.entries.begin(),
+                                                       options.entries.end());
+        std::vector<int> pending;
+        uint64_t bytes_total = 0;
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            if (IsSelected(selected, m_entries[i].name))
             {
-                error_msg += "  " + msg + "\n";
+                pending.push_back(static_cast<int>(i));
+                bytes_total += m_entries[i].uncompressed_size;
             }
-            throw PsarcException(error_msg);
         }
+        OperationMonitor monitor(options, pending.size(), bytes_total);
+
+        const uint64_t archive_size = m_archive_size;
+        std::vector<std::string> errors(pending.size());
+        RunTasks(
+            pending.size(), options, monitor,
+            [&](size_t /*task*/) { return 2 * uint64_t{m_header.block_size}; },
+            [&](size_t task, std::istream& stream) {
+                const auto& entry = m_entries[pending[task]];
+                OperationMonitor::Task progress(monitor, entry.uncompressed_size);
+                try
+                {
+                    VerifyEntry(entry, stream, archive_size, &progress);
+                }
+                catch (const PsarcCancelledException&)
+                {
+                    throw;
+                }
+                catch (const std::exception& e)
+                {
+                    errors[task] = e.what();
+                    stream.clear();
+                }
+            },
+            [&](size_t task) { PrefetchEntries(std::span(&pending[task], 1)); });
+
+        std::vector<std::string> failed_files;
+        for (size_t task = 0; task < pending.size(); ++task)
+        {
+            if (!errors[task].empty())
+            {
+                const int index = pending[task];
+                const std::string& name = m_entries[index].name.empty()
+                                              ? std::format("entry {}", index)
+                                              : m_entries[index].name;
+                failed_files.push_back(std::format("{}: {}", name, errors[task]));
+            }
+        }
+        return failed_files;
     }
 
 private:
     struct FileEntry
     {
         std::string name;
+        std::array<uint8_t, 16> md5{};
         uint64_t offset = 0;
         uint64_t uncompressed_size = 0;
         uint32_t start_chunk_index = 0;
     };
 
+    // One OGG to produce, from either a WEM entry or audio embedded in a BNK
+    struct AudioJob
+    {
+        std::string name; // Entry converted: the streamed WEM, or the BNK that embeds it
+        fs::path ogg_path;
+        int wem_index = -1;
+        int bnk_index = -1; // For WEMs embedded in a BNK: the BNK and the entry holding it
+        size_t bnk_entry = 0;
+        uint64_t embedded_size = 0;
+        int cache_index = 0;
+        std::string cache_kind;
+    };
+
     struct Header
     {
         uint32_t magic = 0;
@@ -732,6 +1464,7 @@ private:
             throw PsarcException(std::format("Unexpected end of file: expected {} bytes, got {}",
                                              count, m_file->gcount()));
         }
+        m_stats.Add(StatsCollector::Counter::BytesRead, count);
     }
 
     [[nodiscard]] uint16_t ReadBigEndian16()
@@ -750,6 +1483,7 @@ private:
 
     void ReadHeader()
     {
+        PSARC_TRACE_SCOPE("ReadHeader");
         m_file->seekg(0);
         m_header.magic = ReadBigEndian32();
 
@@ -772,14 +1506,25 @@ private:
             throw PsarcException(std::format("Unsupported PSARC version: {}.{}",
                                              m_header.version_major, m_header.version_minor));
         }
+
+        // Everything read later is sized from these, so reject them before allocating anything
+        if (m_header.toc_length < g_psarc_header_size || m_header.toc_length > m_archive_size)
+        {
+            throw PsarcException(std::format("Invalid TOC length: {}", m_header.toc_length));
+        }
+        if (m_header.block_size == 0 || m_header.block_size > g_max_block_size)
+        {
+            throw PsarcException(std::format("Invalid block size: {}", m_header.block_size));
+        }
     }
 
     void ReadToc()
     {
+        PSARC_TRACE_SCOPE("ReadToc");
         const bool encrypted = (m_header.archive_flags & g_toc_encrypted_flag) != 0;
 
-        m_file->seekg(32);
-        std::vector<uint8_t> toc_data(m_header.toc_length - 32);
+        m_file->seekg(g_psarc_header_size);
+        std::vector<uint8_t> toc_data(m_header.toc_length - g_psarc_header_size);
         ReadBytes(toc_data.data(), toc_data.size());
 
         if (encrypted)
@@ -793,19 +1538,28 @@ private:
             throw PsarcException("Invalid TOC entry size");
         }
 
+        if (uint64_t{m_header.num_files} * m_header.toc_entry_size > toc_data.size())
+        {
+            throw PsarcException(
+                std::format("TOC declares {} entries but holds only {} bytes", m_header.num_files,
+                            toc_data.size()));
+        }
+
         size_t pos = 0;
 
         m_entries.resize(m_header.num_files);
 
         for (uint32_t i = 0; i < m_header.num_files; ++i)
         {
-            pos += 16; // Skip MD5
-
-            if (pos + 4 > toc_data.size())
+            if (pos + 20 > toc_data.size())
             {
                 throw PsarcException("TOC data truncated while reading entry");
             }
 
+            std::copy_n(toc_data.begin() + static_cast<std::ptrdiff_t>(pos), 16,
+                        m_entries[i].md5.begin());
+            pos += 16;
+
             m_entries[i].start_chunk_index = ReadBE32(toc_data.data() + pos);
             pos += 4;
 
@@ -829,15 +1583,48 @@ private:
             m_entries[i].offset = offset;
         }
 
+        m_z_lengths.reserve((toc_data.size() - pos) / 2);
         while (pos + 1 < toc_data.size())
         {
             m_z_lengths.push_back(ReadBE16(toc_data.data() + pos));
             pos += 2;
         }
+
+        // Extraction allocates an entry's full size up front, so it must be backed by stored
+        // blocks that lie within the archive and could inflate to that size
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            const auto& entry = m_entries[i];
+            const uint64_t chunk_count =
+                (entry.uncompressed_size + m_header.block_size - 1) / m_header.block_size;
+            if (entry.start_chunk_index + chunk_count > m_z_lengths.size())
+            {
+                throw PsarcException(std::format(
+                    "TOC entry {} ({} bytes) references blocks past the end of the block table", i,
+                    entry.uncompressed_size));
+            }
+
+            const uint64_t stored_size = GetCompressedSize(entry);
+            if (stored_size != 0 &&
+                (entry.offset > m_archive_size || stored_size > m_archive_size - entry.offset))
+            {
+                throw PsarcException(
+                    std::format("TOC entry {} ({} stored bytes at offset {}) runs past the end of "
+                                "the archive",
+                                i, stored_size, entry.offset));
+            }
+            if (entry.uncompressed_size > stored_size * g_max_deflate_ratio)
+            {
+                throw PsarcException(
+                    std::format("TOC entry {} claims {} bytes from {} stored bytes", i,
+                                entry.uncompressed_size, stored_size));
+            }
+        }
     }
 
     void ReadManifest()
     {
+        PSARC_TRACE_SCOPE("ReadManifest");
         if (m_entries.empty())
         {
             throw PsarcException("No entries in PSARC");
@@ -846,36 +1633,598 @@ private:
         const auto manifest_data = ExtractFileByIndex(0);
         const std::string manifest(manifest_data.begin(), manifest_data.end());
 
-        std::vector<std::string> names;
-        std::istringstream iss(manifest);
-        std::string line;
+        std::vector<std::string> names;
+        std::istringstream iss(manifest);
+        std::string line;
+
+        while (std::getline(iss, line))
+        {
+            const size_t start = line.find_first_not_of(" \t\r\n");
+            const size_t end = line.find_last_not_of(" \t\r\n");
+            if (start != std::string::npos)
+            {
+                names.push_back(line.substr(start, end - start + 1));
+            }
+        }
+
+        m_entries[0].name = "NamesBlock.bin";
+        m_file_map["NamesBlock.bin"] = 0;
+
+        for (size_t i = 1; i < m_entries.size() && i - 1 < names.size(); ++i)
+        {
+            m_entries[i].name = names[i - 1];
+            m_file_map[names[i - 1]] = static_cast<int>(i);
+        }
+
+        // The views point into m_entries, which is not resized again until the next Open
+        m_entry_views.reserve(m_entries.size());
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            const auto& entry = m_entries[i];
+            if (!entry.name.empty())
+            {
+                m_entry_views.push_back({.name = entry.name,
+                                         .size = entry.uncompressed_size,
+                                         .index = static_cast<int>(i)});
+            }
+        }
+    }
+
+    void CheckIndex(int index) const
+    {
+        if (index < 0 || std::cmp_greater_equal(index, m_entries.size()))
+        {
+            throw PsarcException(std::format("Entry index {} out of range ({} entries)", index,
+                                             m_entries.size()));
+        }
+    }
+
+    [[nodiscard]] PsarcTocLayout BuildTocLayout() const
+    {
+        PsarcTocLayout layout;
+        layout.compression_method = m_header.compression_method;
+        layout.toc_entry_size = m_header.toc_entry_size;
+        layout.block_size = m_header.block_size;
+        layout.archive_flags = m_header.archive_flags;
+        layout.z_lengths = m_z_lengths;
+        layout.entries.reserve(m_entries.size());
+        for (const auto& entry : m_entries)
+        {
+            layout.entries.push_back({.md5 = entry.md5,
+                                      .start_chunk_index = entry.start_chunk_index,
+                                      .uncompressed_size = entry.uncompressed_size,
+                                      .offset = entry.offset});
+        }
+        return layout;
+    }
+
+    [[nodiscard]] static uint32_t GetChunkCount(uint64_t uncompressed_size, uint32_t block_size)
+    {
+        return static_cast<uint32_t>((uncompressed_size + block_size - 1) / block_size);
+    }
+
+    // Bytes occupied on disk by an entry's blocks
+    [[nodiscard]] static uint64_t GetCompressedSize(std::span<const uint16_t> z_lengths,
+                                                    uint32_t block_size,
+                                                    uint32_t start_chunk_index,
+                                                    uint64_t uncompressed_size)
+    {
+        const uint32_t chunk_count = GetChunkCount(uncompressed_size, block_size);
+        if (static_cast<uint64_t>(start_chunk_index) + chunk_count > z_lengths.size())
+        {
+            throw PsarcException("Chunk index out of range");
+        }
+
+        // A raw (z_len 0) block holds a whole block, or whatever remains of the entry
+        uint64_t size = 0;
+        uint64_t remaining = uncompressed_size;
+        for (uint32_t i = 0; i < chunk_count; ++i)
+        {
+            const uint64_t block = std::min<uint64_t>(remaining, block_size);
+            const uint16_t z_len = z_lengths[start_chunk_index + i];
+            size += z_len == 0 ? block : z_len;
+            remaining -= block;
+        }
+        return size;
+    }
+
+    [[nodiscard]] static uint64_t GetCompressedSize(const PsarcTocLayout& layout,
+                                                    const PsarcTocEntry& entry)
+    {
+        return GetCompressedSize(layout.z_lengths, layout.block_size, entry.start_chunk_index,
+                                 entry.uncompressed_size);
+    }
+
+    [[nodiscard]] uint64_t GetCompressedSize(const FileEntry& entry) const
+    {
+        return GetCompressedSize(m_z_lengths, m_header.block_size, entry.start_chunk_index,
+                                 entry.uncompressed_size);
+    }
+
+    [[nodiscard]] PsarcEntryInfo MakeEntryInfo(int index) const
+    {
+        const auto& entry = m_entries[index];
+        PsarcEntryInfo info;
+        info.name = entry.name;
+        info.index = index;
+        info.uncompressed_size = entry.uncompressed_size;
+        info.compressed_size = GetCompressedSize(entry);
+        info.offset = entry.offset;
+        info.start_chunk_index = entry.start_chunk_index;
+        info.md5 = entry.md5;
+        info.block_count = GetChunkCount(entry.uncompressed_size, m_header.block_size);
+
+        // Blocks stored raw have a z-length equal to their plain size, or 0 for a full block
+        uint64_t remaining = entry.uncompressed_size;
+        for (uint64_t i = 0; i < info.block_count; ++i)
+        {
+            const uint64_t plain_size = std::min<uint64_t>(remaining, m_header.block_size);
+            const uint16_t z_len = m_z_lengths[entry.start_chunk_index + i];
+            if (z_len == 0 || z_len == plain_size)
+            {
+                ++info.stored_blocks;
+            }
+            remaining -= plain_size;
+        }
+        return info;
+    }
+
+    // Identifies an entry's stored data from the TOC alone: replacing or repacking an entry moves
+    // its blocks or changes their lengths
+    [[nodiscard]] std::string GetEntryFingerprint(const FileEntry& entry) const
+    {
+        // FNV-1a over the entry's block lengths
+        uint64_t hash = 0xcbf29ce484222325;
+        const uint32_t chunk_count = GetChunkCount(entry.uncompressed_size, m_header.block_size);
+        for (uint32_t i = 0; i < chunk_count; ++i)
+        {
+            const size_t chunk = static_cast<size_t>(entry.start_chunk_index) + i;
+            hash = (hash ^ (chunk < m_z_lengths.size() ? m_z_lengths[chunk] : 0)) *
+                   0x100000001b3;
+        }
+        return std::format("{}:{}:{:016x}", entry.offset, entry.uncompressed_size, hash);
+    }
+
+    [[nodiscard]] fs::path GetIncrementalStatePath(const std::string& output_directory) const
+    {
+        return fs::path(output_directory) /
+               std::format(".{}.state.json", fs::path(m_file_path).filename().string());
+    }
+
+    // Digest of an entry's stored blocks, so identical content in different archives maps to the
+    // same cache slot without being decompressed. kind separates the outputs derived from it.
+    // If stored is given, the stored bytes are read in one piece and kept there.
+    [[nodiscard]] std::string GetContentDigest(int index, std::string_view kind,
+                                               std::istream& stream,
+                                               std::vector<uint8_t>* stored = nullptr) const
+    {
+        PSARC_TRACE_SCOPE("GetContentDigest");
+        const auto& entry = m_entries[index];
+        const uint64_t stored_size = GetCompressedSize(entry);
+
+        const std::string_view method(m_header.compression_method.data(),
+                                      m_header.compression_method.size());
+        std::string prefix = std::format("{}\n{}\n{}\n{}\n", kind, method, m_header.block_size,
+                                         entry.uncompressed_size);
+        const uint32_t chunk_count = GetChunkCount(entry.uncompressed_size, m_header.block_size);
+        for (uint32_t i = 0; i < chunk_count; ++i)
+        {
+            prefix += std::format("{} ", m_z_lengths[entry.start_chunk_index + i]);
+        }
+
+        std::array<uint8_t, EVP_MAX_MD_SIZE> digest{};
+        unsigned int digest_length = 0;
+
+        EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+        if (!ctx)
+        {
+            throw PsarcException("Failed to create digest context");
+        }
+
+        bool success = EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr) == 1 &&
+                       EVP_DigestUpdate(ctx, prefix.data(), prefix.size()) == 1;
+
+        // Otherwise hash the stored bytes a block at a time so large entries are never held whole
+        try
+        {
+            if (stored)
+            {
+                *stored = ReadAt(stream, entry.offset, stored_size);
+                success = success && EVP_DigestUpdate(ctx, stored->data(), stored->size()) == 1;
+            }
+            for (uint64_t done = 0; !stored && success && done < stored_size;
+                 done += m_header.block_size)
+            {
+                const uint64_t count = std::min<uint64_t>(m_header.block_size, stored_size - done);
+                const auto raw = ReadAt(stream, entry.offset + done, count);
+                success = EVP_DigestUpdate(ctx, raw.data(), raw.size()) == 1;
+            }
+        }
+        catch (...)
+        {
+            EVP_MD_CTX_free(ctx);
+            throw;
+        }
+
+        success = success && EVP_DigestFinal_ex(ctx, digest.data(), &digest_length) == 1;
+        EVP_MD_CTX_free(ctx);
+
+        if (!success)
+        {
+            throw PsarcException("Failed to compute content digest");
+        }
+
+        return ToHex(std::span(digest.data(), digest_length));
+    }
+
+    // Produces output_path through the content-addressed cache when one is configured. On a miss
+    // produce(path, stream) writes into the cache (via a temporary file so concurrent runs never
+    // observe a partial entry) and the output is copied from there; a hard link would let later
+    // writes to the output change the cached copy. Entries up to g_max_pinned_size are read once:
+    // produce() gets a stream that serves the bytes already hashed from memory.
+    // Returns whether the output came from the cache without calling produce().
+    bool WriteCachedOutput(const fs::path& output_path, const PsarcOptions& options, int index,
+                           std::string_view kind, std::istream& stream,
+                           const std::function<void(const fs::path&, std::istream&)>& produce) const
+    {
+        if (options.cache_directory.empty())
+        {
+            produce(output_path, stream);
+            return false;
+        }
+
+        std::vector<uint8_t> stored;
+        const bool pin = IsPinnedForDigest(index, options);
+        const std::string digest = GetContentDigest(index, kind, stream, pin ? &stored : nullptr);
+        const fs::path cached_path =
+            fs::path(options.cache_directory) / digest.substr(0, 2) / digest;
+
+        const bool hit = fs::exists(cached_path);
+        if (!hit)
+        {
+            fs::create_directories(cached_path.parent_path());
+
+            const fs::path temp_path =
+                cached_path.string() + std::format(".{:08x}.tmp", std::random_device{}());
+            try
+            {
+                if (pin)
+                {
+                    ByteSourceStream pinned(std::make_shared<PinnedRangeSource>(
+                        m_source, m_entries[index].offset, std::move(stored)));
+                    produce(temp_path, pinned);
+                }
+                else
+                {
+                    produce(temp_path, stream);
+                }
+                fs::rename(temp_path, cached_path);
+            }
+            catch (...)
+            {
+                std::error_code ec;
+                fs::remove(temp_path, ec);
+                throw;
+            }
+        }
+
+        // Unlink first so an output hard-linked to the cache by an earlier run is replaced
+        // rather than written through
+        std::error_code ec;
+        fs::remove(output_path, ec);
+        fs::copy_file(cached_path, output_path, fs::copy_options::overwrite_existing);
+        return hit;
+    }
+
+    // Whether WriteCachedOutput holds the entry's stored bytes in memory between hashing and
+    // producing it. Sources already in memory are read in place anyway.
+    [[nodiscard]] bool IsPinnedForDigest(int index, const PsarcOptions& options) const
+    {
+        return !options.cache_directory.empty() && m_source->GetData().empty() &&
+               GetCompressedSize(m_entries[index]) <= g_max_pinned_size;
+    }
+
+    // Memory WriteCachedOutput holds for an entry on top of what producing it needs
+    [[nodiscard]] uint64_t GetCacheCost(int index, const PsarcOptions& options) const
+    {
+        return IsPinnedForDigest(index, options) ? GetCompressedSize(m_entries[index]) : 0;
+    }
+
+    // Memory held while extracting an entry: SNGs are decrypted whole, everything else streams
+    [[nodiscard]] uint64_t GetExtractionCost(const FileEntry& entry) const
+    {
+        const uint64_t blocks = 2 * uint64_t{m_header.block_size};
+        return IsSngFile(entry.name) ? 3 * entry.uncompressed_size + blocks : blocks;
+    }
+
+    // Passes the stored ranges of entries to the byte source as one hint per run of ranges less
+    // than a block apart
+    void PrefetchEntries(std::span<const int> indices) const
+    {
+        if (!m_is_open)
+        {
+            return;
+        }
+
+        std::vector<std::pair<uint64_t, uint64_t>> ranges;
+        ranges.reserve(indices.size());
+        for (const int index : indices)
+        {
+            if (index < 0 || std::cmp_greater_equal(index, m_entries.size()))
+            {
+                continue;
+            }
+            const auto& entry = m_entries[index];
+            try
+            {
+                if (const uint64_t size = GetCompressedSize(entry); size != 0)
+                {
+                    ranges.emplace_back(entry.offset, entry.offset + size);
+                }
+            }
+            catch (const PsarcException&) // NOLINT(bugprone-empty-catch): reported when read
+            {
+            }
+        }
+
+        std::ranges::sort(ranges);
+        for (size_t i = 0; i < ranges.size();)
+        {
+            auto [start, end] = ranges[i];
+            for (++i; i < ranges.size() && ranges[i].first <= end + g_max_block_size; ++i)
+            {
+                end = std::max(end, ranges[i].second);
+            }
+            m_source->Prefetch(start, end - start);
+        }
+    }
+
+    // Runs task(i, stream) for every i in [0, count) on options.thread_count workers, each reading
+    // through its own handle to the archive. cost(i) bytes of options.memory_budget are held for
+    // the duration of each task, so large tasks wait for room while small ones run side by side.
+    // No new task starts after cancellation; the first exception a task lets escape is rethrown.
+    // prefetch(i) is called a round of workers before task i, so its reads overlap earlier work.
+    void RunTasks(size_t count, const PsarcOptions& options, const OperationMonitor& monitor,
+                  const std::function<uint64_t(size_t)>& cost,
+                  const std::function<void(size_t, std::istream&)>& task,
+                  const std::function<void(size_t)>& prefetch = {}) const
+    {
+        MemoryBudget budget(options.memory_budget);
+
+        size_t thread_count = options.thread_count;
+        if (thread_count == 0)
+        {
+            thread_count = std::max(1U, std::thread::hardware_concurrency());
+        }
+        thread_count = std::min(thread_count, count);
+
+        const size_t lookahead = std::max<size_t>(thread_count, 1);
+        const auto prefetch_task = [&](size_t i) {
+            if (prefetch && i < count)
+            {
+                prefetch(i);
+            }
+        };
+        for (size_t i = 0; i < lookahead; ++i)
+        {
+            prefetch_task(i);
+        }
+
+        if (thread_count <= 1)
+        {
+            const StreamLease stream(*this);
+            for (size_t i = 0; i < count; ++i)
+            {
+                monitor.ThrowIfCancelled();
+                const MemoryBudget::Reservation reservation(budget, cost(i));
+                prefetch_task(i + lookahead);
+                task(i, stream.Get());
+                stream.Get().clear();
+            }
+            return;
+        }
+
+        std::atomic<size_t> next_task{0};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        const auto worker = [&] {
+            try
+            {
+                ByteSourceStream stream(m_source);
+                for (size_t i = next_task++; i < count; i = next_task++)
+                {
+                    monitor.ThrowIfCancelled();
+                    const MemoryBudget::Reservation reservation(budget, cost(i));
+                    prefetch_task(i + lookahead);
+                    task(i, stream);
+                    stream.clear();
+                }
+            }
+            catch (...)
+            {
+                const std::scoped_lock lock(error_mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                next_task = count;
+            }
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(thread_count);
+            for (size_t i = 0; i < thread_count; ++i)
+            {
+                threads.emplace_back(worker);
+            }
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    [[nodiscard]] std::vector<uint8_t> ReadAt(std::istream& stream, uint64_t offset,
+                                              uint64_t count) const
+    {
+        std::vector<uint8_t> data(count);
+        stream.seekg(static_cast<std::streamoff>(offset));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        stream.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(count));
+        if (std::cmp_not_equal(stream.gcount(), count))
+        {
+            throw PsarcException(std::format("Unexpected end of file: expected {} bytes, got {}",
+                                             count, stream.gcount()));
+        }
+        m_stats.Add(StatsCollector::Counter::BytesRead, count);
+        return data;
+    }
+
+    static void WriteAt(std::ostream& stream, uint64_t offset, const std::vector<uint8_t>& data)
+    {
+        stream.seekp(static_cast<std::streamoff>(offset));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        stream.write(reinterpret_cast<const char*>(data.data()),
+                     static_cast<std::streamsize>(data.size()));
+        if (!stream.good())
+        {
+            throw PsarcException("Failed to write to file");
+        }
+    }
+
+    // Rewriting needs the archive's file; sources supplied by the caller may not have one
+    void ThrowIfExternalSource(std::string_view operation) const
+    {
+        if (m_external_source)
+        {
+            throw PsarcException(
+                std::format("{} needs an archive opened from a file path", operation));
+        }
+    }
+
+    void Reload()
+    {
+        Close();
+        Open();
+    }
+
+    // Copies every entry's z-lengths into a fresh table in entry order, so each entry's blocks
+    // are numbered contiguously and z-lengths no entry refers to are dropped
+    static void RenumberChunks(PsarcTocLayout& layout)
+    {
+        std::vector<uint16_t> z_lengths;
+        z_lengths.reserve(layout.z_lengths.size());
+        for (auto& entry : layout.entries)
+        {
+            const auto first_chunk = entry.start_chunk_index;
+            const auto chunk_count = GetChunkCount(entry.uncompressed_size, layout.block_size);
+            if (static_cast<uint64_t>(first_chunk) + chunk_count > layout.z_lengths.size())
+            {
+                throw PsarcException("Chunk index out of range");
+            }
+
+            entry.start_chunk_index = static_cast<uint32_t>(z_lengths.size());
+            z_lengths.insert(z_lengths.end(), layout.z_lengths.begin() + first_chunk,
+                             layout.z_lengths.begin() + first_chunk + chunk_count);
+        }
+        layout.z_lengths = std::move(z_lengths);
+    }
+
+    // Holds the archive's TocJournalTarget and the header and TOC that ReplaceFile is writing
+    // over the archive's, followed by a big-endian CRC-32 of both, until the rewrite is complete
+    [[nodiscard]] fs::path GetTocJournalPath() const
+    {
+        return m_file_path + ".journal";
+    }
+
+    static void WriteTocJournal(const fs::path& path, const TocJournalTarget& target,
+                                const std::vector<uint8_t>& header_and_toc)
+    {
+        std::vector<uint8_t> journal(TocJournalTarget::g_size + header_and_toc.size() + 4);
+        target.Write(journal.data());
+        std::ranges::copy(header_and_toc, journal.begin() + TocJournalTarget::g_size);
+        const size_t body_size = journal.size() - 4;
+        WriteBE32(journal.data() + body_size,
+                  static_cast<uint32_t>(crc32(0L, journal.data(), static_cast<uInt>(body_size))));
+        WriteFile(path, journal);
+        SyncToDisk(path);
+        SyncToDisk(fs::absolute(path).parent_path());
+    }
+
+    void WriteHeaderAndToc(const std::vector<uint8_t>& header_and_toc) const
+    {
+        std::fstream file(m_file_path, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file)
+        {
+            throw PsarcException(std::format("Failed to open file for writing: {}", m_file_path));
+        }
+        WriteAt(file, 0, header_and_toc);
+        file.close();
+        if (!file)
+        {
+            throw PsarcException(std::format("Failed to write file: {}", m_file_path));
+        }
+        SyncToDisk(m_file_path);
+    }
+
+    // Finishes a ReplaceFile that stopped while overwriting the TOC. A journal that fails its
+    // checksum was still being written, before the archive was touched, and one whose target no
+    // longer matches belongs to an archive since replaced at this path; both are dropped.
+    void ReplayTocJournal() const
+    {
+        const fs::path journal_path = GetTocJournalPath();
+        std::ifstream in(journal_path, std::ios::binary);
+        if (!in)
+        {
+            return;
+        }
+        std::vector<uint8_t> journal(std::istreambuf_iterator<char>(in), {});
+        in.close();
 
-        while (std::getline(iss, line))
+        if (journal.size() >= TocJournalTarget::g_size + g_psarc_header_size + 4)
         {
-            const size_t start = line.find_first_not_of(" \t\r\n");
-            const size_t end = line.find_last_not_of(" \t\r\n");
-            if (start != std::string::npos)
+            const size_t body_size = journal.size() - 4;
+            const auto crc = static_cast<uint32_t>(
+                crc32(0L, journal.data(), static_cast<uInt>(body_size)));
+            const std::vector<uint8_t> header_and_toc(
+                journal.begin() + TocJournalTarget::g_size, journal.end() - 4);
+            if (ReadBE32(journal.data() + body_size) == crc &&
+                ReadBE32(header_and_toc.data()) == g_psarc_magic &&
+                IsTocJournalTarget(TocJournalTarget::Read(journal.data())))
             {
-                names.push_back(line.substr(start, end - start + 1));
+                WriteHeaderAndToc(header_and_toc);
             }
         }
+        fs::remove(journal_path);
+    }
 
-        m_entries[0].name = "NamesBlock.bin";
-        m_file_map["NamesBlock.bin"] = 0;
-
-        for (size_t i = 1; i < m_entries.size() && i - 1 < names.size(); ++i)
+    // The archive must have the journaled size and either still hold the header and TOC being
+    // replaced or, if their rewrite was torn, the blocks appended for it
+    [[nodiscard]] bool IsTocJournalTarget(const TocJournalTarget& target) const
+    {
+        std::error_code error;
+        const auto size = fs::file_size(m_file_path, error);
+        if (error || size != target.archive_size || target.appended_offset > size)
         {
-            m_entries[i].name = names[i - 1];
-            m_file_map[names[i - 1]] = static_cast<int>(i);
+            return false;
         }
+        std::ifstream file(m_file_path, std::ios::binary);
+        return ComputeCrc32(file, 0, target.old_toc_length) == target.old_toc_crc ||
+               ComputeCrc32(file, target.appended_offset, size - target.appended_offset) ==
+                   target.appended_crc;
     }
 
     [[nodiscard]] std::vector<uint8_t> DecryptToc(const std::vector<uint8_t>& data)
     {
+        PSARC_TRACE_SCOPE("DecryptToc");
         if (data.empty())
         {
             return {};
         }
+        m_stats.Add(StatsCollector::Counter::BytesDecrypted, data.size());
 
         const size_t padded_size = ((data.size() + 15) / 16) * 16;
         std::vector<uint8_t> input = data;
@@ -910,8 +2259,10 @@ private:
         return output;
     }
 
-    [[nodiscard]] std::vector<uint8_t> DecryptSng(const std::vector<uint8_t>& data)
+    // Decrypts and, if needed, inflates an SNG entry in place, so data keeps its allocation
+    void DecryptSng(std::vector<uint8_t>& data) const
     {
+        PSARC_TRACE_SCOPE("DecryptSng");
         if (data.size() < 24)
         {
             throw PsarcException("SNG data too short");
@@ -921,10 +2272,17 @@ private:
             throw PsarcException("Invalid SNG magic");
         }
 
-        const uint32_t flags = ReadLE32(data.data() + 4);
+        // Compressed payloads are decrypted into scratch and inflated back into data; plain ones
+        // are decrypted where they lie and then moved over the header
+        const bool compressed = (ReadLE32(data.data() + 4) & g_sng_compressed_flag) != 0;
         const uint8_t* iv = data.data() + 8;
-        std::vector<uint8_t> payload(data.begin() + 24, data.end());
-        std::vector<uint8_t> decrypted(payload.size());
+        const auto payload = std::span(data).subspan(24);
+        auto& scratch = GetBlockScratch().chunk;
+        if (compressed)
+        {
+            m_stats.Resize(scratch, payload.size());
+        }
+        uint8_t* decrypted = compressed ? scratch.data() : payload.data();
 
         EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
         if (!ctx)
@@ -938,7 +2296,7 @@ private:
         if (success)
         {
             EVP_CIPHER_CTX_set_padding(ctx, 0);
-            success = EVP_DecryptUpdate(ctx, decrypted.data(), &len, payload.data(),
+            success = EVP_DecryptUpdate(ctx, decrypted, &len, payload.data(),
                                         static_cast<int>(payload.size())) == 1;
         }
 
@@ -949,28 +2307,39 @@ private:
             throw PsarcException("Failed to decrypt SNG");
         }
 
-        decrypted.resize(static_cast<size_t>(len));
+        if (!compressed)
+        {
+            std::copy(payload.begin(), payload.begin() + len, data.begin());
+            data.resize(static_cast<size_t>(len));
+            return;
+        }
 
-        if (flags & g_sng_compressed_flag)
+        if (len < 4)
         {
-            const uint32_t uncomp_size = ReadLE32(decrypted.data());
-            std::vector<uint8_t> compressed(decrypted.begin() + 4, decrypted.end());
-            return DecompressZlib(compressed, uncomp_size);
+            throw PsarcException("SNG data too short");
         }
 
-        return decrypted;
+        // Sizes beyond what deflate could produce are corrupt; don't allocate for them
+        const uint32_t uncomp_size = ReadLE32(scratch.data());
+        const auto zlib_data = std::span(scratch).subspan(4, static_cast<size_t>(len) - 4);
+        if (uncomp_size > zlib_data.size() * g_max_deflate_ratio)
+        {
+            throw PsarcException(std::format("Invalid SNG uncompressed size: {}", uncomp_size));
+        }
+        m_stats.Resize(data, uncomp_size);
+        data.resize(DecompressZlib(zlib_data, data));
     }
 
-    [[nodiscard]] static std::vector<uint8_t> DecompressZlib(const std::vector<uint8_t>& data,
-                                                             uint64_t uncompressed_size)
+    // Inflates into output and returns the number of bytes produced, or 0 if data is not zlib
+    [[nodiscard]] static size_t DecompressZlib(std::span<const uint8_t> data,
+                                               std::span<uint8_t> output)
     {
+        PSARC_TRACE_SCOPE("InflateBlock");
         if (data.empty())
         {
-            return {};
+            return 0;
         }
 
-        std::vector<uint8_t> result(uncompressed_size);
-
         constexpr std::array window_bits = {MAX_WBITS, -MAX_WBITS, MAX_WBITS + 32};
 
         for (const int wb : window_bits)
@@ -980,165 +2349,453 @@ private:
             strm.next_in =
                 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
                 const_cast<Bytef*>(data.data());
-            strm.avail_out = static_cast<uInt>(uncompressed_size);
-            strm.next_out = result.data();
+            strm.avail_out = static_cast<uInt>(output.size());
+            strm.next_out = output.data();
 
             if (inflateInit2(&strm, wb) == Z_OK)
             {
                 if (inflate(&strm, Z_FINISH) == Z_STREAM_END)
                 {
                     inflateEnd(&strm);
-                    result.resize(strm.total_out);
-                    return result;
+                    return strm.total_out;
                 }
                 inflateEnd(&strm);
             }
         }
 
-        return {};
+        return 0;
     }
 
-    [[nodiscard]] static std::vector<uint8_t> DecompressLzma(const std::vector<uint8_t>& data,
-                                                             uint64_t uncompressed_size)
+    // Decodes into output and returns the number of bytes produced, or 0 if data is not LZMA
+    [[nodiscard]] static size_t DecompressLzma(std::span<const uint8_t> data,
+                                               std::span<uint8_t> output)
     {
+        PSARC_TRACE_SCOPE("LzmaDecodeBlock");
         if (data.empty())
         {
-            return {};
+            return 0;
         }
 
-        std::vector<uint8_t> result(uncompressed_size);
-
         lzma_stream strm = LZMA_STREAM_INIT;
 
         if (lzma_alone_decoder(&strm, UINT64_MAX) != LZMA_OK)
         {
-            return {};
+            return 0;
         }
 
         strm.next_in = data.data();
         strm.avail_in = data.size();
-        strm.next_out = result.data();
-        strm.avail_out = uncompressed_size;
+        strm.next_out = output.data();
+        strm.avail_out = output.size();
 
         const lzma_ret ret = lzma_code(&strm, LZMA_FINISH);
         lzma_end(&strm);
 
         if (ret == LZMA_STREAM_END || ret == LZMA_OK)
         {
-            result.resize(uncompressed_size - strm.avail_out);
-            return result;
+            return output.size() - strm.avail_out;
+        }
+
+        return 0;
+    }
+
+    // Decompresses one stored block into output, returning the number of bytes produced. Returns
+    // 0 when the block does not decode with the archive's compression method (e.g. it was stored
+    // raw because it did not compress).
+    [[nodiscard]] size_t DecompressBlock(std::span<const uint8_t> chunk,
+                                         std::span<uint8_t> output) const
+    {
+        const std::string_view compression(m_header.compression_method.data(),
+                                           m_header.compression_method.size());
+
+        if (compression == "zlib")
+        {
+            return DecompressZlib(chunk, output);
+        }
+        if (compression == "lzma")
+        {
+            return DecompressLzma(chunk, output);
+        }
+
+        // Try zlib first, then lzma as fallback
+        const size_t produced = DecompressZlib(chunk, output);
+        return produced != 0 ? produced : DecompressLzma(chunk, output);
+    }
+
+    // Lends an idle stream to one ExtractFile call, so callers sharing an open archive across
+    // threads each read from a position of their own
+    class StreamLease
+    {
+    public:
+        explicit StreamLease(const Impl& impl) : m_impl(impl)
+        {
+            {
+                const std::scoped_lock lock(m_impl.m_stream_mutex);
+                if (!m_impl.m_idle_streams.empty())
+                {
+                    m_stream = std::move(m_impl.m_idle_streams.back());
+                    m_impl.m_idle_streams.pop_back();
+                }
+            }
+            if (!m_stream)
+            {
+                m_stream = std::make_unique<ByteSourceStream>(m_impl.m_source);
+            }
+        }
+
+        ~StreamLease()
+        {
+            m_stream->clear();
+            try
+            {
+                const std::scoped_lock lock(m_impl.m_stream_mutex);
+                m_impl.m_idle_streams.push_back(std::move(m_stream));
+            }
+            catch (...) // NOLINT(bugprone-empty-catch): the stream is only dropped
+            {
+            }
+        }
+
+        StreamLease(const StreamLease&) = delete;
+        StreamLease& operator=(const StreamLease&) = delete;
+        StreamLease(StreamLease&&) = delete;
+        StreamLease& operator=(StreamLease&&) = delete;
+
+        [[nodiscard]] ByteSourceStream& Get() const
+        {
+            return *m_stream;
+        }
+
+    private:
+        const Impl& m_impl;
+        std::unique_ptr<ByteSourceStream> m_stream;
+    };
+
+    // Scratch buffers reused by every block read on the current thread, so scanning an archive
+    // does not allocate per block
+    struct BlockScratch
+    {
+        std::vector<uint8_t> chunk;
+        std::vector<uint8_t> block;
+    };
+
+    [[nodiscard]] static BlockScratch& GetBlockScratch()
+    {
+        thread_local BlockScratch scratch;
+        return scratch;
+    }
+
+    // Records a block read from the archive; compressed_size is 0 for blocks stored raw
+    void CountBlock(uint64_t read_size, uint64_t compressed_size, uint64_t plain_size) const
+    {
+        m_stats.Add(StatsCollector::Counter::BytesRead, read_size);
+        m_stats.Add(StatsCollector::Counter::UncompressedBytes, plain_size);
+        if (compressed_size == 0)
+        {
+            m_stats.Add(StatsCollector::Counter::BlocksStored);
+            return;
+        }
+        m_stats.Add(StatsCollector::Counter::CompressedBytes, compressed_size);
+        m_stats.Add(StatsCollector::Counter::BlocksInflated);
+    }
+
+    // Reads the block with the given z-length from the current stream position and decodes it
+    // into output, whose size is the block's expected plain size
+    void ReadBlock(uint16_t z_len, std::istream& stream, std::span<uint8_t> output) const
+    {
+        PSARC_TRACE_SCOPE("ReadBlock");
+        if (z_len == 0)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            stream.read(reinterpret_cast<char*>(output.data()),
+                        static_cast<std::streamsize>(output.size()));
+            if (std::cmp_not_equal(stream.gcount(), output.size()))
+            {
+                throw PsarcException("Failed to read uncompressed block");
+            }
+            CountBlock(output.size(), 0, output.size());
+            return;
+        }
+
+        auto& chunk = GetBlockScratch().chunk;
+        m_stats.Resize(chunk, z_len);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        stream.read(reinterpret_cast<char*>(chunk.data()), z_len);
+        if (std::cmp_not_equal(stream.gcount(), z_len))
+        {
+            throw PsarcException("Failed to read compressed chunk");
+        }
+
+        const size_t produced = DecompressBlock(chunk, output);
+        if (produced == output.size())
+        {
+            CountBlock(z_len, z_len, output.size());
+            return;
+        }
+
+        // Blocks that do not shrink are stored raw with their plain length
+        if (produced == 0 && z_len == output.size())
+        {
+            std::ranges::copy(chunk, output.begin());
+            CountBlock(z_len, 0, output.size());
+            return;
         }
 
-        return {};
+        throw PsarcException(std::format("Block decompressed to {} bytes, expected {}", produced,
+                                         output.size()));
     }
 
     [[nodiscard]] std::vector<uint8_t> ExtractFileByIndex(int index)
+    {
+        return ExtractFileByIndex(index, *m_file);
+    }
+
+    // Reads through the given stream so callers on other threads can use their own handle
+    [[nodiscard]] std::vector<uint8_t> ExtractFileByIndex(
+        int index, std::istream& stream, OperationMonitor::Task* task = nullptr) const
+    {
+        std::vector<uint8_t> result;
+        ExtractFileByIndex(index, stream, result, task);
+        return result;
+    }
+
+    // Decompresses straight into output, reusing its capacity across calls. Blocks go through
+    // cache when one is given; bulk operations pass none so they don't flush it.
+    void ExtractFileByIndex(int index, std::istream& stream, std::vector<uint8_t>& output,
+                            OperationMonitor::Task* task = nullptr,
+                            PsarcBlockCache* cache = nullptr) const
+    {
+        const auto& entry = GetEntryByIndex(index);
+        PSARC_TRACE_SCOPE_DETAIL("ExtractEntry", entry.name);
+
+        m_stats.Resize(output, static_cast<size_t>(entry.uncompressed_size));
+        if (cache)
+        {
+            ReadCachedBlocks(entry, stream, *cache, output);
+        }
+        else
+        {
+            ForEachBlock(entry, stream, task, [&](uint16_t z_len, uint64_t offset, size_t size) {
+                ReadBlock(z_len, stream, std::span(output).subspan(offset, size));
+            });
+        }
+
+        if (IsSngFile(entry.name) && !output.empty())
+        {
+            m_stats.Add(StatsCollector::Counter::BytesDecrypted, output.size());
+            DecryptSng(output);
+        }
+    }
+
+    // Copies cached blocks and reads only the others, seeking past the stored data of the hits
+    void ReadCachedBlocks(const FileEntry& entry, std::istream& stream, PsarcBlockCache& cache,
+                          std::span<uint8_t> output) const
+    {
+        uint64_t position = entry.offset;
+        bool positioned = true;
+        ForEachBlock(entry, stream, nullptr, [&](uint16_t z_len, uint64_t offset, size_t size) {
+            const auto chunk =
+                entry.start_chunk_index + static_cast<uint32_t>(offset / m_header.block_size);
+            const auto block = output.subspan(offset, size);
+            if (const auto cached = cache.Find(m_archive_id, chunk);
+                cached && cached->size() == size)
+            {
+                std::ranges::copy(*cached, block.begin());
+                positioned = false;
+            }
+            else
+            {
+                if (!positioned)
+                {
+                    stream.seekg(static_cast<std::streamoff>(position));
+                    positioned = true;
+                }
+                ReadBlock(z_len, stream, block);
+                cache.Insert(m_archive_id, chunk, block);
+            }
+            position += z_len == 0 ? size : z_len;
+        });
+    }
+
+    // Writes an entry to disk a block at a time; only SNGs, which must be decrypted as a whole,
+    // are buffered in memory
+    void ExtractFileByIndexTo(int index, std::istream& stream, const fs::path& path,
+                              OperationMonitor::Task* task = nullptr) const
+    {
+        const auto& entry = GetEntryByIndex(index);
+        if (IsSngFile(entry.name))
+        {
+            WriteOutput(path, ExtractFileByIndex(index, stream, task));
+            return;
+        }
+
+        PSARC_TRACE_SCOPE_DETAIL("ExtractEntry", entry.name);
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out)
+        {
+            throw PsarcException(std::format("Failed to create file: {}", path.string()));
+        }
+
+        auto& block = GetBlockScratch().block;
+        ForEachBlock(entry, stream, task, [&](uint16_t z_len, uint64_t /*offset*/, size_t size) {
+            m_stats.Resize(block, size);
+            ReadBlock(z_len, stream, block);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            out.write(reinterpret_cast<const char*>(block.data()),
+                      static_cast<std::streamsize>(block.size()));
+        });
+
+        if (!out.good())
+        {
+            throw PsarcException(std::format("Failed to write file: {}", path.string()));
+        }
+        CountOutput(entry.uncompressed_size);
+    }
+
+    void CountOutput(uint64_t size) const
+    {
+        m_stats.Add(StatsCollector::Counter::FilesWritten);
+        m_stats.Add(StatsCollector::Counter::BytesWritten, size);
+    }
+
+    template <typename Container>
+    void WriteOutput(const fs::path& path, const Container& data) const
+    {
+        WriteFile(path, data);
+        CountOutput(data.size());
+    }
+
+    [[nodiscard]] const FileEntry& GetEntryByIndex(int index) const
     {
         if (index < 0 || std::cmp_greater_equal(index, m_entries.size()))
         {
             throw PsarcException(std::format("Invalid entry index: {}", index));
         }
+        return m_entries[index];
+    }
 
-        const auto& entry = m_entries[index];
+    // Seeks to an entry's data and calls visit(z_length, plain_offset, plain_size) for each of its
+    // blocks in order; visit must consume the block from the stream. The optional task is polled
+    // for cancellation before each block and credited after it.
+    template <typename Visitor>
+    void ForEachBlock(const FileEntry& entry, std::istream& stream, OperationMonitor::Task* task,
+                      Visitor&& visit) const
+    {
         if (entry.uncompressed_size == 0)
         {
-            return {};
+            return;
         }
 
-        std::vector<uint8_t> result;
-        result.reserve(static_cast<size_t>(entry.uncompressed_size));
-        m_file->seekg(static_cast<std::streamoff>(entry.offset));
+        const uint32_t chunk_count = GetChunkCount(entry.uncompressed_size, m_header.block_size);
+        if (static_cast<uint64_t>(entry.start_chunk_index) + chunk_count > m_z_lengths.size())
+        {
+            throw PsarcException("Chunk index out of range");
+        }
 
-        uint32_t z_index = entry.start_chunk_index;
+        stream.seekg(static_cast<std::streamoff>(entry.offset));
 
-        while (result.size() < entry.uncompressed_size)
+        uint64_t offset = 0;
+        for (uint32_t i = 0; i < chunk_count; ++i)
         {
-            if (z_index >= m_z_lengths.size())
+            const auto size = static_cast<size_t>(
+                std::min<uint64_t>(m_header.block_size, entry.uncompressed_size - offset));
+            if (task)
             {
-                throw PsarcException("Chunk index out of range");
+                task->ThrowIfCancelled();
+            }
+            visit(m_z_lengths[entry.start_chunk_index + i], offset, size);
+            offset += size;
+            if (task)
+            {
+                task->AddBytes(size);
             }
+        }
+    }
+
+    // Throws on the first inconsistency between the TOC and an entry's stored blocks
+    void VerifyEntry(const FileEntry& entry, std::istream& stream, uint64_t archive_size,
+                     OperationMonitor::Task* task) const
+    {
+        PSARC_TRACE_SCOPE_DETAIL("VerifyEntry", entry.name);
+        const uint64_t stored_size = GetCompressedSize(entry);
+        if (entry.offset + stored_size > archive_size)
+        {
+            throw PsarcException(
+                std::format("data at offset {} ({} bytes) extends past the end of the archive",
+                            entry.offset, stored_size));
+        }
+
+        uint64_t offset = entry.offset;
+        uint64_t remaining = entry.uncompressed_size;
+        const uint32_t chunk_count = GetChunkCount(entry.uncompressed_size, m_header.block_size);
 
-            const uint16_t z_len = m_z_lengths[z_index++];
+        for (uint32_t i = 0; i < chunk_count; ++i)
+        {
+            const uint16_t z_len = m_z_lengths[entry.start_chunk_index + i];
+            const uint64_t expected_size =
+                std::min(remaining, static_cast<uint64_t>(m_header.block_size));
+            if (task)
+            {
+                task->ThrowIfCancelled();
+            }
 
+            // Stored raw, like extraction reads it; a final partial block holds just the rest
             if (z_len == 0)
             {
-                std::vector<uint8_t> block(m_header.block_size);
-                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-                m_file->read(reinterpret_cast<char*>(block.data()),
-                             static_cast<std::streamsize>(m_header.block_size));
-                const auto bytes_read = static_cast<size_t>(m_file->gcount());
-                if (bytes_read == 0 && !m_file->eof())
-                {
-                    throw PsarcException("Failed to read uncompressed block");
-                }
-                block.resize(bytes_read);
-                result.insert(result.end(), block.begin(), block.end());
+                offset += expected_size;
             }
             else
             {
-                std::vector<uint8_t> chunk(z_len);
-                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-                m_file->read(reinterpret_cast<char*>(chunk.data()), z_len);
-                if (std::cmp_not_equal(m_file->gcount(), z_len))
-                {
-                    throw PsarcException("Failed to read compressed chunk");
-                }
-
-                const uint64_t remaining = entry.uncompressed_size - result.size();
-                const uint64_t expected_size =
-                    std::min(remaining, static_cast<uint64_t>(m_header.block_size));
+                const auto chunk = ReadAt(stream, offset, z_len);
+                auto& block = GetBlockScratch().block;
+                m_stats.Resize(block, static_cast<size_t>(expected_size));
+                const size_t produced = DecompressBlock(chunk, block);
 
-                std::vector<uint8_t> decompressed;
-                const std::string_view compression(m_header.compression_method.data(),
-                                                   m_header.compression_method.size());
-
-                if (compression == "zlib")
-                {
-                    decompressed = DecompressZlib(chunk, expected_size);
-                }
-                else if (compression == "lzma")
-                {
-                    decompressed = DecompressLzma(chunk, expected_size);
-                }
-                else
+                // Blocks that do not shrink are stored raw with their plain length
+                if (produced == 0 && z_len != expected_size)
                 {
-                    // Try zlib first, then lzma as fallback
-                    decompressed = DecompressZlib(chunk, expected_size);
-                    if (decompressed.empty())
-                    {
-                        decompressed = DecompressLzma(chunk, expected_size);
-                    }
+                    throw PsarcException(std::format("block {} failed to decompress", i));
                 }
-
-                if (!decompressed.empty())
+                if (produced != 0 && produced != expected_size)
                 {
-                    result.insert(result.end(), decompressed.begin(), decompressed.end());
+                    throw PsarcException(
+                        std::format("block {} decompressed to {} bytes, expected {}", i, produced,
+                                    expected_size));
                 }
-                else
+                m_stats.Add(StatsCollector::Counter::UncompressedBytes, expected_size);
+                m_stats.Add(produced == 0 ? StatsCollector::Counter::BlocksStored
+                                          : StatsCollector::Counter::BlocksInflated);
+                if (produced != 0)
                 {
-                    result.insert(result.end(), chunk.begin(), chunk.end());
+                    m_stats.Add(StatsCollector::Counter::CompressedBytes, z_len);
                 }
+                offset += z_len;
+            }
+            remaining -= expected_size;
+            if (task)
+            {
+                task->AddBytes(expected_size);
             }
         }
-
-        result.resize(std::min(result.size(), static_cast<size_t>(entry.uncompressed_size)));
-
-        if (entry.name.find("songs/bin/generic/") != std::string::npos &&
-            entry.name.ends_with(".sng"))
-        {
-            result = DecryptSng(result);
-        }
-
-        return result;
     }
 
-    std::string m_file_path;
-    std::unique_ptr<std::ifstream> m_file;
+    std::string m_file_path; // Display name for archives opened from a caller's source
+    std::shared_ptr<PsarcByteSource> m_source;
+    bool m_external_source = false;
+    std::unique_ptr<ByteSourceStream> m_file;
+    std::shared_ptr<PsarcBlockCache> m_block_cache;
+    uint64_t m_archive_id = 0; // Key of this opening in m_block_cache
+    mutable std::mutex m_stream_mutex;
+    mutable std::vector<std::unique_ptr<ByteSourceStream>> m_idle_streams; // See StreamLease
     Header m_header{};
     std::vector<FileEntry> m_entries;
+    std::vector<PsarcEntryView> m_entry_views; // Named entries, into m_entries
     std::vector<uint16_t> m_z_lengths;
     std::unordered_map<std::string, int> m_file_map;
+    uint64_t m_archive_size = 0;
     bool m_is_open = false;
+    mutable StatsCollector m_stats;
 };
 
 // ─── PsarcFile public wrappers ────────────────────────────────────────────────
@@ -1147,6 +2804,11 @@ PsarcFile::PsarcFile(std::string file_path) : m_impl(std::make_unique<Impl>(std:
 {
 }
 
+PsarcFile::PsarcFile(std::shared_ptr<PsarcByteSource> source, std::string name)
+    : m_impl(std::make_unique<Impl>(std::move(source), std::move(name)))
+{
+}
+
 PsarcFile::~PsarcFile() = default;
 PsarcFile::PsarcFile(PsarcFile&&) noexcept = default;
 PsarcFile& PsarcFile::operator=(PsarcFile&&) noexcept = default;
@@ -1166,6 +2828,11 @@ bool PsarcFile::IsOpen() const
     return m_impl->IsOpen();
 }
 
+void PsarcFile::SetBlockCache(std::shared_ptr<PsarcBlockCache> cache)
+{
+    m_impl->SetBlockCache(std::move(cache));
+}
+
 int PsarcFile::GetFileCount() const
 {
     return m_impl->GetFileCount();
@@ -1186,27 +2853,123 @@ uint64_t PsarcFile::GetFileSize(const std::string& file_name) const
     return m_impl->GetFileSize(file_name);
 }
 
-std::vector<uint8_t> PsarcFile::ExtractFile(const std::string& file_name)
+std::span<const PsarcEntryView> PsarcFile::GetEntries() const
+{
+    return m_impl->GetEntries();
+}
+
+PsarcEntryView PsarcFile::GetEntry(int index) const
+{
+    return m_impl->GetEntry(index);
+}
+
+PsarcEntryInfo PsarcFile::GetEntryInfo(int index) const
+{
+    return m_impl->GetEntryInfo(index);
+}
+
+PsarcEntryInfo PsarcFile::GetEntryInfo(const std::string& file_name) const
+{
+    return m_impl->GetEntryInfo(file_name);
+}
+
+std::vector<PsarcEntryInfo> PsarcFile::GetEntryInfoList() const
+{
+    return m_impl->GetEntryInfoList();
+}
+
+std::vector<uint8_t> PsarcFile::ExtractFile(const std::string& file_name) const
 {
     return m_impl->ExtractFile(file_name);
 }
 
-void PsarcFile::ExtractFileTo(const std::string& file_name, const std::string& output_path)
+void PsarcFile::ExtractFile(const std::string& file_name, std::vector<uint8_t>& output) const
+{
+    m_impl->ExtractFile(file_name, output);
+}
+
+void PsarcFile::Prefetch(const std::vector<std::string>& names) const
+{
+    m_impl->Prefetch(names);
+}
+
+void PsarcFile::ExtractFileTo(const std::string& file_name,
+                              const std::string& output_path) const
 {
     m_impl->ExtractFileTo(file_name, output_path);
 }
 
 void PsarcFile::ExtractAll(const std::string& output_directory)
 {
-    m_impl->ExtractAll(output_directory);
+    ThrowIfFailed(m_impl->ExtractAll(output_directory, {}), "extract", "file");
 }
 
 void PsarcFile::ConvertAudio(const std::string& output_directory)
 {
-    m_impl->ConvertAudio(output_directory);
+    ThrowIfFailed(m_impl->ConvertAudio(output_directory, {}), "convert", "audio file");
 }
 
 void PsarcFile::ConvertSng(const std::string& output_directory)
 {
-    m_impl->ConvertSng(output_directory);
+    ThrowIfFailed(m_impl->ConvertSng(output_directory, {}), "convert", "SNG file");
+}
+
+PsarcReport PsarcFile::ExtractAll(const std::string& output_directory,
+                                  const PsarcOptions& options)
+{
+    return m_impl->ExtractAll(output_directory, options);
+}
+
+PsarcReport PsarcFile::ConvertAudio(const std::string& output_directory,
+                                    const PsarcOptions& options)
+{
+    return m_impl->ConvertAudio(output_directory, options);
+}
+
+PsarcReport PsarcFile::ConvertSng(const std::string& output_directory,
+                                  const PsarcOptions& options)
+{
+    return m_impl->ConvertSng(output_directory, options);
+}
+
+void PsarcFile::ReplaceFile(const std::string& file_name, std::span<const uint8_t> data)
+{
+    m_impl->ReplaceFile(file_name, data);
+}
+
+void PsarcFile::Compact()
+{
+    m_impl->Compact();
+}
+
+uint64_t PsarcFile::GetMemoryUsage() const
+{
+    return m_impl->GetMemoryUsage();
+}
+
+PsarcArchiveInfo PsarcFile::GetArchiveInfo(size_t largest_entry_count) const
+{
+    return m_impl->GetArchiveInfo(largest_entry_count);
+}
+
+std::vector<std::string> PsarcFile::Verify() const
+{
+    PsarcOptions options;
+    options.thread_count = 0;
+    return m_impl->Verify(options);
+}
+
+std::vector<std::string> PsarcFile::Verify(const PsarcOptions& options) const
+{
+    return m_impl->Verify(options);
+}
+
+PsarcStats PsarcFile::GetStats() const
+{
+    return m_impl->GetStats();
+}
+
+void PsarcFile::ResetStats()
+{
+    m_impl->ResetStats();
 }
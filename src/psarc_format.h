@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+inline constexpr std::array<uint8_t, 32> g_psarc_key = {
+    0xC5, 0x3D, 0xB2, 0x38, 0x70, 0xA1, 0xA2, 0xF7, 0x1C, 0xAE, 0x64, 0x06, 0x1F, 0xDD, 0x0E, 0x11,
+    0x57, 0x30, 0x9D, 0xC8, 0x52, 0x04, 0xD4, 0xC5, 0xBF, 0xDF, 0x25, 0x09, 0x0D, 0xF2, 0x57, 0x2C};
+
+inline constexpr std::array<uint8_t, 16> g_psarc_iv = {
+    0xE9, 0x15, 0xAA, 0x01, 0x8F, 0xEF, 0x71, 0xFC, 0x50, 0x81, 0x32, 0xE4, 0xBB, 0x4C, 0xEB, 0x42};
+
+inline constexpr std::array<uint8_t, 32> g_sng_key = {
+    0xCB, 0x64, 0x8D, 0xF3, 0xD1, 0x2A, 0x16, 0xBF, 0x71, 0x70, 0x14, 0x14, 0xE6, 0x96, 0x19, 0xEC,
+    0x17, 0x1C, 0xCA, 0x5D, 0x2A, 0x14, 0x2E, 0x3E, 0x59, 0xDE, 0x7A, 0xDD, 0xA1, 0x8A, 0x3A, 0x30};
+
+inline constexpr uint32_t g_psarc_magic = 0x50534152;
+inline constexpr uint32_t g_psarc_header_size = 32;
+// Compressed lengths are 16-bit, so larger blocks could not always be described
+inline constexpr uint32_t g_max_block_size = 65536;
+// Deflate cannot expand its input by more than about 1032:1
+inline constexpr uint64_t g_max_deflate_ratio = 1032;
+inline constexpr uint32_t g_sng_magic = 0x4A;
+inline constexpr uint32_t g_toc_encrypted_flag = 0x04;
+inline constexpr uint32_t g_sng_compressed_flag = 0x01;
+
+[[nodiscard]] constexpr uint16_t ReadLE16(const uint8_t* data) noexcept
+{
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+[[nodiscard]] constexpr uint32_t ReadLE32(const uint8_t* data) noexcept
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
+}
+
+[[nodiscard]] constexpr uint64_t ReadLE64(const uint8_t* data) noexcept
+{
+    return ReadLE32(data) | (static_cast<uint64_t>(ReadLE32(data + 4)) << 32);
+}
+
+[[nodiscard]] constexpr uint16_t ReadBE16(const uint8_t* data) noexcept
+{
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+[[nodiscard]] constexpr uint32_t ReadBE32(const uint8_t* data) noexcept
+{
+    return (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+}
+
+[[nodiscard]] constexpr uint64_t ReadBE64(const uint8_t* data) noexcept
+{
+    return (static_cast<uint64_t>(ReadBE32(data)) << 32) | ReadBE32(data + 4);
+}
+
+constexpr void WriteLE32(uint8_t* data, uint32_t value) noexcept
+{
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+    data[2] = static_cast<uint8_t>(value >> 16);
+    data[3] = static_cast<uint8_t>(value >> 24);
+}
+
+constexpr void WriteLE64(uint8_t* data, uint64_t value) noexcept
+{
+    WriteLE32(data, static_cast<uint32_t>(value));
+    WriteLE32(data + 4, static_cast<uint32_t>(value >> 32));
+}
+
+constexpr void WriteBE16(uint8_t* data, uint16_t value) noexcept
+{
+    data[0] = static_cast<uint8_t>(value >> 8);
+    data[1] = static_cast<uint8_t>(value);
+}
+
+constexpr void WriteBE32(uint8_t* data, uint32_t value) noexcept
+{
+    data[0] = static_cast<uint8_t>(value >> 24);
+    data[1] = static_cast<uint8_t>(value >> 16);
+    data[2] = static_cast<uint8_t>(value >> 8);
+    data[3] = static_cast<uint8_t>(value);
+}
+
+constexpr void WriteBE64(uint8_t* data, uint64_t value) noexcept
+{
+    WriteBE32(data, static_cast<uint32_t>(value >> 32));
+    WriteBE32(data + 4, static_cast<uint32_t>(value));
+}
@@ -0,0 +1,216 @@
+#include "psarc_writer.h"
+
+#include "open-psarc/psarc_file.h"
+#include "psarc_format.h"
+
+#include <algorithm>
+#include <format>
+#include <limits>
+#include <string_view>
+
+#include <lzma.h>
+#include <openssl/evp.h>
+#include <zlib.h>
+
+namespace
+{
+
+std::vector<uint8_t> CompressLzma(std::span<const uint8_t> data)
+{
+    lzma_options_lzma options{};
+    if (lzma_lzma_preset(&options, LZMA_PRESET_DEFAULT))
+    {
+        throw PsarcException("Failed to initialize LZMA preset");
+    }
+
+    lzma_stream strm = LZMA_STREAM_INIT;
+    if (lzma_alone_encoder(&strm, &options) != LZMA_OK)
+    {
+        throw PsarcException("Failed to initialize LZMA encoder");
+    }
+
+    // .lzma header (13 bytes) plus worst-case expansion of incompressible input
+    std::vector<uint8_t> result(data.size() + data.size() / 2 + 64);
+    strm.next_in = data.data();
+    strm.avail_in = data.size();
+    strm.next_out = result.data();
+    strm.avail_out = result.size();
+
+    const lzma_ret ret = lzma_code(&strm, LZMA_FINISH);
+    const size_t written = result.size() - strm.avail_out;
+    lzma_end(&strm);
+
+    if (ret != LZMA_STREAM_END)
+    {
+        throw PsarcException("Failed to compress block with LZMA");
+    }
+
+    result.resize(written);
+    return result;
+}
+
+std::vector<uint8_t> EncryptToc(std::span<const uint8_t> data)
+{
+    if (data.empty())
+    {
+        return {};
+    }
+
+    std::vector<uint8_t> output(data.size());
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx)
+    {
+        throw PsarcException("Failed to create cipher context");
+    }
+
+    int len = 0;
+    bool success = EVP_EncryptInit_ex(ctx, EVP_aes_256_cfb128(), nullptr, g_psarc_key.data(),
+                                      g_psarc_iv.data()) == 1;
+    if (success)
+    {
+        EVP_CIPHER_CTX_set_padding(ctx, 0);
+        success = EVP_EncryptUpdate(ctx, output.data(), &len, data.data(),
+                                    static_cast<int>(data.size())) == 1;
+    }
+
+    EVP_CIPHER_CTX_free(ctx);
+
+    if (!success)
+    {
+        throw PsarcException("Failed to encrypt TOC");
+    }
+
+    return output;
+}
+
+void WriteBigEndianN(std::vector<uint8_t>& out, uint64_t value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; --i)
+    {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+} // namespace
+
+std::vector<uint8_t> PsarcWriter::CompressZlib(std::span<const uint8_t> data)
+{
+    uLongf size = compressBound(static_cast<uLong>(data.size()));
+    std::vector<uint8_t> result(size);
+    if (compress2(result.data(), &size, data.data(), static_cast<uLong>(data.size()),
+                  Z_BEST_COMPRESSION) != Z_OK)
+    {
+        throw PsarcException("Failed to compress data with zlib");
+    }
+    result.resize(size);
+    return result;
+}
+
+std::vector<uint8_t> PsarcWriter::CompressBlocks(std::span<const uint8_t> data,
+                                                 uint32_t block_size,
+                                                 std::array<char, 4> compression_method,
+                                                 std::vector<uint16_t>& z_lengths)
+{
+    if (block_size == 0 || block_size > g_max_block_size)
+    {
+        throw PsarcException(std::format("Unsupported block size: {}", block_size));
+    }
+
+    const std::string_view compression(compression_method.data(), compression_method.size());
+    const bool use_lzma = compression == "lzma";
+
+    std::vector<uint8_t> result;
+    result.reserve(data.size());
+
+    for (size_t pos = 0; pos < data.size(); pos += block_size)
+    {
+        const auto block = data.subspan(pos, std::min<size_t>(block_size, data.size() - pos));
+        const auto compressed = use_lzma ? CompressLzma(block) : CompressZlib(block);
+
+        // A z-length of 0 means a full stored block, so only full blocks can fall back to raw
+        // storage without the reader attempting to decompress them
+        if (compressed.size() <= std::numeric_limits<uint16_t>::max())
+        {
+            z_lengths.push_back(static_cast<uint16_t>(compressed.size()));
+            result.insert(result.end(), compressed.begin(), compressed.end());
+        }
+        else if (block.size() == block_size)
+        {
+            z_lengths.push_back(0);
+            result.insert(result.end(), block.begin(), block.end());
+        }
+        else
+        {
+            z_lengths.push_back(static_cast<uint16_t>(block.size()));
+            result.insert(result.end(), block.begin(), block.end());
+        }
+    }
+
+    return result;
+}
+
+uint64_t PsarcWriter::GetTocLength(const PsarcTocLayout& layout)
+{
+    return g_psarc_header_size +
+           (static_cast<uint64_t>(layout.entries.size()) * layout.toc_entry_size) +
+           (static_cast<uint64_t>(layout.z_lengths.size()) * 2);
+}
+
+std::vector<uint8_t> PsarcWriter::EncodeHeaderAndToc(const PsarcTocLayout& layout)
+{
+    const int b_num = (static_cast<int>(layout.toc_entry_size) - 20) / 2;
+    if (b_num < 1 || b_num > 8 || layout.toc_entry_size != static_cast<uint32_t>(20 + (b_num * 2)))
+    {
+        throw PsarcException("Invalid TOC entry size");
+    }
+
+    const uint64_t toc_length = GetTocLength(layout);
+    if (toc_length > std::numeric_limits<uint32_t>::max())
+    {
+        throw PsarcException("TOC too large");
+    }
+
+    const uint64_t max_value = b_num == 8 ? std::numeric_limits<uint64_t>::max()
+                                          : (uint64_t{1} << (b_num * 8)) - 1;
+
+    std::vector<uint8_t> toc;
+    toc.reserve(static_cast<size_t>(toc_length - g_psarc_header_size));
+
+    for (const auto& entry : layout.entries)
+    {
+        if (entry.uncompressed_size > max_value || entry.offset > max_value)
+        {
+            throw PsarcException("Entry size or offset does not fit the TOC entry size");
+        }
+
+        toc.insert(toc.end(), entry.md5.begin(), entry.md5.end());
+        WriteBigEndianN(toc, entry.start_chunk_index, 4);
+        WriteBigEndianN(toc, entry.uncompressed_size, b_num);
+        WriteBigEndianN(toc, entry.offset, b_num);
+    }
+
+    for (const uint16_t z_len : layout.z_lengths)
+    {
+        WriteBigEndianN(toc, z_len, 2);
+    }
+
+    if ((layout.archive_flags & g_toc_encrypted_flag) != 0)
+    {
+        toc = EncryptToc(toc);
+    }
+
+    std::vector<uint8_t> result(g_psarc_header_size);
+    WriteBE32(result.data(), g_psarc_magic);
+    WriteBE16(result.data() + 4, 1);
+    WriteBE16(result.data() + 6, 4);
+    std::ranges::copy(layout.compression_method, result.begin() + 8);
+    WriteBE32(result.data() + 12, static_cast<uint32_t>(toc_length));
+    WriteBE32(result.data() + 16, layout.toc_entry_size);
+    WriteBE32(result.data() + 20, static_cast<uint32_t>(layout.entries.size()));
+    WriteBE32(result.data() + 24, layout.block_size);
+    WriteBE32(result.data() + 28, layout.archive_flags);
+
+    result.insert(result.end(), toc.begin(), toc.end());
+    return result;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct PsarcTocEntry
+{
+    std::array<uint8_t, 16> md5{};
+    uint32_t start_chunk_index = 0;
+    uint64_t uncompressed_size = 0;
+    uint64_t offset = 0;
+};
+
+struct PsarcTocLayout
+{
+    std::array<char, 4> compression_method = {'z', 'l', 'i', 'b'};
+    uint32_t toc_entry_size = 30;
+    uint32_t block_size = 65536;
+    uint32_t archive_flags = 0;
+    std::vector<PsarcTocEntry> entries;
+    std::vector<uint16_t> z_lengths;
+};
+
+class PsarcWriter
+{
+public:
+    // Deflates data into a zlib stream at the best compression level
+    [[nodiscard]] static std::vector<uint8_t> CompressZlib(std::span<const uint8_t> data);
+
+    // Splits data into block_size blocks and compresses each one with the given method ("zlib" or
+    // "lzma"), appending one z-length per block. Blocks that do not fit a 16-bit z-length are
+    // stored uncompressed.
+    [[nodiscard]] static std::vector<uint8_t> CompressBlocks(std::span<const uint8_t> data,
+                                                             uint32_t block_size,
+                                                             std::array<char, 4> compression_method,
+                                                             std::vector<uint16_t>& z_lengths);
+
+    [[nodiscard]] static uint64_t GetTocLength(const PsarcTocLayout& layout);
+
+    // Serializes the 32-byte header followed by the TOC, encrypting the TOC when the layout has
+    // the encrypted flag set. The result is exactly GetTocLength(layout) bytes.
+    [[nodiscard]] static std::vector<uint8_t> EncodeHeaderAndToc(const PsarcTocLayout& layout);
+};
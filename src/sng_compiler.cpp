@@ -0,0 +1,32 @@
+#include "open-psarc/sng_compiler.h"
+
+#include "open-psarc/psarc_file.h"
+#include "sng_writer.h"
+#include "sng_xml_reader.h"
+
+#include <format>
+#include <fstream>
+
+std::vector<uint8_t> SngCompiler::Compile(const std::string& xml_path)
+{
+    return SngWriter::Encode(SngXmlReader::Read(xml_path));
+}
+
+void SngCompiler::CompileTo(const std::string& xml_path, const std::string& sng_path)
+{
+    const auto sng = Compile(xml_path);
+
+    std::ofstream out(sng_path, std::ios::binary);
+    if (!out)
+    {
+        throw PsarcException(std::format("Failed to create output file: {}", sng_path));
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    out.write(reinterpret_cast<const char*>(sng.data()), static_cast<std::streamsize>(sng.size()));
+
+    if (!out.good())
+    {
+        throw PsarcException(std::format("Failed to write file: {}", sng_path));
+    }
+}
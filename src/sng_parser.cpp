@@ -1,17 +1,21 @@
 #include "sng_parser.h"
 
 #include "open-psarc/psarc_file.h"
+#include "trace.h"
 
 #include <cstring>
 #include <format>
+#include <utility>
 
 namespace
 {
 
-class BinaryReader
+// Little-endian reader over SNG data. The checked reader validates every read; record readers skip
+// the per-field checks and only ever cover ranges whose size was validated up front.
+template <bool Checked> class BasicReader
 {
 public:
-    explicit BinaryReader(std::span<const uint8_t> data) : m_data(data)
+    explicit BasicReader(std::span<const uint8_t> data) : m_data(data)
     {
     }
 
@@ -27,7 +31,7 @@ public:
 
     [[nodiscard]] float ReadFloat()
     {
-        EnsureAvailable(4);
+        Check(4);
         float value = 0;
         std::memcpy(&value, m_data.data() + m_pos, 4);
         m_pos += 4;
@@ -36,7 +40,7 @@ public:
 
     [[nodiscard]] double ReadDouble()
     {
-        EnsureAvailable(8);
+        Check(8);
         double value = 0;
         std::memcpy(&value, m_data.data() + m_pos, 8);
         m_pos += 8;
@@ -45,7 +49,7 @@ public:
 
     [[nodiscard]] int8_t ReadInt8()
     {
-        EnsureAvailable(1);
+        Check(1);
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
         auto value = static_cast<int8_t>(m_data[m_pos]);
         m_pos += 1;
@@ -54,7 +58,7 @@ public:
 
     [[nodiscard]] uint8_t ReadUInt8()
     {
-        EnsureAvailable(1);
+        Check(1);
         uint8_t value = m_data[m_pos];
         m_pos += 1;
         return value;
@@ -62,7 +66,7 @@ public:
 
     [[nodiscard]] int16_t ReadInt16()
     {
-        EnsureAvailable(2);
+        Check(2);
         auto raw = static_cast<uint16_t>(m_data[m_pos] | (m_data[m_pos + 1] << 8));
         m_pos += 2;
         return static_cast<int16_t>(raw);
@@ -70,7 +74,7 @@ public:
 
     [[nodiscard]] uint16_t ReadUInt16()
     {
-        EnsureAvailable(2);
+        Check(2);
         auto value = static_cast<uint16_t>(m_data[m_pos] | (m_data[m_pos + 1] << 8));
         m_pos += 2;
         return value;
@@ -78,7 +82,7 @@ public:
 
     [[nodiscard]] int32_t ReadInt32()
     {
-        EnsureAvailable(4);
+        Check(4);
         uint32_t raw = m_data[m_pos] | (m_data[m_pos + 1] << 8) | (m_data[m_pos + 2] << 16) |
                        (m_data[m_pos + 3] << 24);
         m_pos += 4;
@@ -87,7 +91,7 @@ public:
 
     [[nodiscard]] uint32_t ReadUInt32()
     {
-        EnsureAvailable(4);
+        Check(4);
         uint32_t value = m_data[m_pos] | (m_data[m_pos + 1] << 8) | (m_data[m_pos + 2] << 16) |
                          (m_data[m_pos + 3] << 24);
         m_pos += 4;
@@ -96,7 +100,7 @@ public:
 
     [[nodiscard]] std::string ReadFixedString(size_t size)
     {
-        EnsureAvailable(size);
+        Check(size);
         // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
         const auto* start = reinterpret_cast<const char*>(m_data.data() + m_pos);
         m_pos += size;
@@ -110,6 +114,39 @@ public:
         return {start, len};
     }
 
+    // Reads an element count, rejecting it unless that many records of at least min_record_size
+    // bytes fit in the rest of the buffer, so a corrupt count fails before anything is allocated
+    [[nodiscard]] size_t ReadCount(size_t min_record_size)
+        requires Checked
+    {
+        const int32_t count = ReadInt32();
+        if (count < 0 || static_cast<uint64_t>(count) * min_record_size > Remaining())
+        {
+            throw PsarcException(std::format(
+                "SNG parse error: count {} at offset {} exceeds the {} bytes remaining", count,
+                m_pos - 4, Remaining()));
+        }
+        return static_cast<size_t>(count);
+    }
+
+    // Hands out a record reader over the next bytes, checked once here instead of per field
+    [[nodiscard]] BasicReader<false> Take(size_t bytes)
+        requires Checked
+    {
+        EnsureAvailable(bytes);
+        BasicReader<false> records(m_data.subspan(m_pos, bytes));
+        m_pos += bytes;
+        return records;
+    }
+
+    // Reads the count of a run of fixed-size records and takes all of them at once
+    [[nodiscard]] std::pair<size_t, BasicReader<false>> ReadRecords(size_t record_size)
+        requires Checked
+    {
+        const auto count = ReadCount(record_size);
+        return {count, Take(count * record_size)};
+    }
+
     void Skip(size_t bytes)
     {
         EnsureAvailable(bytes);
@@ -126,12 +163,28 @@ public:
         return m_data.size();
     }
 
+    [[nodiscard]] size_t Remaining() const
+    {
+        return m_data.size() - m_pos;
+    }
+
 private:
+    void Check(size_t bytes) const
+    {
+        if constexpr (Checked)
+        {
+            EnsureAvailable(bytes);
+        }
+    }
+
     std::span<const uint8_t> m_data;
     size_t m_pos = 0;
 };
 
-sng::BendValue ReadBendValue(BinaryReader& reader)
+using BinaryReader = BasicReader<true>;
+using RecordReader = BasicReader<false>;
+
+sng::BendValue ReadBendValue(RecordReader& reader)
 {
     sng::BendValue bv;
     bv.time = reader.ReadFloat();
@@ -145,15 +198,15 @@ sng::BendValue ReadBendValue(BinaryReader& reader)
 // Section 1: BPM
 std::vector<sng::Bpm> ReadBpms(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(16);
     std::vector<sng::Bpm> bpms(count);
     for (auto& bpm : bpms)
     {
-        bpm.time = reader.ReadFloat();
-        bpm.measure = reader.ReadInt16();
-        bpm.beat = reader.ReadInt16();
-        bpm.phrase_iteration = reader.ReadInt32();
-        bpm.mask = reader.ReadInt32();
+        bpm.time = records.ReadFloat();
+        bpm.measure = records.ReadInt16();
+        bpm.beat = records.ReadInt16();
+        bpm.phrase_iteration = records.ReadInt32();
+        bpm.mask = records.ReadInt32();
     }
     return bpms;
 }
@@ -161,17 +214,17 @@ std::vector<sng::Bpm> ReadBpms(BinaryReader& reader)
 // Section 2: Phrases
 std::vector<sng::Phrase> ReadPhrases(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(44);
     std::vector<sng::Phrase> phrases(count);
     for (auto& phrase : phrases)
     {
-        phrase.solo = reader.ReadUInt8();
-        phrase.disparity = reader.ReadUInt8();
-        phrase.ignore = reader.ReadUInt8();
-        phrase.padding = reader.ReadUInt8();
-        phrase.max_difficulty = reader.ReadInt32();
-        phrase.phrase_iteration_links = reader.ReadInt32();
-        phrase.name = reader.ReadFixedString(32);
+        phrase.solo = records.ReadUInt8();
+        phrase.disparity = records.ReadUInt8();
+        phrase.ignore = records.ReadUInt8();
+        phrase.padding = records.ReadUInt8();
+        phrase.max_difficulty = records.ReadInt32();
+        phrase.phrase_iteration_links = records.ReadInt32();
+        phrase.name = records.ReadFixedString(32);
     }
     return phrases;
 }
@@ -179,27 +232,27 @@ std::vector<sng::Phrase> ReadPhrases(BinaryReader& reader)
 // Section 3: Chords
 std::vector<sng::Chord> ReadChords(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(72);
     std::vector<sng::Chord> chords(count);
     for (auto& chord : chords)
     {
-        chord.mask = reader.ReadUInt32();
+        chord.mask = records.ReadUInt32();
         for (signed char& fret : chord.frets)
         {
             // Read as unsigned, map 0xFF to -1
-            uint8_t raw = reader.ReadUInt8();
+            uint8_t raw = records.ReadUInt8();
             fret = (raw == 0xFF) ? int8_t{-1} : static_cast<int8_t>(raw);
         }
         for (signed char& finger : chord.fingers)
         {
-            uint8_t raw = reader.ReadUInt8();
+            uint8_t raw = records.ReadUInt8();
             finger = (raw == 0xFF) ? int8_t{-1} : static_cast<int8_t>(raw);
         }
         for (int& note : chord.notes)
         {
-            note = reader.ReadInt32();
+            note = records.ReadInt32();
         }
-        chord.name = reader.ReadFixedString(32);
+        chord.name = records.ReadFixedString(32);
     }
     return chords;
 }
@@ -207,14 +260,14 @@ std::vector<sng::Chord> ReadChords(BinaryReader& reader)
 // Section 4: ChordNotes
 std::vector<sng::ChordNotes> ReadChordNotes(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(2376);
     std::vector<sng::ChordNotes> chord_notes(count);
     for (auto& cn : chord_notes)
     {
         // NoteMask per string
         for (auto& mask : cn.mask)
         {
-            mask = reader.ReadUInt32();
+            mask = records.ReadUInt32();
         }
         // BendData[6] - each has up to 32 BendValues + UsedCount
         for (auto& bd : cn.bend_data)
@@ -222,22 +275,27 @@ std::vector<sng::ChordNotes> ReadChordNotes(BinaryReader& reader)
             bd.bend_values.resize(32);
             for (auto& bv : bd.bend_values)
             {
-                bv = ReadBendValue(reader);
+                bv = ReadBendValue(records);
+            }
+            bd.used_count = records.ReadInt32();
+            if (bd.used_count < 0 || std::cmp_greater(bd.used_count, bd.bend_values.size()))
+            {
+                throw PsarcException(std::format(
+                    "SNG parse error: chord bend count {} out of range", bd.used_count));
             }
-            bd.used_count = reader.ReadInt32();
             bd.bend_values.resize(bd.used_count);
         }
         for (int8_t& i : cn.slide_to)
         {
-            i = reader.ReadInt8();
+            i = records.ReadInt8();
         }
         for (int8_t& i : cn.slide_unpitch_to)
         {
-            i = reader.ReadInt8();
+            i = records.ReadInt8();
         }
         for (short& i : cn.vibrato)
         {
-            i = reader.ReadInt16();
+            i = records.ReadInt16();
         }
     }
     return chord_notes;
@@ -246,14 +304,14 @@ std::vector<sng::ChordNotes> ReadChordNotes(BinaryReader& reader)
 // Section 5: Vocals
 std::vector<sng::Vocal> ReadVocals(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(60);
     std::vector<sng::Vocal> vocals(count);
     for (auto& vocal : vocals)
     {
-        vocal.time = reader.ReadFloat();
-        vocal.note = reader.ReadInt32();
-        vocal.length = reader.ReadFloat();
-        vocal.lyric = reader.ReadFixedString(48);
+        vocal.time = records.ReadFloat();
+        vocal.note = records.ReadInt32();
+        vocal.length = records.ReadFloat();
+        vocal.lyric = records.ReadFixedString(48);
     }
     return vocals;
 }
@@ -261,18 +319,18 @@ std::vector<sng::Vocal> ReadVocals(BinaryReader& reader)
 // Section 6: SymbolsHeaders
 std::vector<sng::SymbolsHeader> ReadSymbolsHeaders(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(32);
     std::vector<sng::SymbolsHeader> headers(count);
     for (auto& header : headers)
     {
-        header.unk1 = reader.ReadInt32();
-        header.unk2 = reader.ReadInt32();
-        header.unk3 = reader.ReadInt32();
-        header.unk4 = reader.ReadInt32();
-        header.unk5 = reader.ReadInt32();
-        header.unk6 = reader.ReadInt32();
-        header.unk7 = reader.ReadInt32();
-        header.unk8 = reader.ReadInt32();
+        header.unk1 = records.ReadInt32();
+        header.unk2 = records.ReadInt32();
+        header.unk3 = records.ReadInt32();
+        header.unk4 = records.ReadInt32();
+        header.unk5 = records.ReadInt32();
+        header.unk6 = records.ReadInt32();
+        header.unk7 = records.ReadInt32();
+        header.unk8 = records.ReadInt32();
     }
     return headers;
 }
@@ -280,15 +338,15 @@ std::vector<sng::SymbolsHeader> ReadSymbolsHeaders(BinaryReader& reader)
 // Section 7: SymbolsTextures
 std::vector<sng::SymbolsTexture> ReadSymbolsTextures(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(144);
     std::vector<sng::SymbolsTexture> textures(count);
     for (auto& texture : textures)
     {
-        texture.font_name = reader.ReadFixedString(128);
-        texture.font_path_length = reader.ReadInt32();
-        texture.unk = reader.ReadInt32();
-        texture.width = reader.ReadInt32();
-        texture.height = reader.ReadInt32();
+        texture.font_name = records.ReadFixedString(128);
+        texture.font_path_length = records.ReadInt32();
+        texture.unk = records.ReadInt32();
+        texture.width = records.ReadInt32();
+        texture.height = records.ReadInt32();
     }
     return textures;
 }
@@ -296,18 +354,18 @@ std::vector<sng::SymbolsTexture> ReadSymbolsTextures(BinaryReader& reader)
 // Section 8: SymbolDefinitions
 std::vector<sng::SymbolDefinition> ReadSymbolDefinitions(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(44);
     std::vector<sng::SymbolDefinition> definitions(count);
     for (auto& def : definitions)
     {
-        def.text = reader.ReadFixedString(12);
+        def.text = records.ReadFixedString(12);
         for (float& val : def.rect_outer)
         {
-            val = reader.ReadFloat();
+            val = records.ReadFloat();
         }
         for (float& val : def.rect_inner)
         {
-            val = reader.ReadFloat();
+            val = records.ReadFloat();
         }
     }
     return definitions;
@@ -316,16 +374,16 @@ std::vector<sng::SymbolDefinition> ReadSymbolDefinitions(BinaryReader& reader)
 // Section 9: PhraseIterations
 std::vector<sng::PhraseIteration> ReadPhraseIterations(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(24);
     std::vector<sng::PhraseIteration> iterations(count);
     for (auto& iter : iterations)
     {
-        iter.phrase_id = reader.ReadInt32();
-        iter.start_time = reader.ReadFloat();
-        iter.next_phrase_time = reader.ReadFloat();
+        iter.phrase_id = records.ReadInt32();
+        iter.start_time = records.ReadFloat();
+        iter.next_phrase_time = records.ReadFloat();
         for (int& diff : iter.difficulty)
         {
-            diff = reader.ReadInt32();
+            diff = records.ReadInt32();
         }
     }
     return iterations;
@@ -334,16 +392,16 @@ std::vector<sng::PhraseIteration> ReadPhraseIterations(BinaryReader& reader)
 // Section 10: PhraseExtraInfos
 std::vector<sng::PhraseExtraInfo> ReadPhraseExtraInfos(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(16);
     std::vector<sng::PhraseExtraInfo> infos(count);
     for (auto& info : infos)
     {
-        info.phrase_id = reader.ReadInt32();
-        info.difficulty = reader.ReadInt32();
-        info.empty = reader.ReadInt32();
-        info.level_jump = reader.ReadUInt8();
-        info.redundant = reader.ReadInt16();
-        info.padding = reader.ReadUInt8();
+        info.phrase_id = records.ReadInt32();
+        info.difficulty = records.ReadInt32();
+        info.empty = records.ReadInt32();
+        info.level_jump = records.ReadUInt8();
+        info.redundant = records.ReadInt16();
+        info.padding = records.ReadUInt8();
     }
     return infos;
 }
@@ -351,16 +409,16 @@ std::vector<sng::PhraseExtraInfo> ReadPhraseExtraInfos(BinaryReader& reader)
 // Section 11: NLinkedDifficulties
 std::vector<sng::NLinkedDifficulty> ReadNLinkedDifficulties(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    const auto count = reader.ReadCount(8);
     std::vector<sng::NLinkedDifficulty> nlds(count);
     for (auto& nld : nlds)
     {
         nld.level_break = reader.ReadInt32();
-        const auto phrase_count = reader.ReadInt32();
+        auto [phrase_count, phrases] = reader.ReadRecords(4);
         nld.nld_phrases.resize(phrase_count);
         for (auto& phrase : nld.nld_phrases)
         {
-            phrase = reader.ReadInt32();
+            phrase = phrases.ReadInt32();
         }
     }
     return nlds;
@@ -369,12 +427,12 @@ std::vector<sng::NLinkedDifficulty> ReadNLinkedDifficulties(BinaryReader& reader
 // Section 12: Actions
 std::vector<sng::Action> ReadActions(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(260);
     std::vector<sng::Action> actions(count);
     for (auto& action : actions)
     {
-        action.time = reader.ReadFloat();
-        action.name = reader.ReadFixedString(256);
+        action.time = records.ReadFloat();
+        action.name = records.ReadFixedString(256);
     }
     return actions;
 }
@@ -382,12 +440,12 @@ std::vector<sng::Action> ReadActions(BinaryReader& reader)
 // Section 13: Events
 std::vector<sng::Event> ReadEvents(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(260);
     std::vector<sng::Event> events(count);
     for (auto& event : events)
     {
-        event.time = reader.ReadFloat();
-        event.name = reader.ReadFixedString(256);
+        event.time = records.ReadFloat();
+        event.name = records.ReadFixedString(256);
     }
     return events;
 }
@@ -395,12 +453,12 @@ std::vector<sng::Event> ReadEvents(BinaryReader& reader)
 // Section 14: Tones
 std::vector<sng::Tone> ReadTones(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(8);
     std::vector<sng::Tone> tones(count);
     for (auto& tone : tones)
     {
-        tone.time = reader.ReadFloat();
-        tone.tone_id = reader.ReadInt32();
+        tone.time = records.ReadFloat();
+        tone.tone_id = records.ReadInt32();
     }
     return tones;
 }
@@ -408,12 +466,12 @@ std::vector<sng::Tone> ReadTones(BinaryReader& reader)
 // Section 15: DNAs
 std::vector<sng::Dna> ReadDnas(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(8);
     std::vector<sng::Dna> dnas(count);
     for (auto& dna : dnas)
     {
-        dna.time = reader.ReadFloat();
-        dna.dna_id = reader.ReadInt32();
+        dna.time = records.ReadFloat();
+        dna.dna_id = records.ReadInt32();
     }
     return dnas;
 }
@@ -421,19 +479,19 @@ std::vector<sng::Dna> ReadDnas(BinaryReader& reader)
 // Section 16: Sections
 std::vector<sng::Section> ReadSections(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    auto [count, records] = reader.ReadRecords(88);
     std::vector<sng::Section> sections(count);
     for (auto& section : sections)
     {
-        section.name = reader.ReadFixedString(32);
-        section.number = reader.ReadInt32();
-        section.start_time = reader.ReadFloat();
-        section.end_time = reader.ReadFloat();
-        section.start_phrase_iteration_index = reader.ReadInt32();
-        section.end_phrase_iteration_index = reader.ReadInt32();
+        section.name = records.ReadFixedString(32);
+        section.number = records.ReadInt32();
+        section.start_time = records.ReadFloat();
+        section.end_time = records.ReadFloat();
+        section.start_phrase_iteration_index = records.ReadInt32();
+        section.end_phrase_iteration_index = records.ReadInt32();
         for (unsigned char& byte : section.string_bytes)
         {
-            byte = reader.ReadUInt8();
+            byte = records.ReadUInt8();
         }
     }
     return sections;
@@ -443,39 +501,40 @@ std::vector<sng::Section> ReadSections(BinaryReader& reader)
 sng::Note ReadNote(BinaryReader& reader)
 {
     sng::Note note;
-    note.mask = reader.ReadUInt32();
-    note.flags = reader.ReadUInt32();
-    note.hash = reader.ReadUInt32();
-    note.time = reader.ReadFloat();
-    note.string = reader.ReadInt8();
-    note.fret = reader.ReadInt8();
-    note.anchor_fret = reader.ReadInt8();
-    note.anchor_width = reader.ReadInt8();
-    note.chord_id = reader.ReadInt32();
-    note.chord_notes_id = reader.ReadInt32();
-    note.phrase_id = reader.ReadInt32();
-    note.phrase_iteration_id = reader.ReadInt32();
-    note.fingerprint_id[0] = reader.ReadInt16();
-    note.fingerprint_id[1] = reader.ReadInt16();
-    note.next_iteration = reader.ReadInt16();
-    note.prev_iteration = reader.ReadInt16();
-    note.parent_prev_note = reader.ReadInt16();
-    note.slide_to = reader.ReadInt8();
-    note.slide_unpitch_to = reader.ReadInt8();
-    note.left_hand = reader.ReadInt8();
-    note.tap = reader.ReadInt8();
-    note.pick_direction = reader.ReadInt8();
-    note.slap = reader.ReadInt8();
-    note.pluck = reader.ReadInt8();
-    note.vibrato = reader.ReadInt16();
-    note.sustain = reader.ReadFloat();
-    note.max_bend = reader.ReadFloat();
-
-    const auto bend_count = reader.ReadInt32();
+    auto fields = reader.Take(63);
+    note.mask = fields.ReadUInt32();
+    note.flags = fields.ReadUInt32();
+    note.hash = fields.ReadUInt32();
+    note.time = fields.ReadFloat();
+    note.string = fields.ReadInt8();
+    note.fret = fields.ReadInt8();
+    note.anchor_fret = fields.ReadInt8();
+    note.anchor_width = fields.ReadInt8();
+    note.chord_id = fields.ReadInt32();
+    note.chord_notes_id = fields.ReadInt32();
+    note.phrase_id = fields.ReadInt32();
+    note.phrase_iteration_id = fields.ReadInt32();
+    note.fingerprint_id[0] = fields.ReadInt16();
+    note.fingerprint_id[1] = fields.ReadInt16();
+    note.next_iteration = fields.ReadInt16();
+    note.prev_iteration = fields.ReadInt16();
+    note.parent_prev_note = fields.ReadInt16();
+    note.slide_to = fields.ReadInt8();
+    note.slide_unpitch_to = fields.ReadInt8();
+    note.left_hand = fields.ReadInt8();
+    note.tap = fields.ReadInt8();
+    note.pick_direction = fields.ReadInt8();
+    note.slap = fields.ReadInt8();
+    note.pluck = fields.ReadInt8();
+    note.vibrato = fields.ReadInt16();
+    note.sustain = fields.ReadFloat();
+    note.max_bend = fields.ReadFloat();
+
+    auto [bend_count, bends] = reader.ReadRecords(12);
     note.bend_values.resize(bend_count);
     for (auto& bv : note.bend_values)
     {
-        bv = ReadBendValue(reader);
+        bv = ReadBendValue(bends);
     }
 
     return note;
@@ -484,65 +543,64 @@ sng::Note ReadNote(BinaryReader& reader)
 // Section 17: Arrangements
 std::vector<sng::Arrangement> ReadArrangements(BinaryReader& reader)
 {
-    const auto count = reader.ReadInt32();
+    const auto count = reader.ReadCount(36);
     std::vector<sng::Arrangement> arrangements(count);
-    for (int arr_idx = 0; arr_idx < count; ++arr_idx)
+    for (auto& arr : arrangements)
     {
-        auto& arr = arrangements[arr_idx];
         arr.difficulty = reader.ReadInt32();
 
         // Anchors
-        const auto anchor_count = reader.ReadInt32();
+        auto [anchor_count, anchors] = reader.ReadRecords(28);
         arr.anchors.resize(anchor_count);
         for (auto& anchor : arr.anchors)
         {
-            anchor.start_time = reader.ReadFloat();
-            anchor.end_time = reader.ReadFloat();
-            anchor.unk1 = reader.ReadFloat();
-            anchor.unk2 = reader.ReadFloat();
-            anchor.fret = reader.ReadInt32();
-            anchor.width = reader.ReadInt32();
-            anchor.phrase_iteration_index = reader.ReadInt32();
+            anchor.start_time = anchors.ReadFloat();
+            anchor.end_time = anchors.ReadFloat();
+            anchor.unk1 = anchors.ReadFloat();
+            anchor.unk2 = anchors.ReadFloat();
+            anchor.fret = anchors.ReadInt32();
+            anchor.width = anchors.ReadInt32();
+            anchor.phrase_iteration_index = anchors.ReadInt32();
         }
 
         // Anchor Extensions
-        const auto anchor_ext_count = reader.ReadInt32();
+        auto [anchor_ext_count, extensions] = reader.ReadRecords(12);
         arr.anchor_extensions.resize(anchor_ext_count);
         for (auto& ext : arr.anchor_extensions)
         {
-            ext.beat_time = reader.ReadFloat();
-            ext.fret_id = reader.ReadInt8();
-            ext.unk2 = reader.ReadInt32();
-            ext.unk3 = reader.ReadInt16();
-            ext.unk4 = reader.ReadInt8();
+            ext.beat_time = extensions.ReadFloat();
+            ext.fret_id = extensions.ReadInt8();
+            ext.unk2 = extensions.ReadInt32();
+            ext.unk3 = extensions.ReadInt16();
+            ext.unk4 = extensions.ReadInt8();
         }
 
         // Fingerprints - handshape
-        const auto hs_count = reader.ReadInt32();
+        auto [hs_count, handshapes] = reader.ReadRecords(20);
         arr.fingerprints_handshape.resize(hs_count);
         for (auto& fp : arr.fingerprints_handshape)
         {
-            fp.chord_id = reader.ReadInt32();
-            fp.start_time = reader.ReadFloat();
-            fp.end_time = reader.ReadFloat();
-            fp.unk1 = reader.ReadFloat();
-            fp.unk2 = reader.ReadFloat();
+            fp.chord_id = handshapes.ReadInt32();
+            fp.start_time = handshapes.ReadFloat();
+            fp.end_time = handshapes.ReadFloat();
+            fp.unk1 = handshapes.ReadFloat();
+            fp.unk2 = handshapes.ReadFloat();
         }
 
         // Fingerprints - arpeggio
-        const auto arp_count = reader.ReadInt32();
+        auto [arp_count, arpeggios] = reader.ReadRecords(20);
         arr.fingerprints_arpeggio.resize(arp_count);
         for (auto& fp : arr.fingerprints_arpeggio)
         {
-            fp.chord_id = reader.ReadInt32();
-            fp.start_time = reader.ReadFloat();
-            fp.end_time = reader.ReadFloat();
-            fp.unk1 = reader.ReadFloat();
-            fp.unk2 = reader.ReadFloat();
+            fp.chord_id = arpeggios.ReadInt32();
+            fp.start_time = arpeggios.ReadFloat();
+            fp.end_time = arpeggios.ReadFloat();
+            fp.unk1 = arpeggios.ReadFloat();
+            fp.unk2 = arpeggios.ReadFloat();
         }
 
         // Notes
-        const auto note_count = reader.ReadInt32();
+        const auto note_count = reader.ReadCount(67);
         arr.notes.resize(note_count);
         for (auto& note : arr.notes)
         {
@@ -550,25 +608,28 @@ std::vector<sng::Arrangement> ReadArrangements(BinaryReader& reader)
         }
 
         // Per-arrangement metadata
-        arr.phrase_count = reader.ReadInt32();
-        arr.average_notes_per_iteration.resize(arr.phrase_count);
+        auto [phrase_count, averages] = reader.ReadRecords(4);
+        arr.phrase_count = static_cast<int32_t>(phrase_count);
+        arr.average_notes_per_iteration.resize(phrase_count);
         for (auto& avg : arr.average_notes_per_iteration)
         {
-            avg = reader.ReadFloat();
+            avg = averages.ReadFloat();
         }
 
-        arr.phrase_iteration_count1 = reader.ReadInt32();
-        arr.notes_in_iteration1.resize(arr.phrase_iteration_count1);
+        auto [iteration_count1, notes1] = reader.ReadRecords(4);
+        arr.phrase_iteration_count1 = static_cast<int32_t>(iteration_count1);
+        arr.notes_in_iteration1.resize(iteration_count1);
         for (auto& n : arr.notes_in_iteration1)
         {
-            n = reader.ReadInt32();
+            n = notes1.ReadInt32();
         }
 
-        arr.phrase_iteration_count2 = reader.ReadInt32();
-        arr.notes_in_iteration2.resize(arr.phrase_iteration_count2);
+        auto [iteration_count2, notes2] = reader.ReadRecords(4);
+        arr.phrase_iteration_count2 = static_cast<int32_t>(iteration_count2);
+        arr.notes_in_iteration2.resize(iteration_count2);
         for (auto& n : arr.notes_in_iteration2)
         {
-            n = reader.ReadInt32();
+            n = notes2.ReadInt32();
         }
     }
     return arrangements;
@@ -578,25 +639,29 @@ std::vector<sng::Arrangement> ReadArrangements(BinaryReader& reader)
 sng::Metadata ReadMetadata(BinaryReader& reader)
 {
     sng::Metadata meta;
-    meta.max_score = reader.ReadDouble();
-    meta.max_notes_and_chords = reader.ReadDouble();
-    meta.max_notes_and_chords_real = reader.ReadDouble();
-    meta.point_per_note = reader.ReadDouble();
-    meta.first_beat_length = reader.ReadFloat();
-    meta.start_time = reader.ReadFloat();
-    meta.capo_fret_id = reader.ReadInt8();
-    meta.last_conversion_date_time = reader.ReadFixedString(32);
-    meta.part = reader.ReadInt16();
-    meta.song_length = reader.ReadFloat();
-    meta.string_count = reader.ReadInt32();
-    meta.tuning.resize(meta.string_count);
+    auto fields = reader.Take(79);
+    meta.max_score = fields.ReadDouble();
+    meta.max_notes_and_chords = fields.ReadDouble();
+    meta.max_notes_and_chords_real = fields.ReadDouble();
+    meta.point_per_note = fields.ReadDouble();
+    meta.first_beat_length = fields.ReadFloat();
+    meta.start_time = fields.ReadFloat();
+    meta.capo_fret_id = fields.ReadInt8();
+    meta.last_conversion_date_time = fields.ReadFixedString(32);
+    meta.part = fields.ReadInt16();
+    meta.song_length = fields.ReadFloat();
+    auto [string_count, tuning] = reader.ReadRecords(2);
+    meta.string_count = static_cast<int32_t>(string_count);
+    meta.tuning.resize(string_count);
     for (auto& t : meta.tuning)
     {
-        t = reader.ReadInt16();
+        t = tuning.ReadInt16();
     }
-    meta.first_note_time = reader.ReadFloat();
-    meta.first_note_time2 = reader.ReadFloat();
-    meta.max_difficulty = reader.ReadInt32();
+
+    auto tail = reader.Take(12);
+    meta.first_note_time = tail.ReadFloat();
+    meta.first_note_time2 = tail.ReadFloat();
+    meta.max_difficulty = tail.ReadInt32();
     return meta;
 }
 
@@ -604,6 +669,7 @@ sng::Metadata ReadMetadata(BinaryReader& reader)
 
 sng::SngData SngParser::Parse(std::span<const uint8_t> data)
 {
+    PSARC_TRACE_SCOPE("SngParser::Parse");
     if (data.empty())
     {
         throw PsarcException("SNG data is empty");
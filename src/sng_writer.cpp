@@ -0,0 +1,588 @@
+#include "sng_writer.h"
+
+#include "open-psarc/psarc_file.h"
+#include "psarc_format.h"
+#include "psarc_writer.h"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <string>
+#include <utility>
+
+#include <openssl/evp.h>
+
+namespace
+{
+
+// Signature block that follows the encrypted payload in SNG files; unused by the parser
+constexpr size_t g_sng_signature_size = 56;
+
+class BinaryWriter
+{
+public:
+    void WriteFloat(float value)
+    {
+        WriteUInt32(std::bit_cast<uint32_t>(value));
+    }
+
+    void WriteDouble(double value)
+    {
+        const auto raw = std::bit_cast<uint64_t>(value);
+        WriteUInt32(static_cast<uint32_t>(raw));
+        WriteUInt32(static_cast<uint32_t>(raw >> 32));
+    }
+
+    void WriteInt8(int8_t value)
+    {
+        m_data.push_back(static_cast<uint8_t>(value));
+    }
+
+    void WriteUInt8(uint8_t value)
+    {
+        m_data.push_back(value);
+    }
+
+    void WriteInt16(int16_t value)
+    {
+        WriteUInt16(static_cast<uint16_t>(value));
+    }
+
+    void WriteUInt16(uint16_t value)
+    {
+        m_data.push_back(static_cast<uint8_t>(value));
+        m_data.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void WriteInt32(int32_t value)
+    {
+        WriteUInt32(static_cast<uint32_t>(value));
+    }
+
+    void WriteUInt32(uint32_t value)
+    {
+        m_data.push_back(static_cast<uint8_t>(value));
+        m_data.push_back(static_cast<uint8_t>(value >> 8));
+        m_data.push_back(static_cast<uint8_t>(value >> 16));
+        m_data.push_back(static_cast<uint8_t>(value >> 24));
+    }
+
+    void WriteCount(size_t count)
+    {
+        WriteInt32(static_cast<int32_t>(count));
+    }
+
+    // Writes a null-padded string, truncated to the field size
+    void WriteFixedString(const std::string& value, size_t size)
+    {
+        const size_t len = std::min(value.size(), size);
+        m_data.insert(m_data.end(), value.begin(),
+                      value.begin() + static_cast<std::ptrdiff_t>(len));
+        m_data.insert(m_data.end(), size - len, 0);
+    }
+
+    [[nodiscard]] std::vector<uint8_t> Release()
+    {
+        return std::move(m_data);
+    }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+void WriteBendValue(BinaryWriter& writer, const sng::BendValue& bv)
+{
+    writer.WriteFloat(bv.time);
+    writer.WriteFloat(bv.step);
+    writer.WriteInt16(bv.unk1);
+    writer.WriteUInt8(bv.unk2);
+    writer.WriteUInt8(bv.unk3);
+}
+
+// Section 1: BPM
+void WriteBpms(BinaryWriter& writer, const std::vector<sng::Bpm>& bpms)
+{
+    writer.WriteCount(bpms.size());
+    for (const auto& bpm : bpms)
+    {
+        writer.WriteFloat(bpm.time);
+        writer.WriteInt16(bpm.measure);
+        writer.WriteInt16(bpm.beat);
+        writer.WriteInt32(bpm.phrase_iteration);
+        writer.WriteInt32(bpm.mask);
+    }
+}
+
+// Section 2: Phrases
+void WritePhrases(BinaryWriter& writer, const std::vector<sng::Phrase>& phrases)
+{
+    writer.WriteCount(phrases.size());
+    for (const auto& phrase : phrases)
+    {
+        writer.WriteUInt8(phrase.solo);
+        writer.WriteUInt8(phrase.disparity);
+        writer.WriteUInt8(phrase.ignore);
+        writer.WriteUInt8(phrase.padding);
+        writer.WriteInt32(phrase.max_difficulty);
+        writer.WriteInt32(phrase.phrase_iteration_links);
+        writer.WriteFixedString(phrase.name, 32);
+    }
+}
+
+// Section 3: Chords
+void WriteChords(BinaryWriter& writer, const std::vector<sng::Chord>& chords)
+{
+    writer.WriteCount(chords.size());
+    for (const auto& chord : chords)
+    {
+        writer.WriteUInt32(chord.mask);
+        for (const int8_t fret : chord.frets)
+        {
+            // -1 is stored as 0xFF
+            writer.WriteInt8(fret);
+        }
+        for (const int8_t finger : chord.fingers)
+        {
+            writer.WriteInt8(finger);
+        }
+        for (const int32_t note : chord.notes)
+        {
+            writer.WriteInt32(note);
+        }
+        writer.WriteFixedString(chord.name, 32);
+    }
+}
+
+// Section 4: ChordNotes
+void WriteChordNotes(BinaryWriter& writer, const std::vector<sng::ChordNotes>& chord_notes)
+{
+    writer.WriteCount(chord_notes.size());
+    for (const auto& cn : chord_notes)
+    {
+        for (const uint32_t mask : cn.mask)
+        {
+            writer.WriteUInt32(mask);
+        }
+        // BendData[6] - always 32 BendValue slots followed by UsedCount, which the parser
+        // also uses as the size of bend_values
+        for (const auto& bd : cn.bend_data)
+        {
+            if (bd.bend_values.size() > 32)
+            {
+                throw PsarcException(std::format(
+                    "SNG write error: chord bend count {} exceeds 32", bd.bend_values.size()));
+            }
+            for (size_t i = 0; i < 32; ++i)
+            {
+                WriteBendValue(writer,
+                               i < bd.bend_values.size() ? bd.bend_values[i] : sng::BendValue{});
+            }
+            writer.WriteCount(bd.bend_values.size());
+        }
+        for (const int8_t i : cn.slide_to)
+        {
+            writer.WriteInt8(i);
+        }
+        for (const int8_t i : cn.slide_unpitch_to)
+        {
+            writer.WriteInt8(i);
+        }
+        for (const int16_t i : cn.vibrato)
+        {
+            writer.WriteInt16(i);
+        }
+    }
+}
+
+// Section 5: Vocals
+void WriteVocals(BinaryWriter& writer, const std::vector<sng::Vocal>& vocals)
+{
+    writer.WriteCount(vocals.size());
+    for (const auto& vocal : vocals)
+    {
+        writer.WriteFloat(vocal.time);
+        writer.WriteInt32(vocal.note);
+        writer.WriteFloat(vocal.length);
+        writer.WriteFixedString(vocal.lyric, 48);
+    }
+}
+
+// Section 6: SymbolsHeaders
+void WriteSymbolsHeaders(BinaryWriter& writer, const std::vector<sng::SymbolsHeader>& headers)
+{
+    writer.WriteCount(headers.size());
+    for (const auto& header : headers)
+    {
+        writer.WriteInt32(header.unk1);
+        writer.WriteInt32(header.unk2);
+        writer.WriteInt32(header.unk3);
+        writer.WriteInt32(header.unk4);
+        writer.WriteInt32(header.unk5);
+        writer.WriteInt32(header.unk6);
+        writer.WriteInt32(header.unk7);
+        writer.WriteInt32(header.unk8);
+    }
+}
+
+// Section 7: SymbolsTextures
+void WriteSymbolsTextures(BinaryWriter& writer, const std::vector<sng::SymbolsTexture>& textures)
+{
+    writer.WriteCount(textures.size());
+    for (const auto& texture : textures)
+    {
+        writer.WriteFixedString(texture.font_name, 128);
+        writer.WriteInt32(texture.font_path_length);
+        writer.WriteInt32(texture.unk);
+        writer.WriteInt32(texture.width);
+        writer.WriteInt32(texture.height);
+    }
+}
+
+// Section 8: SymbolDefinitions
+void WriteSymbolDefinitions(BinaryWriter& writer,
+                            const std::vector<sng::SymbolDefinition>& definitions)
+{
+    writer.WriteCount(definitions.size());
+    for (const auto& def : definitions)
+    {
+        writer.WriteFixedString(def.text, 12);
+        for (const float val : def.rect_outer)
+        {
+            writer.WriteFloat(val);
+        }
+        for (const float val : def.rect_inner)
+        {
+            writer.WriteFloat(val);
+        }
+    }
+}
+
+// Section 9: PhraseIterations
+void WritePhraseIterations(BinaryWriter& writer,
+                           const std::vector<sng::PhraseIteration>& iterations)
+{
+    writer.WriteCount(iterations.size());
+    for (const auto& iter : iterations)
+    {
+        writer.WriteInt32(iter.phrase_id);
+        writer.WriteFloat(iter.start_time);
+        writer.WriteFloat(iter.next_phrase_time);
+        for (const int32_t diff : iter.difficulty)
+        {
+            writer.WriteInt32(diff);
+        }
+    }
+}
+
+// Section 10: PhraseExtraInfos
+void WritePhraseExtraInfos(BinaryWriter& writer, const std::vector<sng::PhraseExtraInfo>& infos)
+{
+    writer.WriteCount(infos.size());
+    for (const auto& info : infos)
+    {
+        writer.WriteInt32(info.phrase_id);
+        writer.WriteInt32(info.difficulty);
+        writer.WriteInt32(info.empty);
+        writer.WriteUInt8(info.level_jump);
+        writer.WriteInt16(info.redundant);
+        writer.WriteUInt8(info.padding);
+    }
+}
+
+// Section 11: NLinkedDifficulties
+void WriteNLinkedDifficulties(BinaryWriter& writer,
+                              const std::vector<sng::NLinkedDifficulty>& nlds)
+{
+    writer.WriteCount(nlds.size());
+    for (const auto& nld : nlds)
+    {
+        writer.WriteInt32(nld.level_break);
+        writer.WriteCount(nld.nld_phrases.size());
+        for (const int32_t phrase : nld.nld_phrases)
+        {
+            writer.WriteInt32(phrase);
+        }
+    }
+}
+
+// Section 12: Actions
+void WriteActions(BinaryWriter& writer, const std::vector<sng::Action>& actions)
+{
+    writer.WriteCount(actions.size());
+    for (const auto& action : actions)
+    {
+        writer.WriteFloat(action.time);
+        writer.WriteFixedString(action.name, 256);
+    }
+}
+
+// Section 13: Events
+void WriteEvents(BinaryWriter& writer, const std::vector<sng::Event>& events)
+{
+    writer.WriteCount(events.size());
+    for (const auto& event : events)
+    {
+        writer.WriteFloat(event.time);
+        writer.WriteFixedString(event.name, 256);
+    }
+}
+
+// Section 14: Tones
+void WriteTones(BinaryWriter& writer, const std::vector<sng::Tone>& tones)
+{
+    writer.WriteCount(tones.size());
+    for (const auto& tone : tones)
+    {
+        writer.WriteFloat(tone.time);
+        writer.WriteInt32(tone.tone_id);
+    }
+}
+
+// Section 15: DNAs
+void WriteDnas(BinaryWriter& writer, const std::vector<sng::Dna>& dnas)
+{
+    writer.WriteCount(dnas.size());
+    for (const auto& dna : dnas)
+    {
+        writer.WriteFloat(dna.time);
+        writer.WriteInt32(dna.dna_id);
+    }
+}
+
+// Section 16: Sections
+void WriteSections(BinaryWriter& writer, const std::vector<sng::Section>& sections)
+{
+    writer.WriteCount(sections.size());
+    for (const auto& section : sections)
+    {
+        writer.WriteFixedString(section.name, 32);
+        writer.WriteInt32(section.number);
+        writer.WriteFloat(section.start_time);
+        writer.WriteFloat(section.end_time);
+        writer.WriteInt32(section.start_phrase_iteration_index);
+        writer.WriteInt32(section.end_phrase_iteration_index);
+        for (const uint8_t byte : section.string_bytes)
+        {
+            writer.WriteUInt8(byte);
+        }
+    }
+}
+
+// Write a Note struct (used in Arrangements)
+void WriteNote(BinaryWriter& writer, const sng::Note& note)
+{
+    writer.WriteUInt32(note.mask);
+    writer.WriteUInt32(note.flags);
+    writer.WriteUInt32(note.hash);
+    writer.WriteFloat(note.time);
+    writer.WriteInt8(note.string);
+    writer.WriteInt8(note.fret);
+    writer.WriteInt8(note.anchor_fret);
+    writer.WriteInt8(note.anchor_width);
+    writer.WriteInt32(note.chord_id);
+    writer.WriteInt32(note.chord_notes_id);
+    writer.WriteInt32(note.phrase_id);
+    writer.WriteInt32(note.phrase_iteration_id);
+    writer.WriteInt16(note.fingerprint_id[0]);
+    writer.WriteInt16(note.fingerprint_id[1]);
+    writer.WriteInt16(note.next_iteration);
+    writer.WriteInt16(note.prev_iteration);
+    writer.WriteInt16(note.parent_prev_note);
+    writer.WriteInt8(note.slide_to);
+    writer.WriteInt8(note.slide_unpitch_to);
+    writer.WriteInt8(note.left_hand);
+    writer.WriteInt8(note.tap);
+    writer.WriteInt8(note.pick_direction);
+    writer.WriteInt8(note.slap);
+    writer.WriteInt8(note.pluck);
+    writer.WriteInt16(note.vibrato);
+    writer.WriteFloat(note.sustain);
+    writer.WriteFloat(note.max_bend);
+
+    writer.WriteCount(note.bend_values.size());
+    for (const auto& bv : note.bend_values)
+    {
+        WriteBendValue(writer, bv);
+    }
+}
+
+void WriteFingerprints(BinaryWriter& writer, const std::vector<sng::Fingerprint>& fingerprints)
+{
+    writer.WriteCount(fingerprints.size());
+    for (const auto& fp : fingerprints)
+    {
+        writer.WriteInt32(fp.chord_id);
+        writer.WriteFloat(fp.start_time);
+        writer.WriteFloat(fp.end_time);
+        writer.WriteFloat(fp.unk1);
+        writer.WriteFloat(fp.unk2);
+    }
+}
+
+// Section 17: Arrangements
+void WriteArrangements(BinaryWriter& writer, const std::vector<sng::Arrangement>& arrangements)
+{
+    writer.WriteCount(arrangements.size());
+    for (const auto& arr : arrangements)
+    {
+        writer.WriteInt32(arr.difficulty);
+
+        // Anchors
+        writer.WriteCount(arr.anchors.size());
+        for (const auto& anchor : arr.anchors)
+        {
+            writer.WriteFloat(anchor.start_time);
+            writer.WriteFloat(anchor.end_time);
+            writer.WriteFloat(anchor.unk1);
+            writer.WriteFloat(anchor.unk2);
+            writer.WriteInt32(anchor.fret);
+            writer.WriteInt32(anchor.width);
+            writer.WriteInt32(anchor.phrase_iteration_index);
+        }
+
+        // Anchor Extensions
+        writer.WriteCount(arr.anchor_extensions.size());
+        for (const auto& ext : arr.anchor_extensions)
+        {
+            writer.WriteFloat(ext.beat_time);
+            writer.WriteInt8(ext.fret_id);
+            writer.WriteInt32(ext.unk2);
+            writer.WriteInt16(ext.unk3);
+            writer.WriteInt8(ext.unk4);
+        }
+
+        // Fingerprints - handshape, then arpeggio
+        WriteFingerprints(writer, arr.fingerprints_handshape);
+        WriteFingerprints(writer, arr.fingerprints_arpeggio);
+
+        // Notes
+        writer.WriteCount(arr.notes.size());
+        for (const auto& note : arr.notes)
+        {
+            WriteNote(writer, note);
+        }
+
+        // Per-arrangement metadata; counts come from the vectors so they can't disagree
+        writer.WriteCount(arr.average_notes_per_iteration.size());
+        for (const float avg : arr.average_notes_per_iteration)
+        {
+            writer.WriteFloat(avg);
+        }
+
+        writer.WriteCount(arr.notes_in_iteration1.size());
+        for (const int32_t n : arr.notes_in_iteration1)
+        {
+            writer.WriteInt32(n);
+        }
+
+        writer.WriteCount(arr.notes_in_iteration2.size());
+        for (const int32_t n : arr.notes_in_iteration2)
+        {
+            writer.WriteInt32(n);
+        }
+    }
+}
+
+// Section 18: Metadata
+void WriteMetadata(BinaryWriter& writer, const sng::Metadata& meta)
+{
+    writer.WriteDouble(meta.max_score);
+    writer.WriteDouble(meta.max_notes_and_chords);
+    writer.WriteDouble(meta.max_notes_and_chords_real);
+    writer.WriteDouble(meta.point_per_note);
+    writer.WriteFloat(meta.first_beat_length);
+    writer.WriteFloat(meta.start_time);
+    writer.WriteInt8(meta.capo_fret_id);
+    writer.WriteFixedString(meta.last_conversion_date_time, 32);
+    writer.WriteInt16(meta.part);
+    writer.WriteFloat(meta.song_length);
+    writer.WriteCount(meta.tuning.size());
+    for (const int16_t t : meta.tuning)
+    {
+        writer.WriteInt16(t);
+    }
+    writer.WriteFloat(meta.first_note_time);
+    writer.WriteFloat(meta.first_note_time2);
+    writer.WriteInt32(meta.max_difficulty);
+}
+
+} // namespace
+
+std::vector<uint8_t> SngWriter::Serialize(const sng::SngData& sng)
+{
+    BinaryWriter writer;
+
+    WriteBpms(writer, sng.bpms);
+    WritePhrases(writer, sng.phrases);
+    WriteChords(writer, sng.chords);
+    WriteChordNotes(writer, sng.chord_notes);
+    WriteVocals(writer, sng.vocals);
+    if (!sng.vocals.empty())
+    {
+        WriteSymbolsHeaders(writer, sng.symbols_headers);
+        WriteSymbolsTextures(writer, sng.symbols_textures);
+        WriteSymbolDefinitions(writer, sng.symbol_definitions);
+    }
+    WritePhraseIterations(writer, sng.phrase_iterations);
+    WritePhraseExtraInfos(writer, sng.phrase_extra_infos);
+    WriteNLinkedDifficulties(writer, sng.nlinked_difficulties);
+    WriteActions(writer, sng.actions);
+    WriteEvents(writer, sng.events);
+    WriteTones(writer, sng.tones);
+    WriteDnas(writer, sng.dnas);
+    WriteSections(writer, sng.sections);
+    WriteArrangements(writer, sng.arrangements);
+    WriteMetadata(writer, sng.metadata);
+
+    return writer.Release();
+}
+
+std::vector<uint8_t> SngWriter::Encode(const sng::SngData& sng, const std::array<uint8_t, 16>& iv)
+{
+    return Encrypt(Serialize(sng), iv);
+}
+
+std::vector<uint8_t> SngWriter::Encrypt(std::span<const uint8_t> data,
+                                        const std::array<uint8_t, 16>& iv)
+{
+    // Payload: uncompressed size (LE32) followed by the zlib stream
+    const auto compressed = PsarcWriter::CompressZlib(data);
+    std::vector<uint8_t> payload(4);
+    payload[0] = static_cast<uint8_t>(data.size());
+    payload[1] = static_cast<uint8_t>(data.size() >> 8);
+    payload[2] = static_cast<uint8_t>(data.size() >> 16);
+    payload[3] = static_cast<uint8_t>(data.size() >> 24);
+    payload.insert(payload.end(), compressed.begin(), compressed.end());
+
+    // Header: magic (LE32), flags (LE32), IV (16 bytes)
+    std::vector<uint8_t> result(24 + payload.size());
+    result[0] = static_cast<uint8_t>(g_sng_magic);
+    result[4] = static_cast<uint8_t>(g_sng_compressed_flag);
+    std::ranges::copy(iv, result.begin() + 8);
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    if (!ctx)
+    {
+        throw PsarcException("Failed to create cipher context");
+    }
+
+    int len = 0;
+    bool success =
+        EVP_EncryptInit_ex(ctx, EVP_aes_256_ctr(), nullptr, g_sng_key.data(), iv.data()) == 1;
+    if (success)
+    {
+        EVP_CIPHER_CTX_set_padding(ctx, 0);
+        success = EVP_EncryptUpdate(ctx, result.data() + 24, &len, payload.data(),
+                                    static_cast<int>(payload.size())) == 1;
+    }
+
+    EVP_CIPHER_CTX_free(ctx);
+
+    if (!success)
+    {
+        throw PsarcException("Failed to encrypt SNG");
+    }
+
+    result.resize(24 + static_cast<size_t>(len) + g_sng_signature_size, 0);
+    return result;
+}
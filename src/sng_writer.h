@@ -0,0 +1,23 @@
+#pragma once
+
+#include "sng_types.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class SngWriter
+{
+public:
+    // Serializes to the decrypted, uncompressed layout read by SngParser::Parse. Throws
+    // PsarcException if a chord has more bend values than the format's 32 slots.
+    [[nodiscard]] static std::vector<uint8_t> Serialize(const sng::SngData& sng);
+
+    // Serializes, compresses and encrypts into the container stored in PSARC archives
+    [[nodiscard]] static std::vector<uint8_t> Encode(const sng::SngData& sng,
+                                                     const std::array<uint8_t, 16>& iv = {});
+
+    [[nodiscard]] static std::vector<uint8_t> Encrypt(std::span<const uint8_t> data,
+                                                      const std::array<uint8_t, 16>& iv = {});
+};
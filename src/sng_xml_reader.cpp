@@ -0,0 +1,1257 @@
+#include "sng_xml_reader.h"
+
+#include "open-psarc/psarc_file.h"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+// Forward-only XML tokenizer. Only elements, attributes and text are reported; declarations,
+// comments and doctypes are skipped. Names and values are views into the source document.
+class XmlPullReader
+{
+public:
+    enum class Node
+    {
+        StartElement,
+        EndElement,
+        Text,
+        EndOfDocument,
+    };
+
+    using Attribute = std::pair<std::string_view, std::string_view>;
+
+    explicit XmlPullReader(std::string_view xml) : m_xml(xml)
+    {
+    }
+
+    [[nodiscard]] Node Next()
+    {
+        if (m_pending_end)
+        {
+            m_pending_end = false;
+            --m_depth;
+            return Node::EndElement;
+        }
+
+        while (m_pos < m_xml.size())
+        {
+            if (m_xml[m_pos] != '<')
+            {
+                const size_t end = std::min(m_xml.find('<', m_pos), m_xml.size());
+                m_text = m_xml.substr(m_pos, end - m_pos);
+                m_pos = end;
+                if (m_text.find_first_not_of(" \t\r\n") != std::string_view::npos)
+                {
+                    return Node::Text;
+                }
+                continue;
+            }
+
+            const std::string_view rest = m_xml.substr(m_pos);
+            if (rest.starts_with("<?"))
+            {
+                SkipPast("?>");
+            }
+            else if (rest.starts_with("<!--"))
+            {
+                SkipPast("-->");
+            }
+            else if (rest.starts_with("<![CDATA["))
+            {
+                const size_t start = m_pos + 9;
+                SkipPast("]]>");
+                m_text = m_xml.substr(start, m_pos - 3 - start);
+                return Node::Text;
+            }
+            else if (rest.starts_with("<!"))
+            {
+                SkipPast(">");
+            }
+            else if (rest.starts_with("</"))
+            {
+                m_pos += 2;
+                m_name = ReadName();
+                SkipWhitespace();
+                Expect('>');
+                --m_depth;
+                return Node::EndElement;
+            }
+            else
+            {
+                ++m_pos;
+                ReadStartElement();
+                ++m_depth;
+                return Node::StartElement;
+            }
+        }
+
+        return Node::EndOfDocument;
+    }
+
+    [[nodiscard]] std::string_view Name() const
+    {
+        return m_name;
+    }
+
+    [[nodiscard]] std::string_view Text() const
+    {
+        return m_text;
+    }
+
+    [[nodiscard]] const std::vector<Attribute>& Attributes() const
+    {
+        return m_attributes;
+    }
+
+    [[nodiscard]] std::optional<std::string_view> FindAttribute(std::string_view name) const
+    {
+        for (const auto& [key, value] : m_attributes)
+        {
+            if (key == name)
+            {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Consumes the rest of the current element, including its children
+    void SkipElement()
+    {
+        int depth = 1;
+        while (depth > 0)
+        {
+            switch (Next())
+            {
+            case Node::StartElement:
+                ++depth;
+                break;
+            case Node::EndElement:
+                --depth;
+                break;
+            case Node::Text:
+                break;
+            case Node::EndOfDocument:
+                throw Error("unexpected end of document");
+            }
+        }
+    }
+
+    // Consumes the rest of the current element and returns its concatenated text
+    [[nodiscard]] std::string ReadElementText();
+
+    // Calls handler for every child element of the current element; the handler is entered
+    // right after the child's start tag and must not consume past it. Unconsumed children are
+    // skipped.
+    void ForEachChild(const std::function<void()>& handler)
+    {
+        while (true)
+        {
+            switch (Next())
+            {
+            case Node::StartElement: {
+                const int depth = m_depth;
+                handler();
+                while (m_depth >= depth)
+                {
+                    if (Next() == Node::EndOfDocument)
+                    {
+                        throw Error("unexpected end of document");
+                    }
+                }
+                break;
+            }
+            case Node::EndElement:
+                return;
+            case Node::Text:
+                break;
+            case Node::EndOfDocument:
+                throw Error("unexpected end of document");
+            }
+        }
+    }
+
+    [[nodiscard]] PsarcException Error(std::string_view message) const
+    {
+        return PsarcException(std::format("XML parse error at offset {}: {}", m_pos, message));
+    }
+
+private:
+    static bool IsNameChar(char c)
+    {
+        return c != '>' && c != '/' && c != '=' && c != ' ' && c != '\t' && c != '\r' &&
+               c != '\n';
+    }
+
+    void SkipWhitespace()
+    {
+        while (m_pos < m_xml.size() &&
+               (m_xml[m_pos] == ' ' || m_xml[m_pos] == '\t' || m_xml[m_pos] == '\r' ||
+                m_xml[m_pos] == '\n'))
+        {
+            ++m_pos;
+        }
+    }
+
+    void SkipPast(std::string_view terminator)
+    {
+        const size_t end = m_xml.find(terminator, m_pos);
+        if (end == std::string_view::npos)
+        {
+            throw Error(std::format("missing '{}'", terminator));
+        }
+        m_pos = end + terminator.size();
+    }
+
+    void Expect(char c)
+    {
+        if (m_pos >= m_xml.size() || m_xml[m_pos] != c)
+        {
+            throw Error(std::format("expected '{}'", c));
+        }
+        ++m_pos;
+    }
+
+    std::string_view ReadName()
+    {
+        const size_t start = m_pos;
+        while (m_pos < m_xml.size() && IsNameChar(m_xml[m_pos]))
+        {
+            ++m_pos;
+        }
+        if (m_pos == start)
+        {
+            throw Error("expected a name");
+        }
+        return m_xml.substr(start, m_pos - start);
+    }
+
+    void ReadStartElement()
+    {
+        m_name = ReadName();
+        m_attributes.clear();
+
+        while (true)
+        {
+            SkipWhitespace();
+            if (m_pos >= m_xml.size())
+            {
+                throw Error("unterminated start tag");
+            }
+            if (m_xml[m_pos] == '>')
+            {
+                ++m_pos;
+                return;
+            }
+            if (m_xml[m_pos] == '/')
+            {
+                ++m_pos;
+                Expect('>');
+                m_pending_end = true;
+                return;
+            }
+
+            const auto name = ReadName();
+            SkipWhitespace();
+            Expect('=');
+            SkipWhitespace();
+            if (m_pos >= m_xml.size() || (m_xml[m_pos] != '"' && m_xml[m_pos] != '\''))
+            {
+                throw Error("expected a quoted attribute value");
+            }
+            const char quote = m_xml[m_pos++];
+            const size_t end = m_xml.find(quote, m_pos);
+            if (end == std::string_view::npos)
+            {
+                throw Error("unterminated attribute value");
+            }
+            m_attributes.emplace_back(name, m_xml.substr(m_pos, end - m_pos));
+            m_pos = end + 1;
+        }
+    }
+
+    std::string_view m_xml;
+    size_t m_pos = 0;
+    int m_depth = 0;
+    bool m_pending_end = false;
+    std::string_view m_name;
+    std::string_view m_text;
+    std::vector<Attribute> m_attributes;
+};
+
+std::string DecodeEntities(std::string_view text)
+{
+    std::string result;
+    result.reserve(text.size());
+
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] != '&')
+        {
+            result.push_back(text[i]);
+            continue;
+        }
+
+        const size_t end = text.find(';', i);
+        if (end == std::string_view::npos)
+        {
+            result.push_back(text[i]);
+            continue;
+        }
+
+        const std::string_view entity = text.substr(i + 1, end - i - 1);
+        if (entity == "lt")
+        {
+            result.push_back('<');
+        }
+        else if (entity == "gt")
+        {
+            result.push_back('>');
+        }
+        else if (entity == "amp")
+        {
+            result.push_back('&');
+        }
+        else if (entity == "quot")
+        {
+            result.push_back('"');
+        }
+        else if (entity == "apos")
+        {
+            result.push_back('\'');
+        }
+        else if (entity.starts_with('#'))
+        {
+            const bool hex = entity.size() > 1 && (entity[1] == 'x' || entity[1] == 'X');
+            const std::string_view digits = entity.substr(hex ? 2 : 1);
+            uint32_t code = 0;
+            std::from_chars(digits.data(), digits.data() + digits.size(), code, hex ? 16 : 10);
+
+            // Encode the code point as UTF-8
+            if (code < 0x80)
+            {
+                result.push_back(static_cast<char>(code));
+            }
+            else if (code < 0x800)
+            {
+                result.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            else if (code < 0x10000)
+            {
+                result.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            else
+            {
+                result.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                result.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+        }
+        else
+        {
+            result.append(text.substr(i, end - i + 1));
+        }
+        i = end;
+    }
+
+    return result;
+}
+
+std::string XmlPullReader::ReadElementText()
+{
+    std::string text;
+    int depth = 1;
+    while (depth > 0)
+    {
+        switch (Next())
+        {
+        case Node::StartElement:
+            ++depth;
+            break;
+        case Node::EndElement:
+            --depth;
+            break;
+        case Node::Text:
+            text += DecodeEntities(m_text);
+            break;
+        case Node::EndOfDocument:
+            throw Error("unexpected end of document");
+        }
+    }
+    return text;
+}
+
+float ParseFloat(std::string_view text, float fallback = 0.0f)
+{
+    float value = fallback;
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() ? value : fallback;
+}
+
+// Throws PsarcException unless all of text is an integer that fits in an int
+int ParseInt(std::string_view text, int fallback = 0)
+{
+    if (text.empty())
+    {
+        return fallback;
+    }
+    const char* end = text.data() + text.size();
+    int value = 0;
+    const auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    if (ec == std::errc() && ptr == end)
+    {
+        return value;
+    }
+
+    // Some tools write integral attributes as floats (e.g. anchor width="4.000")
+    if (ec != std::errc::result_out_of_range)
+    {
+        double real = 0;
+        const auto [real_ptr, real_ec] = std::from_chars(text.data(), end, real);
+        constexpr double min = std::numeric_limits<int>::min();
+        constexpr double max = std::numeric_limits<int>::max();
+        if (real_ec == std::errc() && real_ptr == end && real > min - 1 && real < max + 1)
+        {
+            return static_cast<int>(real);
+        }
+    }
+    throw PsarcException(std::format("XML parse error: invalid integer '{}'", text));
+}
+
+float AttrFloat(const XmlPullReader& reader, std::string_view name, float fallback = 0.0f)
+{
+    const auto value = reader.FindAttribute(name);
+    return value ? ParseFloat(*value, fallback) : fallback;
+}
+
+int AttrInt(const XmlPullReader& reader, std::string_view name, int fallback = 0)
+{
+    const auto value = reader.FindAttribute(name);
+    return value ? ParseInt(*value, fallback) : fallback;
+}
+
+std::string AttrString(const XmlPullReader& reader, std::string_view name)
+{
+    const auto value = reader.FindAttribute(name);
+    return value ? DecodeEntities(*value) : std::string();
+}
+
+uint32_t Flag(sng::NoteMask flag)
+{
+    return static_cast<uint32_t>(flag);
+}
+
+bool HasFlag(uint32_t mask, sng::NoteMask flag)
+{
+    return (mask & Flag(flag)) != 0;
+}
+
+// Technique attributes shared by <note> and <chordNote>
+struct NoteTechniques
+{
+    uint32_t mask = 0;
+    int8_t left_hand = -1;
+    int8_t slide_to = -1;
+    int8_t slide_unpitch_to = -1;
+    int8_t tap = -1;
+    int8_t pick_direction = 0;
+    int16_t vibrato = 0;
+    float sustain = 0;
+    float bend = 0;
+};
+
+NoteTechniques ReadNoteTechniques(const XmlPullReader& reader)
+{
+    NoteTechniques t;
+    for (const auto& [name, value] : reader.Attributes())
+    {
+        const int number = ParseInt(value);
+        if (name == "sustain")
+        {
+            t.sustain = ParseFloat(value);
+            if (t.sustain > 0.0f)
+            {
+                t.mask |= Flag(sng::SUSTAIN);
+            }
+        }
+        else if (name == "bend")
+        {
+            t.bend = ParseFloat(value);
+        }
+        else if (name == "leftHand")
+        {
+            t.left_hand = static_cast<int8_t>(number);
+        }
+        else if (name == "slideTo" && number >= 0)
+        {
+            t.mask |= Flag(sng::SLIDE);
+            t.slide_to = static_cast<int8_t>(number);
+        }
+        else if (name == "slideUnpitchTo" && number >= 0)
+        {
+            t.mask |= Flag(sng::SLIDEUNPITCHEDTO);
+            t.slide_unpitch_to = static_cast<int8_t>(number);
+        }
+        else if (name == "tap" && number > 0)
+        {
+            t.mask |= Flag(sng::TAP);
+            t.tap = static_cast<int8_t>(number);
+        }
+        else if (name == "vibrato" && number > 0)
+        {
+            t.mask |= Flag(sng::VIBRATO);
+            t.vibrato = static_cast<int16_t>(number);
+        }
+        else if (name == "pickDirection")
+        {
+            t.pick_direction = static_cast<int8_t>(number);
+        }
+        else if (number != 0)
+        {
+            if (name == "linkNext")
+            {
+                t.mask |= Flag(sng::PARENT);
+            }
+            else if (name == "accent")
+            {
+                t.mask |= Flag(sng::ACCENT);
+            }
+            else if (name == "hammerOn")
+            {
+                t.mask |= Flag(sng::HAMMERON);
+            }
+            else if (name == "pullOff")
+            {
+                t.mask |= Flag(sng::PULLOFF);
+            }
+            else if (name == "harmonic")
+            {
+                t.mask |= Flag(sng::HARMONIC);
+            }
+            else if (name == "harmonicPinch")
+            {
+                t.mask |= Flag(sng::PINCHHARMONIC);
+            }
+            else if (name == "ignore")
+            {
+                t.mask |= Flag(sng::IGNORE);
+            }
+            else if (name == "mute")
+            {
+                t.mask |= Flag(sng::MUTE);
+            }
+            else if (name == "palmMute")
+            {
+                t.mask |= Flag(sng::PALMMUTE);
+            }
+            else if (name == "pluck")
+            {
+                t.mask |= Flag(sng::PLUCK);
+            }
+            else if (name == "slap")
+            {
+                t.mask |= Flag(sng::SLAP);
+            }
+            else if (name == "tremolo")
+            {
+                t.mask |= Flag(sng::TREMOLO);
+            }
+            else if (name == "rightHand")
+            {
+                t.mask |= Flag(sng::RIGHTHAND);
+            }
+        }
+    }
+    if (t.left_hand >= 0)
+    {
+        t.mask |= Flag(sng::LEFTHAND);
+    }
+    return t;
+}
+
+std::vector<sng::BendValue> ReadBendValues(XmlPullReader& reader)
+{
+    std::vector<sng::BendValue> bends;
+    reader.ForEachChild([&] {
+        if (reader.Name() != "bendValues")
+        {
+            return;
+        }
+        reader.ForEachChild([&] {
+            if (reader.Name() == "bendValue")
+            {
+                bends.push_back(
+                    {.time = AttrFloat(reader, "time"), .step = AttrFloat(reader, "step")});
+            }
+        });
+    });
+    return bends;
+}
+
+float MaxBendStep(const std::vector<sng::BendValue>& bends)
+{
+    float max_step = 0.0f;
+    for (const auto& bend : bends)
+    {
+        max_step = std::max(max_step, bend.step);
+    }
+    return max_step;
+}
+
+sng::Note MakeEmptyNote(float time)
+{
+    sng::Note note;
+    note.time = time;
+    note.string = -1;
+    note.fret = -1;
+    note.chord_id = -1;
+    note.chord_notes_id = -1;
+    note.fingerprint_id = {-1, -1};
+    note.next_iteration = -1;
+    note.prev_iteration = -1;
+    note.parent_prev_note = -1;
+    note.slide_to = -1;
+    note.slide_unpitch_to = -1;
+    note.left_hand = -1;
+    note.tap = -1;
+    note.slap = -1;
+    note.pluck = -1;
+    return note;
+}
+
+sng::Note ReadNote(XmlPullReader& reader)
+{
+    sng::Note note = MakeEmptyNote(AttrFloat(reader, "time"));
+    note.string = static_cast<int8_t>(AttrInt(reader, "string"));
+    note.fret = static_cast<int8_t>(AttrInt(reader, "fret"));
+
+    const auto t = ReadNoteTechniques(reader);
+    note.mask = t.mask | Flag(sng::SINGLE);
+    if (note.fret == 0)
+    {
+        note.mask |= Flag(sng::OPEN);
+    }
+    note.left_hand = t.left_hand;
+    note.slide_to = t.slide_to;
+    note.slide_unpitch_to = t.slide_unpitch_to;
+    note.tap = t.tap;
+    note.pick_direction = t.pick_direction;
+    note.vibrato = t.vibrato;
+    note.sustain = t.sustain;
+    note.slap = HasFlag(t.mask, sng::SLAP) ? int8_t{1} : int8_t{-1};
+    note.pluck = HasFlag(t.mask, sng::PLUCK) ? int8_t{1} : int8_t{-1};
+
+    note.bend_values = ReadBendValues(reader);
+    if (!note.bend_values.empty() || t.bend > 0.0f)
+    {
+        note.mask |= Flag(sng::BEND);
+        note.max_bend = std::max(t.bend, MaxBendStep(note.bend_values));
+    }
+    return note;
+}
+
+sng::Note ReadChord(XmlPullReader& reader, sng::SngData& sng)
+{
+    sng::Note note = MakeEmptyNote(AttrFloat(reader, "time"));
+    note.chord_id = AttrInt(reader, "chordId", -1);
+    note.mask = Flag(sng::CHORD);
+
+    static constexpr std::array<std::pair<std::string_view, sng::NoteMask>, 7> g_chord_flags = {{
+        {"linkNext", sng::PARENT},
+        {"accent", sng::ACCENT},
+        {"fretHandMute", sng::FRETHANDMUTE},
+        {"highDensity", sng::HIGHDENSITY},
+        {"ignore", sng::IGNORE},
+        {"palmMute", sng::PALMMUTE},
+        {"hopo", sng::HAMMERON},
+    }};
+    for (const auto& [name, flag] : g_chord_flags)
+    {
+        if (AttrInt(reader, name) != 0)
+        {
+            note.mask |= Flag(flag);
+        }
+    }
+
+    sng::ChordNotes chord_notes;
+    chord_notes.slide_to.fill(-1);
+    chord_notes.slide_unpitch_to.fill(-1);
+    bool has_chord_notes = false;
+    bool has_techniques = false;
+
+    reader.ForEachChild([&] {
+        if (reader.Name() != "chordNote")
+        {
+            return;
+        }
+
+        has_chord_notes = true;
+        const int string = AttrInt(reader, "string", -1);
+        const auto t = ReadNoteTechniques(reader);
+        const auto bends = ReadBendValues(reader);
+        note.sustain = std::max(note.sustain, t.sustain);
+        if (string < 0 || string >= 6)
+        {
+            return;
+        }
+
+        const auto s = static_cast<size_t>(string);
+        chord_notes.mask.at(s) = t.mask & ~Flag(sng::LEFTHAND) & ~Flag(sng::SUSTAIN);
+        chord_notes.slide_to.at(s) = t.slide_to;
+        chord_notes.slide_unpitch_to.at(s) = t.slide_unpitch_to;
+        chord_notes.vibrato.at(s) = t.vibrato;
+        chord_notes.bend_data.at(s).bend_values = bends;
+        chord_notes.bend_data.at(s).used_count = static_cast<int32_t>(bends.size());
+        has_techniques = has_techniques || chord_notes.mask.at(s) != 0 || !bends.empty();
+    });
+
+    if (note.sustain > 0.0f)
+    {
+        note.mask |= Flag(sng::SUSTAIN);
+    }
+    if (has_chord_notes)
+    {
+        note.mask |= Flag(sng::CHORDPANEL);
+    }
+    if (has_techniques)
+    {
+        note.mask |= Flag(sng::CHORDNOTES);
+
+        const auto same = [&](const sng::ChordNotes& other) {
+            return other.mask == chord_notes.mask && other.slide_to == chord_notes.slide_to &&
+                   other.slide_unpitch_to == chord_notes.slide_unpitch_to &&
+                   other.vibrato == chord_notes.vibrato &&
+                   std::ranges::equal(other.bend_data, chord_notes.bend_data,
+                                      [](const sng::BendData& a, const sng::BendData& b) {
+                                          return std::ranges::equal(
+                                              a.bend_values, b.bend_values,
+                                              [](const auto& x, const auto& y) {
+                                                  return x.time == y.time && x.step == y.step;
+                                              });
+                                      });
+        };
+        const auto it = std::ranges::find_if(sng.chord_notes, same);
+        note.chord_notes_id = static_cast<int32_t>(std::distance(sng.chord_notes.begin(), it));
+        if (it == sng.chord_notes.end())
+        {
+            sng.chord_notes.push_back(chord_notes);
+        }
+    }
+    return note;
+}
+
+struct HandShape
+{
+    int32_t chord_id = 0;
+    float start = 0;
+    float end = 0;
+};
+
+void ReadLevel(XmlPullReader& reader, sng::SngData& sng, std::vector<HandShape>& handshapes)
+{
+    auto& arr = sng.arrangements.emplace_back();
+    arr.difficulty = AttrInt(reader, "difficulty");
+
+    reader.ForEachChild([&] {
+        const auto section = reader.Name();
+        reader.ForEachChild([&] {
+            const auto name = reader.Name();
+            if (section == "notes" && name == "note")
+            {
+                arr.notes.push_back(ReadNote(reader));
+            }
+            else if (section == "chords" && name == "chord")
+            {
+                arr.notes.push_back(ReadChord(reader, sng));
+            }
+            else if (section == "anchors" && name == "anchor")
+            {
+                arr.anchors.push_back({.start_time = AttrFloat(reader, "time"),
+                                       .fret = AttrInt(reader, "fret"),
+                                       .width = AttrInt(reader, "width", 4)});
+            }
+            else if (section == "handShapes" && name == "handShape")
+            {
+                handshapes.push_back({.chord_id = AttrInt(reader, "chordId"),
+                                      .start = AttrFloat(reader, "startTime"),
+                                      .end = AttrFloat(reader, "endTime")});
+            }
+        });
+    });
+}
+
+// Index of the last item starting at or before time, or -1
+template <typename T, typename Proj>
+int FindIndexAtTime(const std::vector<T>& items, float time, Proj start)
+{
+    const auto it = std::ranges::upper_bound(items, time, std::less<>{}, start);
+    return static_cast<int>(std::distance(items.begin(), it)) - 1;
+}
+
+void FinalizeSong(sng::SngData& sng)
+{
+    const float song_length = sng.metadata.song_length;
+
+    // Beats: number beats within measures and link them to phrase iterations
+    int16_t measure = -1;
+    int16_t beat = 0;
+    for (auto& bpm : sng.bpms)
+    {
+        if ((bpm.mask & 0x01) != 0)
+        {
+            measure = bpm.measure;
+            beat = 0;
+        }
+        else
+        {
+            bpm.measure = measure;
+            ++beat;
+        }
+        bpm.beat = beat;
+        bpm.phrase_iteration =
+            std::max(0, FindIndexAtTime(sng.phrase_iterations, bpm.time,
+                                        &sng::PhraseIteration::start_time));
+    }
+    if (sng.bpms.size() > 1)
+    {
+        sng.metadata.first_beat_length = sng.bpms[1].time - sng.bpms[0].time;
+    }
+
+    for (size_t i = 0; i < sng.phrase_iterations.size(); ++i)
+    {
+        auto& pi = sng.phrase_iterations[i];
+        pi.next_phrase_time =
+            i + 1 < sng.phrase_iterations.size() ? sng.phrase_iterations[i + 1].start_time
+                                                 : song_length;
+        if (pi.phrase_id >= 0 && std::cmp_less(pi.phrase_id, sng.phrases.size()))
+        {
+            ++sng.phrases[pi.phrase_id].phrase_iteration_links;
+        }
+    }
+
+    for (size_t i = 0; i < sng.sections.size(); ++i)
+    {
+        auto& section = sng.sections[i];
+        section.end_time =
+            i + 1 < sng.sections.size() ? sng.sections[i + 1].start_time : song_length;
+        section.start_phrase_iteration_index =
+            std::max(0, FindIndexAtTime(sng.phrase_iterations, section.start_time,
+                                        &sng::PhraseIteration::start_time));
+        section.end_phrase_iteration_index =
+            std::max(0, FindIndexAtTime(sng.phrase_iterations, section.end_time - 0.001f,
+                                        &sng::PhraseIteration::start_time));
+    }
+}
+
+void FinalizeArrangement(sng::SngData& sng, sng::Arrangement& arr,
+                         const std::vector<HandShape>& handshapes)
+{
+    const float song_length = sng.metadata.song_length;
+    const auto& iterations = sng.phrase_iterations;
+
+    std::ranges::stable_sort(arr.notes, std::less<>{}, &sng::Note::time);
+    std::ranges::stable_sort(arr.anchors, std::less<>{}, &sng::Anchor::start_time);
+
+    for (size_t i = 0; i < arr.anchors.size(); ++i)
+    {
+        auto& anchor = arr.anchors[i];
+        anchor.end_time =
+            i + 1 < arr.anchors.size() ? arr.anchors[i + 1].start_time : song_length;
+        anchor.phrase_iteration_index =
+            FindIndexAtTime(iterations, anchor.start_time, &sng::PhraseIteration::start_time);
+    }
+
+    // Arpeggio chord templates are flagged with mask 1 (see SngXmlWriter display names)
+    for (const auto& hs : handshapes)
+    {
+        const bool arpeggio = hs.chord_id >= 0 && std::cmp_less(hs.chord_id, sng.chords.size()) &&
+                              sng.chords[hs.chord_id].mask == 1;
+        (arpeggio ? arr.fingerprints_arpeggio : arr.fingerprints_handshape)
+            .push_back({.chord_id = hs.chord_id, .start_time = hs.start, .end_time = hs.end});
+    }
+
+    const auto find_fingerprint = [](const std::vector<sng::Fingerprint>& fps, float time) {
+        for (size_t i = 0; i < fps.size(); ++i)
+        {
+            if (fps[i].start_time <= time && time < fps[i].end_time)
+            {
+                return static_cast<int16_t>(i);
+            }
+        }
+        return int16_t{-1};
+    };
+
+    std::array<int, 6> last_on_string{-1, -1, -1, -1, -1, -1};
+    std::vector<int32_t> notes_per_iteration1(iterations.size());
+    std::vector<int32_t> notes_per_iteration2(iterations.size());
+
+    // Notes link to their neighbours by 16-bit index
+    if (arr.notes.size() > static_cast<size_t>(std::numeric_limits<int16_t>::max()))
+    {
+        throw PsarcException(std::format("Level {} has {} notes; SNG holds at most {} per level",
+                                         arr.difficulty, arr.notes.size(),
+                                         std::numeric_limits<int16_t>::max()));
+    }
+    for (size_t i = 0; i < arr.notes.size(); ++i)
+    {
+        auto& note = arr.notes[i];
+        const auto index = static_cast<int16_t>(i);
+        note.prev_iteration = i > 0 ? static_cast<int16_t>(index - 1) : int16_t{-1};
+        note.next_iteration =
+            i + 1 < arr.notes.size() ? static_cast<int16_t>(index + 1) : int16_t{-1};
+
+        const int pi = FindIndexAtTime(iterations, note.time, &sng::PhraseIteration::start_time);
+        if (pi >= 0)
+        {
+            note.phrase_iteration_id = pi;
+            note.phrase_id = iterations[pi].phrase_id;
+            ++notes_per_iteration1[pi];
+            if (!HasFlag(note.mask, sng::IGNORE))
+            {
+                ++notes_per_iteration2[pi];
+            }
+        }
+
+        const int anchor = FindIndexAtTime(arr.anchors, note.time, &sng::Anchor::start_time);
+        if (anchor >= 0)
+        {
+            note.anchor_fret = static_cast<int8_t>(arr.anchors[anchor].fret);
+            note.anchor_width = static_cast<int8_t>(arr.anchors[anchor].width);
+        }
+
+        note.fingerprint_id[0] = find_fingerprint(arr.fingerprints_handshape, note.time);
+        note.fingerprint_id[1] = find_fingerprint(arr.fingerprints_arpeggio, note.time);
+
+        if (note.string >= 0 && note.string < 6)
+        {
+            auto& last = last_on_string.at(static_cast<size_t>(note.string));
+            if (last >= 0 && HasFlag(arr.notes[last].mask, sng::PARENT))
+            {
+                note.mask |= Flag(sng::CHILD);
+                note.parent_prev_note = static_cast<int16_t>(last);
+            }
+            last = static_cast<int>(i);
+        }
+    }
+
+    // Average note count per phrase across its iterations
+    arr.phrase_count = static_cast<int32_t>(sng.phrases.size());
+    arr.average_notes_per_iteration.assign(sng.phrases.size(), 0.0f);
+    for (size_t p = 0; p < sng.phrases.size(); ++p)
+    {
+        int iteration_count = 0;
+        int note_count = 0;
+        for (size_t i = 0; i < iterations.size(); ++i)
+        {
+            if (std::cmp_equal(iterations[i].phrase_id, p))
+            {
+                ++iteration_count;
+                note_count += notes_per_iteration1[i];
+            }
+        }
+        if (iteration_count > 0)
+        {
+            arr.average_notes_per_iteration[p] = static_cast<float>(note_count) /
+                                                 static_cast<float>(iteration_count);
+        }
+    }
+
+    arr.phrase_iteration_count1 = static_cast<int32_t>(iterations.size());
+    arr.notes_in_iteration1 = std::move(notes_per_iteration1);
+    arr.phrase_iteration_count2 = static_cast<int32_t>(iterations.size());
+    arr.notes_in_iteration2 = std::move(notes_per_iteration2);
+}
+
+void FinalizeMetadata(sng::SngData& sng)
+{
+    auto& meta = sng.metadata;
+    meta.string_count = static_cast<int32_t>(meta.tuning.size());
+
+    float first_note = meta.song_length;
+    for (const auto& arr : sng.arrangements)
+    {
+        meta.max_difficulty = std::max(meta.max_difficulty, arr.difficulty);
+        if (!arr.notes.empty())
+        {
+            first_note = std::min(first_note, arr.notes.front().time);
+        }
+    }
+    meta.first_note_time = first_note;
+    meta.first_note_time2 = first_note;
+
+    // Playable notes are the ones in each phrase iteration's hardest level
+    double notes = 0;
+    double notes_real = 0;
+    for (const auto& pi : sng.phrase_iterations)
+    {
+        if (pi.phrase_id < 0 || std::cmp_greater_equal(pi.phrase_id, sng.phrases.size()))
+        {
+            continue;
+        }
+        const int difficulty = sng.phrases[pi.phrase_id].max_difficulty;
+        for (const auto& arr : sng.arrangements)
+        {
+            if (arr.difficulty != difficulty)
+            {
+                continue;
+            }
+            for (const auto& note : arr.notes)
+            {
+                if (note.time >= pi.start_time && note.time < pi.next_phrase_time)
+                {
+                    notes += 1;
+                    notes_real += HasFlag(note.mask, sng::IGNORE) ? 0 : 1;
+                }
+            }
+        }
+    }
+
+    meta.max_score = 100000.0;
+    meta.max_notes_and_chords = notes;
+    meta.max_notes_and_chords_real = notes_real;
+    meta.point_per_note = notes > 0 ? meta.max_score / notes : 0.0;
+}
+
+void ReadSongChild(XmlPullReader& reader, sng::SngData& sng,
+                   std::vector<std::vector<HandShape>>& handshapes, float& offset)
+{
+    const auto name = reader.Name();
+    auto& meta = sng.metadata;
+
+    if (name == "part")
+    {
+        meta.part = static_cast<int16_t>(ParseInt(reader.ReadElementText()));
+    }
+    else if (name == "offset")
+    {
+        offset = ParseFloat(reader.ReadElementText());
+    }
+    else if (name == "songLength")
+    {
+        meta.song_length = ParseFloat(reader.ReadElementText());
+    }
+    else if (name == "startBeat")
+    {
+        meta.start_time = ParseFloat(reader.ReadElementText());
+    }
+    else if (name == "capo")
+    {
+        const int capo = ParseInt(reader.ReadElementText());
+        meta.capo_fret_id = capo > 0 ? static_cast<int8_t>(capo) : int8_t{-1};
+    }
+    else if (name == "lastConversionDateTime")
+    {
+        meta.last_conversion_date_time = reader.ReadElementText();
+    }
+    else if (name == "tuning")
+    {
+        meta.tuning.resize(6);
+        for (size_t i = 0; i < meta.tuning.size(); ++i)
+        {
+            meta.tuning[i] = static_cast<int16_t>(AttrInt(reader, std::format("string{}", i)));
+        }
+    }
+    else if (name == "phrases")
+    {
+        reader.ForEachChild([&] {
+            sng.phrases.push_back({.solo = static_cast<uint8_t>(AttrInt(reader, "solo")),
+                                   .disparity = static_cast<uint8_t>(AttrInt(reader, "disparity")),
+                                   .ignore = static_cast<uint8_t>(AttrInt(reader, "ignore")),
+                                   .max_difficulty = AttrInt(reader, "maxDifficulty"),
+                                   .name = AttrString(reader, "name")});
+        });
+    }
+    else if (name == "phraseIterations")
+    {
+        reader.ForEachChild([&] {
+            auto& pi = sng.phrase_iterations.emplace_back();
+            pi.start_time = AttrFloat(reader, "time");
+            pi.phrase_id = AttrInt(reader, "phraseId");
+            reader.ForEachChild([&] {
+                reader.ForEachChild([&] {
+                    const int hero = AttrInt(reader, "hero");
+                    if (hero >= 1 && hero <= 3)
+                    {
+                        pi.difficulty.at(static_cast<size_t>(hero - 1)) =
+                            AttrInt(reader, "difficulty");
+                    }
+                });
+            });
+        });
+    }
+    else if (name == "newLinkedDiffs")
+    {
+        reader.ForEachChild([&] {
+            auto& nld = sng.nlinked_difficulties.emplace_back();
+            nld.level_break = AttrInt(reader, "levelBreak", -1);
+            reader.ForEachChild(
+                [&] { nld.nld_phrases.push_back(AttrInt(reader, "id")); });
+        });
+    }
+    else if (name == "phraseProperties")
+    {
+        reader.ForEachChild([&] {
+            sng.phrase_extra_infos.push_back(
+                {.phrase_id = AttrInt(reader, "phraseId"),
+                 .difficulty = AttrInt(reader, "difficulty"),
+                 .empty = AttrInt(reader, "empty"),
+                 .level_jump = static_cast<uint8_t>(AttrInt(reader, "levelJump")),
+                 .redundant = static_cast<int16_t>(AttrInt(reader, "redundant"))});
+        });
+    }
+    else if (name == "chordTemplates")
+    {
+        reader.ForEachChild([&] {
+            auto& chord = sng.chords.emplace_back();
+            chord.name = AttrString(reader, "chordName");
+            const std::string display_name = AttrString(reader, "displayName");
+            if (display_name.ends_with("-arp"))
+            {
+                chord.mask = 1;
+            }
+            else if (display_name.ends_with("-nop"))
+            {
+                chord.mask = 2;
+            }
+            for (size_t i = 0; i < 6; ++i)
+            {
+                chord.frets.at(i) =
+                    static_cast<int8_t>(AttrInt(reader, std::format("fret{}", i), -1));
+                chord.fingers.at(i) =
+                    static_cast<int8_t>(AttrInt(reader, std::format("finger{}", i), -1));
+            }
+        });
+    }
+    else if (name == "ebeats")
+    {
+        reader.ForEachChild([&] {
+            auto& bpm = sng.bpms.emplace_back();
+            bpm.time = AttrFloat(reader, "time");
+            const int measure = AttrInt(reader, "measure", -1);
+            if (measure >= 0)
+            {
+                bpm.measure = static_cast<int16_t>(measure);
+                bpm.mask = 0x01;
+            }
+        });
+    }
+    else if (name == "tones")
+    {
+        reader.ForEachChild([&] {
+            sng.tones.push_back(
+                {.time = AttrFloat(reader, "time"), .tone_id = AttrInt(reader, "id")});
+        });
+    }
+    else if (name == "sections")
+    {
+        reader.ForEachChild([&] {
+            sng.sections.push_back({.name = AttrString(reader, "name"),
+                                    .number = AttrInt(reader, "number"),
+                                    .start_time = AttrFloat(reader, "startTime")});
+        });
+    }
+    else if (name == "events")
+    {
+        reader.ForEachChild([&] {
+            sng.events.push_back({.time = AttrFloat(reader, "time"),
+                                  .name = AttrString(reader, "code")});
+        });
+    }
+    else if (name == "levels")
+    {
+        reader.ForEachChild([&] {
+            if (reader.Name() == "level")
+            {
+                ReadLevel(reader, sng, handshapes.emplace_back());
+            }
+        });
+    }
+}
+
+} // namespace
+
+sng::SngData SngXmlReader::Read(const std::filesystem::path& input_path)
+{
+    std::ifstream in(input_path, std::ios::binary);
+    if (!in)
+    {
+        throw PsarcException(std::format("Failed to open file: {}", input_path.string()));
+    }
+
+    const std::string xml{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    return Parse(xml);
+}
+
+sng::SngData SngXmlReader::Parse(std::string_view xml)
+{
+    XmlPullReader reader(xml);
+    sng::SngData sng;
+
+    XmlPullReader::Node node = reader.Next();
+    while (node == XmlPullReader::Node::Text)
+    {
+        node = reader.Next();
+    }
+    if (node != XmlPullReader::Node::StartElement)
+    {
+        throw reader.Error("missing root element");
+    }
+
+    if (reader.Name() == "vocals")
+    {
+        reader.ForEachChild([&] {
+            sng.vocals.push_back({.time = AttrFloat(reader, "time"),
+                                  .note = AttrInt(reader, "note"),
+                                  .length = AttrFloat(reader, "length"),
+                                  .lyric = AttrString(reader, "lyric")});
+        });
+        return sng;
+    }
+
+    if (reader.Name() != "song")
+    {
+        throw reader.Error(std::format("unexpected root element '{}'", reader.Name()));
+    }
+
+    std::vector<std::vector<HandShape>> handshapes;
+    float offset = 0.0f;
+    bool has_start_beat = false;
+    reader.ForEachChild([&] {
+        has_start_beat = has_start_beat || reader.Name() == "startBeat";
+        ReadSongChild(reader, sng, handshapes, offset);
+    });
+
+    if (!has_start_beat)
+    {
+        sng.metadata.start_time = -offset;
+    }
+    if (sng.metadata.tuning.empty())
+    {
+        sng.metadata.tuning.resize(6);
+    }
+
+    FinalizeSong(sng);
+    for (size_t i = 0; i < sng.arrangements.size(); ++i)
+    {
+        FinalizeArrangement(sng, sng.arrangements[i], handshapes[i]);
+    }
+    FinalizeMetadata(sng);
+
+    return sng;
+}
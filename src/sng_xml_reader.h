@@ -0,0 +1,15 @@
+#pragma once
+
+#include "sng_types.h"
+
+#include <filesystem>
+#include <string_view>
+
+class SngXmlReader
+{
+public:
+    // Builds SNG data from arrangement or vocals XML, deriving the fields the XML omits (note
+    // masks, phrase/anchor/handshape links, beat numbering, per-phrase note counts)
+    [[nodiscard]] static sng::SngData Read(const std::filesystem::path& input_path);
+    [[nodiscard]] static sng::SngData Parse(std::string_view xml);
+};
@@ -1,6 +1,7 @@
 #include "sng_xml_writer.h"
 
 #include "open-psarc/psarc_file.h"
+#include "trace.h"
 
 #include <algorithm>
 #include <array>
@@ -34,6 +35,16 @@ bool Has(uint32_t mask, sng::NoteMask flag)
     return (mask & static_cast<uint32_t>(flag)) != 0;
 }
 
+void SaveDocument(const pugi::xml_document& doc, const std::filesystem::path& output_path)
+{
+    PSARC_TRACE_SCOPE("SaveXml");
+    if (!doc.save_file(output_path.string().c_str(), "  ", pugi::format_default,
+                       pugi::encoding_utf8))
+    {
+        throw PsarcException(std::format("Failed to write XML: {}", output_path.string()));
+    }
+}
+
 void WriteVocalXml(const sng::SngData& sng, const std::filesystem::path& output_path)
 {
     pugi::xml_document doc;
@@ -53,11 +64,7 @@ void WriteVocalXml(const sng::SngData& sng, const std::filesystem::path& output_
         node.append_attribute("lyric") = vocal.lyric.c_str();
     }
 
-    if (!doc.save_file(output_path.string().c_str(), "  ", pugi::format_default,
-                       pugi::encoding_utf8))
-    {
-        throw PsarcException(std::format("Failed to write XML: {}", output_path.string()));
-    }
+    SaveDocument(doc, output_path);
 }
 
 void WriteArrangementProperties(pugi::xml_node song, const SngManifestArrangementProperties& props)
@@ -694,11 +701,7 @@ void WriteInstrumentalXml(const sng::SngData& sng, const std::filesystem::path&
         }
     }
 
-    if (!doc.save_file(output_path.string().c_str(), "  ", pugi::format_default,
-                       pugi::encoding_utf8))
-    {
-        throw PsarcException(std::format("Failed to write XML: {}", output_path.string()));
-    }
+    SaveDocument(doc, output_path);
 }
 
 } // namespace
@@ -706,6 +709,7 @@ void WriteInstrumentalXml(const sng::SngData& sng, const std::filesystem::path&
 void SngXmlWriter::Write(const sng::SngData& sng, const std::filesystem::path& output_path,
                          const SngManifestMetadata* manifest)
 {
+    PSARC_TRACE_SCOPE("SngXmlWriter::Write");
     if (!sng.vocals.empty())
     {
         WriteVocalXml(sng, output_path);
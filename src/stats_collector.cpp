@@ -0,0 +1,81 @@
+#include "stats_collector.h"
+
+void StatsCollector::Add(Counter counter, uint64_t value)
+{
+    m_counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void StatsCollector::Resize(std::vector<uint8_t>& buffer, size_t size)
+{
+    if (size > buffer.capacity())
+    {
+        Add(Counter::BufferAllocations);
+    }
+    buffer.resize(size);
+}
+
+PsarcStats StatsCollector::GetStats() const
+{
+    const auto load = [&](Counter counter) {
+        return m_counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    };
+    const auto load_phase = [&](Phase phase) {
+        const auto& counters = m_phases[static_cast<size_t>(phase)];
+        PsarcPhaseStats result;
+        result.runs = counters.runs.load(std::memory_order_relaxed);
+        result.wall_time =
+            std::chrono::nanoseconds(counters.wall_ns.load(std::memory_order_relaxed));
+        result.cpu_time = std::chrono::nanoseconds(counters.cpu_ns.load(std::memory_order_relaxed));
+        return result;
+    };
+
+    PsarcStats stats;
+    stats.bytes_read = load(Counter::BytesRead);
+    stats.compressed_bytes = load(Counter::CompressedBytes);
+    stats.uncompressed_bytes = load(Counter::UncompressedBytes);
+    stats.blocks_inflated = load(Counter::BlocksInflated);
+    stats.blocks_stored = load(Counter::BlocksStored);
+    stats.buffer_allocations = load(Counter::BufferAllocations);
+    stats.bytes_decrypted = load(Counter::BytesDecrypted);
+    stats.files_written = load(Counter::FilesWritten);
+    stats.bytes_written = load(Counter::BytesWritten);
+    stats.open = load_phase(Phase::Open);
+    stats.extract = load_phase(Phase::Extract);
+    stats.audio = load_phase(Phase::Audio);
+    stats.sng = load_phase(Phase::Sng);
+    stats.verify = load_phase(Phase::Verify);
+    return stats;
+}
+
+void StatsCollector::Reset()
+{
+    for (auto& counter : m_counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto& phase : m_phases)
+    {
+        phase.runs.store(0, std::memory_order_relaxed);
+        phase.wall_ns.store(0, std::memory_order_relaxed);
+        phase.cpu_ns.store(0, std::memory_order_relaxed);
+    }
+}
+
+StatsCollector::PhaseTimer::PhaseTimer(StatsCollector& stats, Phase phase)
+    : m_stats(stats), m_phase(phase), m_wall_start(std::chrono::steady_clock::now()),
+      m_cpu_start(std::clock())
+{
+}
+
+StatsCollector::PhaseTimer::~PhaseTimer()
+{
+    const auto wall = std::chrono::steady_clock::now() - m_wall_start;
+    const auto cpu_ticks = static_cast<double>(std::clock() - m_cpu_start);
+
+    auto& phase = m_stats.m_phases[static_cast<size_t>(m_phase)];
+    phase.runs.fetch_add(1, std::memory_order_relaxed);
+    phase.wall_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(wall).count(),
+                            std::memory_order_relaxed);
+    phase.cpu_ns.fetch_add(static_cast<int64_t>(cpu_ticks * 1e9 / CLOCKS_PER_SEC),
+                           std::memory_order_relaxed);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "open-psarc/psarc_file.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+// Counters behind PsarcFile::GetStats(). Workers update them with relaxed atomics, so a snapshot
+// taken while an operation runs is approximate but never torn per counter.
+class StatsCollector
+{
+public:
+    enum class Counter : uint8_t
+    {
+        BytesRead,
+        CompressedBytes,
+        UncompressedBytes,
+        BlocksInflated,
+        BlocksStored,
+        BufferAllocations,
+        BytesDecrypted,
+        FilesWritten,
+        BytesWritten,
+        Count,
+    };
+
+    enum class Phase : uint8_t
+    {
+        Open,
+        Extract,
+        Audio,
+        Sng,
+        Verify,
+        Count,
+    };
+
+    void Add(Counter counter, uint64_t value = 1);
+
+    // Resizes buffer, counting an allocation when it has to grow past its capacity
+    void Resize(std::vector<uint8_t>& buffer, size_t size);
+
+    [[nodiscard]] PsarcStats GetStats() const;
+    void Reset();
+
+    // Adds the wall and process CPU time of its lifetime to a phase
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer(StatsCollector& stats, Phase phase);
+        ~PhaseTimer();
+
+        PhaseTimer(const PhaseTimer&) = delete;
+        PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+    private:
+        StatsCollector& m_stats;
+        Phase m_phase;
+        std::chrono::steady_clock::time_point m_wall_start;
+        std::clock_t m_cpu_start;
+    };
+
+private:
+    struct PhaseCounters
+    {
+        std::atomic<uint64_t> runs{0};
+        std::atomic<int64_t> wall_ns{0};
+        std::atomic<int64_t> cpu_ns{0};
+    };
+
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(Counter::Count)> m_counters{};
+    std::array<PhaseCounters, static_cast<size_t>(Phase::Count)> m_phases;
+};
@@ -0,0 +1,230 @@
+#include "trace.h"
+
+#include "open-psarc/psarc_file.h"
+#include "open-psarc/psarc_trace.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace
+{
+
+// Per-thread ring size; once full, the oldest spans are overwritten and counted as dropped
+constexpr size_t g_ring_capacity = 16384;
+constexpr size_t g_detail_capacity = 63;
+
+struct TraceEvent
+{
+    const char* name = nullptr;
+    std::array<char, g_detail_capacity> detail{};
+    uint8_t detail_size = 0;
+    uint64_t start = 0;
+    uint64_t duration = 0;
+};
+
+// Written by its owning thread and read by the exporter; the mutex is only ever contended while
+// Start() or WriteChromeTrace() runs
+struct ThreadBuffer
+{
+    std::mutex mutex;
+    uint32_t thread_index = 0;
+    std::vector<TraceEvent> events; // Grows to g_ring_capacity, then wraps at next
+    size_t next = 0;
+    uint64_t dropped = 0;
+};
+
+struct TraceState
+{
+    std::atomic<bool> recording{false};
+    std::atomic<uint64_t> origin{0};
+
+    std::mutex mutex; // Guards buffers and next_thread_index
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint32_t next_thread_index = 0;
+};
+
+TraceState& GetState()
+{
+    static TraceState state;
+    return state;
+}
+
+uint64_t Now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// The state keeps a reference too, so spans of exited worker threads survive until exported
+ThreadBuffer& GetThreadBuffer()
+{
+    thread_local const std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto created = std::make_shared<ThreadBuffer>();
+        auto& state = GetState();
+        const std::scoped_lock lock(state.mutex);
+        created->thread_index = state.next_thread_index++;
+        state.buffers.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+void Record(const char* name, std::string_view detail, uint64_t start, uint64_t end)
+{
+    TraceEvent event;
+    event.name = name;
+    // Long details (entry paths) keep their end, which is the distinguishing part. The cut moves
+    // past UTF-8 continuation bytes so it never splits a character.
+    if (detail.size() > g_detail_capacity)
+    {
+        size_t cut = detail.size() - g_detail_capacity;
+        while (cut < detail.size() && (static_cast<uint8_t>(detail[cut]) & 0xC0) == 0x80)
+        {
+            ++cut;
+        }
+        detail.remove_prefix(cut);
+    }
+    event.detail_size = static_cast<uint8_t>(detail.size());
+    std::ranges::copy(detail, event.detail.begin());
+    event.start = start;
+    event.duration = end - start;
+
+    auto& buffer = GetThreadBuffer();
+    const std::scoped_lock lock(buffer.mutex);
+    if (buffer.events.size() < g_ring_capacity)
+    {
+        buffer.events.push_back(event);
+        return;
+    }
+    buffer.events[buffer.next] = event;
+    buffer.next = (buffer.next + 1) % g_ring_capacity;
+    ++buffer.dropped;
+}
+
+} // namespace
+
+TraceSpan::TraceSpan(const char* name, std::string_view detail)
+{
+    if (!GetState().recording.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    m_name = name;
+    m_detail = detail;
+    m_start = Now();
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (m_name)
+    {
+        Record(m_name, m_detail, m_start, Now());
+    }
+}
+
+bool PsarcTrace::IsAvailable()
+{
+#ifdef OPEN_PSARC_ENABLE_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PsarcTrace::Start()
+{
+    auto& state = GetState();
+    const std::scoped_lock lock(state.mutex);
+
+    // Buffers referenced only by the state belong to threads that have exited
+    std::erase_if(state.buffers, [](const auto& buffer) { return buffer.use_count() == 1; });
+    for (const auto& buffer : state.buffers)
+    {
+        const std::scoped_lock buffer_lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->next = 0;
+        buffer->dropped = 0;
+    }
+
+    state.origin = Now();
+    state.recording = true;
+}
+
+void PsarcTrace::Stop()
+{
+    GetState().recording = false;
+}
+
+void PsarcTrace::WriteChromeTrace(const std::string& path)
+{
+    auto& state = GetState();
+    const uint64_t origin = state.origin;
+
+    auto events = nlohmann::json::array();
+    uint64_t dropped = 0;
+    {
+        const std::scoped_lock lock(state.mutex);
+        for (const auto& buffer : state.buffers)
+        {
+            const std::scoped_lock buffer_lock(buffer->mutex);
+            if (buffer->events.empty())
+            {
+                continue;
+            }
+
+            const auto thread_name = std::format("thread {}", buffer->thread_index);
+            events.push_back({{"name", "thread_name"},
+                              {"ph", "M"},
+                              {"pid", 1},
+                              {"tid", buffer->thread_index},
+                              {"args", {{"name", thread_name}}}});
+
+            for (const auto& event : buffer->events)
+            {
+                // Chrome trace timestamps are microseconds
+                nlohmann::json json_event = {
+                    {"name", event.name},
+                    {"cat", "open-psarc"},
+                    {"ph", "X"},
+                    {"ts", static_cast<double>(event.start - std::min(origin, event.start)) / 1e3},
+                    {"dur", static_cast<double>(event.duration) / 1e3},
+                    {"pid", 1},
+                    {"tid", buffer->thread_index}};
+                if (event.detail_size > 0)
+                {
+                    json_event["args"] = {
+                        {"detail", std::string(event.detail.data(), event.detail_size)}};
+                }
+                events.push_back(std::move(json_event));
+            }
+            dropped += buffer->dropped;
+        }
+    }
+
+    const nlohmann::json trace = {{"traceEvents", std::move(events)},
+                                  {"displayTimeUnit", "ms"},
+                                  {"otherData", {{"dropped_events", dropped}}}};
+
+    std::ofstream out(path);
+    if (!out)
+    {
+        throw PsarcException(std::format("Failed to create file: {}", path));
+    }
+    // Entry names come from the archive and need not be valid UTF-8
+    out << trace.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+    if (!out)
+    {
+        throw PsarcException(std::format("Failed to write file: {}", path));
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// Scoped trace spans. With OPEN_PSARC_ENABLE_TRACING undefined the macros expand to nothing, so
+// instrumented code pays nothing; with it defined, a span costs a relaxed load while PsarcTrace
+// is stopped and two clock reads plus a buffer write while it is recording.
+#ifdef OPEN_PSARC_ENABLE_TRACING
+#define PSARC_TRACE_CONCAT_IMPL(a, b) a##b
+#define PSARC_TRACE_CONCAT(a, b) PSARC_TRACE_CONCAT_IMPL(a, b)
+#define PSARC_TRACE_SCOPE(name) const TraceSpan PSARC_TRACE_CONCAT(trace_span_, __LINE__)(name)
+#define PSARC_TRACE_SCOPE_DETAIL(name, detail)                                                    \
+    const TraceSpan PSARC_TRACE_CONCAT(trace_span_, __LINE__)(name, detail)
+#else
+#define PSARC_TRACE_SCOPE(name) static_cast<void>(0)
+#define PSARC_TRACE_SCOPE_DETAIL(name, detail) static_cast<void>(0)
+#endif
+
+class TraceSpan
+{
+public:
+    // name must be a string literal. detail (e.g. an entry name) is copied when the span ends, so
+    // it must outlive the span.
+    explicit TraceSpan(const char* name, std::string_view detail = {});
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* m_name = nullptr; // Null when tracing was stopped at construction
+    std::string_view m_detail;
+    uint64_t m_start = 0;
+};
@@ -0,0 +1,1166 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "fixture_generator.h"
+#include "sng_parser.h"
+
+#include <open-psarc/psarc_archive_pool.h>
+#include <open-psarc/psarc_catalog.h>
+#include <open-psarc/psarc_file.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+std::filesystem::path GetFixturePath(const std::string& name)
+{
+    const auto directory = std::filesystem::path(TEST_BINARY_DIR) / "generated";
+    std::filesystem::create_directories(directory);
+    return directory / name;
+}
+
+void CheckExtractsEntries(const FixtureArchiveSpec& spec, const std::string& file_name)
+{
+    const auto path = GetFixturePath(file_name);
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+
+    REQUIRE(psarc.GetFileCount() == spec.entry_count + 1);
+    CHECK(psarc.Verify().empty());
+    for (int i = 0; i < spec.entry_count; ++i)
+    {
+        const auto expected = FixtureGenerator::MakeEntry(spec, i);
+        CHECK(names[i] == expected.name);
+        CHECK(psarc.ExtractFile(expected.name) == expected.data);
+    }
+}
+
+// Reads from memory and records the ranges it is asked to prefetch
+class RecordingSource : public PsarcByteSource
+{
+public:
+    explicit RecordingSource(std::vector<uint8_t> data) : m_data(std::move(data))
+    {
+    }
+
+    [[nodiscard]] uint64_t GetSize() const override
+    {
+        return m_data.size();
+    }
+
+    [[nodiscard]] size_t ReadAt(uint64_t offset, std::span<uint8_t> buffer) const override
+    {
+        const auto count = std::min<uint64_t>(buffer.size(), m_data.size() - offset);
+        std::copy_n(m_data.begin() + static_cast<std::ptrdiff_t>(offset), count, buffer.begin());
+        return count;
+    }
+
+    void Prefetch(uint64_t offset, uint64_t length) const override
+    {
+        const std::scoped_lock lock(m_mutex);
+        m_prefetched.emplace_back(offset, offset + length);
+    }
+
+    [[nodiscard]] std::vector<std::pair<uint64_t, uint64_t>> TakePrefetched() const
+    {
+        const std::scoped_lock lock(m_mutex);
+        return std::exchange(m_prefetched, {});
+    }
+
+private:
+    std::vector<uint8_t> m_data;
+    mutable std::mutex m_mutex;
+    mutable std::vector<std::pair<uint64_t, uint64_t>> m_prefetched;
+};
+
+// Reads from memory slowly enough that reads issued by concurrent tasks overlap, and records
+// how many were in flight at once
+class ConcurrencySource : public PsarcByteSource
+{
+public:
+    explicit ConcurrencySource(std::vector<uint8_t> data) : m_data(std::move(data))
+    {
+    }
+
+    [[nodiscard]] uint64_t GetSize() const override
+    {
+        return m_data.size();
+    }
+
+    [[nodiscard]] size_t ReadAt(uint64_t offset, std::span<uint8_t> buffer) const override
+    {
+        const int in_flight = ++m_in_flight;
+        int max = m_max_in_flight.load();
+        while (in_flight > max && !m_max_in_flight.compare_exchange_weak(max, in_flight))
+        {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        const auto count = std::min<uint64_t>(buffer.size(), m_data.size() - offset);
+        std::copy_n(m_data.begin() + static_cast<std::ptrdiff_t>(offset), count, buffer.begin());
+        --m_in_flight;
+        return count;
+    }
+
+    [[nodiscard]] int TakeMaxInFlight() const
+    {
+        return m_max_in_flight.exchange(0);
+    }
+
+private:
+    std::vector<uint8_t> m_data;
+    mutable std::atomic<int> m_in_flight{0};
+    mutable std::atomic<int> m_max_in_flight{0};
+};
+
+FixtureArchiveSpec MakeMixedSpec()
+{
+    FixtureArchiveSpec spec;
+    spec.entry_count = 24;
+    spec.min_entry_size = 0;
+    spec.max_entry_size = 100000;
+    spec.incompressible_ratio = 0.25;
+    spec.seed = 7;
+    return spec;
+}
+
+} // namespace
+
+TEST_CASE("Generated zlib archives with encrypted TOC extract their entries", "[psarc][fixture]")
+{
+    CheckExtractsEntries(MakeMixedSpec(), "entries_zlib.psarc");
+}
+
+TEST_CASE("Generated LZMA archives with small blocks extract their entries", "[psarc][fixture]")
+{
+    auto spec = MakeMixedSpec();
+    spec.compression_method = {'l', 'z', 'm', 'a'};
+    spec.block_size = 16384;
+    spec.encrypt_toc = false;
+    CheckExtractsEntries(spec, "entries_lzma.psarc");
+}
+
+TEST_CASE("Stats count the blocks and bytes read by extraction", "[psarc][stats]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 8;
+    const auto path = GetFixturePath("stats.psarc");
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    CHECK(psarc.GetStats().open.runs == 1);
+    CHECK(psarc.GetStats().bytes_decrypted > 0);
+
+    psarc.ResetStats();
+    uint64_t expected_bytes = 0;
+    for (int i = 0; i < spec.entry_count; ++i)
+    {
+        expected_bytes += psarc.ExtractFile(names[i]).size();
+    }
+
+    const auto stats = psarc.GetStats();
+    CHECK(stats.open.runs == 0);
+    CHECK(stats.uncompressed_bytes == expected_bytes);
+    CHECK(stats.blocks_inflated + stats.blocks_stored > 0);
+    CHECK(stats.bytes_read >= stats.compressed_bytes);
+    CHECK(stats.compressed_bytes < stats.uncompressed_bytes);
+}
+
+TEST_CASE("Entry info describes the stored blocks of an entry", "[psarc][info]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 4;
+    spec.block_size = 16384;
+    const auto path = GetFixturePath("entry_info.psarc");
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    const auto infos = psarc.GetEntryInfoList();
+    REQUIRE(infos.size() == static_cast<size_t>(psarc.GetFileCount()));
+
+    for (const auto& info : infos)
+    {
+        CHECK(info.name == psarc.GetFileList()[info.index]);
+        CHECK(info.uncompressed_size == psarc.GetFileSize(info.name));
+        CHECK(info.block_count == (info.uncompressed_size + spec.block_size - 1) / spec.block_size);
+        CHECK(info.stored_blocks <= info.block_count);
+    }
+
+    // The generator packs the blocks of all entries back to back up to the end of the file
+    auto by_offset = infos;
+    std::ranges::sort(by_offset, {}, &PsarcEntryInfo::offset);
+    for (size_t i = 1; i < by_offset.size(); ++i)
+    {
+        CHECK(by_offset[i].offset == by_offset[i - 1].offset + by_offset[i - 1].compressed_size);
+    }
+    CHECK(by_offset.back().offset + by_offset.back().compressed_size ==
+          std::filesystem::file_size(path));
+
+    const auto info = psarc.GetEntryInfo(names[0]);
+    CHECK(info.name == names[0]);
+    CHECK(info.index == 1);
+    CHECK(info.md5 != decltype(info.md5){});
+    CHECK_THROWS_AS(psarc.GetEntryInfo("missing"), PsarcException);
+}
+
+TEST_CASE("Entry views enumerate the archive without copying names", "[psarc]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 6;
+    const auto path = GetFixturePath("entry_views.psarc");
+    FixtureGenerator::GenerateArchive(path, spec);
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    const auto names = psarc.GetFileList();
+    const auto entries = psarc.GetEntries();
+    REQUIRE(entries.size() == names.size());
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        CHECK(entries[i].name == names[i]);
+        CHECK(entries[i].size == psarc.GetFileSize(names[i]));
+        CHECK(psarc.GetEntry(entries[i].index).name == entries[i].name);
+        CHECK(psarc.GetEntryInfo(entries[i].index).name == names[i]);
+    }
+    CHECK(psarc.GetEntry(0).name == "NamesBlock.bin");
+    CHECK_THROWS_AS(psarc.GetEntry(psarc.GetFileCount()), PsarcException);
+    CHECK_THROWS_AS(psarc.GetEntry(-1), PsarcException);
+}
+
+TEST_CASE("Archives open from memory and mapped byte sources", "[psarc][source]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 8;
+    const auto path = GetFixturePath("sources.psarc");
+    FixtureGenerator::GenerateArchive(path, spec);
+
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> bytes(std::istreambuf_iterator<char>(in), {});
+
+    const std::shared_ptr<PsarcByteSource> sources[] = {
+        PsarcByteSource::FromMemory(std::span<const uint8_t>(bytes)),
+        PsarcByteSource::FromMemory(bytes),
+        PsarcByteSource::MapFile(path.string()),
+        PsarcByteSource::OpenFile(path.string()),
+    };
+    for (const auto& source : sources)
+    {
+        REQUIRE(source->GetSize() == bytes.size());
+
+        PsarcFile psarc(source, "upload.psarc");
+        psarc.Open();
+        REQUIRE(psarc.GetFileCount() == spec.entry_count + 1);
+        CHECK(psarc.Verify().empty());
+        for (int i = 0; i < spec.entry_count; ++i)
+        {
+            const auto expected = FixtureGenerator::MakeEntry(spec, i);
+            CHECK(psarc.ExtractFile(expected.name) == expected.data);
+        }
+
+        // Workers read the shared source through streams of their own
+        const auto report = psarc.ExtractAll(GetFixturePath("sources_out").string(),
+                                             {.thread_count = 4});
+        CHECK(report.Succeeded());
+        CHECK_THROWS_AS(psarc.Compact(), PsarcException);
+    }
+}
+
+TEST_CASE("Verify reports entries whose blocks or TOC records are corrupt", "[psarc][verify]")
+{
+    FixtureArchiveSpec spec;
+    spec.block_size = 16384;
+    spec.encrypt_toc = false;
+    std::vector<FixtureEntry> entries;
+    for (const char* name : {"block.txt", "z_length.txt", "offset.txt", "intact.txt"})
+    {
+        const auto seed = static_cast<uint32_t>(entries.size());
+        entries.push_back({.name = name, .data = FixtureGenerator::MakeEntryData(40000, seed)});
+    }
+    entries.push_back(
+        {.name = "tail.bin", .data = FixtureGenerator::MakeEntryData(1000, 9, false)});
+
+    const auto path = GetFixturePath("verify.psarc");
+    FixtureGenerator::WriteArchive(path, entries, spec);
+
+    std::vector<uint8_t> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    const auto read_be = [&](size_t offset, int count) {
+        uint64_t value = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            value = (value << 8) | bytes[offset + i];
+        }
+        return value;
+    };
+    const auto write_be = [&](size_t offset, int count, uint64_t value) {
+        for (int i = count - 1; i >= 0; --i, value >>= 8)
+        {
+            bytes[offset + i] = static_cast<uint8_t>(value);
+        }
+    };
+
+    // Header: TOC entry size at 16, entry count at 20; 2-byte z-lengths follow the TOC entries
+    const auto entry_size = static_cast<size_t>(read_be(16, 4));
+    const auto z_lengths = 32 + entry_size * read_be(20, 4);
+    std::vector<PsarcEntryInfo> infos;
+    {
+        PsarcFile psarc(path.string());
+        psarc.Open();
+        for (const auto& entry : entries)
+        {
+            infos.push_back(psarc.GetEntryInfo(entry.name));
+        }
+    }
+    REQUIRE(infos[4].block_count == 1);
+    REQUIRE(infos[4].compressed_size >= entries[4].data.size());
+
+    bytes[infos[0].offset + infos[0].compressed_size / 3] ^= 0xFF;
+    write_be(z_lengths + 2 * infos[1].start_chunk_index, 2, 7);
+    // Offsets past the end are rejected by Open, so point this one at another entry's blocks
+    write_be(32 + entry_size * infos[2].index + 25, 5, infos[3].offset);
+    // A final partial block may also be stored raw with a z-length of 0, as extraction accepts
+    std::ranges::copy(entries[4].data,
+                      bytes.begin() + static_cast<std::ptrdiff_t>(infos[4].offset));
+    write_be(z_lengths + 2 * infos[4].start_chunk_index, 2, 0);
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        out.write(reinterpret_cast<const char*>(bytes.data()),
+                  static_cast<std::streamsize>(bytes.size()));
+    }
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    CHECK(psarc.ExtractFile("tail.bin") == entries[4].data);
+
+    std::vector<PsarcProgress> progress;
+    const auto errors = psarc.Verify(
+        {.thread_count = 3, .progress = [&](const PsarcProgress& p) { progress.push_back(p); }});
+    REQUIRE(errors.size() == 3);
+    CHECK(errors[0].starts_with("block.txt: "));
+    CHECK(errors[1].starts_with("z_length.txt: "));
+    CHECK(errors[2].starts_with("offset.txt: "));
+    REQUIRE_FALSE(progress.empty());
+    CHECK(progress.back().entries_done == progress.back().entries_total);
+    CHECK(progress.back().bytes_done == progress.back().bytes_total);
+
+    CHECK(psarc.Verify({.entries = {"intact.txt", "tail.bin"}}).empty());
+
+    std::stop_source stop;
+    stop.request_stop();
+    CHECK_THROWS_AS(psarc.Verify({.stop_token = stop.get_token()}), PsarcCancelledException);
+}
+
+TEST_CASE("Open rejects TOC entries larger than their stored blocks allow", "[psarc][toc]")
+{
+    // One entry of block_count blocks, each with the given z-length, followed by stored_size bytes
+    const auto make_archive = [](uint32_t block_count, uint16_t z_length, size_t stored_size) {
+        constexpr uint32_t block_size = 65536;
+        constexpr uint32_t entry_size = 30;
+        const auto toc_length = static_cast<uint32_t>(32 + entry_size + 2 * block_count);
+        std::vector<uint8_t> bytes(toc_length + stored_size);
+        const auto write_be = [&](size_t offset, int count, uint64_t value) {
+            for (int i = count - 1; i >= 0; --i, value >>= 8)
+            {
+                bytes[offset + i] = static_cast<uint8_t>(value);
+            }
+        };
+        std::ranges::copy(std::string_view("PSAR\0\x01\0\x04zlib", 12), bytes.begin());
+        write_be(12, 4, toc_length);
+        write_be(16, 4, entry_size);
+        write_be(20, 4, 1);
+        write_be(24, 4, block_size);
+        write_be(32 + 20, 5, uint64_t{block_count} * block_size);
+        write_be(32 + 25, 5, toc_length);
+        for (uint32_t i = 0; i < block_count; ++i)
+        {
+            write_be(32 + entry_size + 2 * i, 2, z_length);
+        }
+        return bytes;
+    };
+    const auto open_error = [](std::vector<uint8_t> bytes) {
+        PsarcFile psarc(PsarcByteSource::FromMemory(std::move(bytes)), "crafted.psarc");
+        try
+        {
+            psarc.Open();
+        }
+        catch (const PsarcException& e)
+        {
+            return std::string(e.what());
+        }
+        return std::string();
+    };
+
+    // 120 KB that would otherwise allocate 3.7 GB for the manifest before failing
+    CHECK(open_error(make_archive(60000, 100, 0)).find("runs past the end of the archive") !=
+          std::string::npos);
+    // The stored bytes are present, but could never inflate to the declared size
+    CHECK(open_error(make_archive(1, 10, 10)).find("claims 65536 bytes from 10 stored bytes") !=
+          std::string::npos);
+}
+
+TEST_CASE("Audio conversion keeps BNK and WEM work within the thread and memory limits",
+          "[psarc][audio]")
+{
+    FixtureArchiveSpec spec;
+    spec.encrypt_toc = false;
+    std::vector<FixtureEntry> entries;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const auto extension = i < 6 ? "bnk" : "wem";
+        entries.push_back({.name = std::format("audio/{}.{}", 100 + i, extension),
+                           .data = FixtureGenerator::MakeEntryData(30000, i, false)});
+    }
+    const auto path = GetFixturePath("audio_limits.psarc");
+    FixtureGenerator::WriteArchive(path, entries, spec);
+
+    std::vector<uint8_t> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    const auto source = std::make_shared<ConcurrencySource>(std::move(bytes));
+    PsarcFile psarc(source, "audio_limits.psarc");
+    psarc.Open();
+    const auto output_directory = GetFixturePath("audio_limits_out").string();
+
+    // None of the entries is valid audio, so every one is read and then fails to convert
+    const auto check_report = [](const PsarcReport& report) {
+        CHECK_FALSE(report.Succeeded());
+        CHECK(report.Count(PsarcEntryStatus::Failed) == report.entries.size());
+        CHECK(std::ranges::count_if(report.entries, [](const PsarcEntryResult& result) {
+                  return result.name.ends_with(".wem");
+              }) == 2);
+    };
+
+    check_report(psarc.ConvertAudio(output_directory, {.thread_count = 4, .memory_budget = 1}));
+    CHECK(source->TakeMaxInFlight() == 1);
+
+    check_report(psarc.ConvertAudio(output_directory, {.thread_count = 1}));
+    CHECK(source->TakeMaxInFlight() == 1);
+
+    check_report(psarc.ConvertAudio(output_directory, {.thread_count = 4}));
+    CHECK(source->TakeMaxInFlight() > 1);
+}
+
+TEST_CASE("Archive pool shares opened archives until they change or are evicted", "[psarc][pool]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 6;
+    const auto first_path = GetFixturePath("pool_first.psarc");
+    const auto second_path = GetFixturePath("pool_second.psarc");
+    FixtureGenerator::GenerateArchive(first_path, spec);
+    FixtureGenerator::GenerateArchive(second_path, spec);
+
+    PsarcArchivePool pool({.max_archives = 1});
+    const auto first = pool.Acquire(first_path.string());
+    CHECK(pool.Acquire(first_path.string()) == first);
+
+    // Readers on several threads share the cached archive. Catch assertions are not thread-safe,
+    // so the threads only count mismatches.
+    std::atomic<int> mismatches{0};
+    std::vector<std::jthread> readers;
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&] {
+            const auto archive = pool.Acquire(first_path.string());
+            for (int i = 0; i < spec.entry_count; ++i)
+            {
+                const auto expected = FixtureGenerator::MakeEntry(spec, i);
+                if (archive->ExtractFile(expected.name) != expected.data)
+                {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    readers.clear();
+    CHECK(mismatches == 0);
+
+    auto stats = pool.GetStats();
+    CHECK(stats.misses == 1);
+    CHECK(stats.hits == 5);
+    CHECK(stats.memory >= first->GetMemoryUsage());
+
+    // Opening a second archive evicts the first, which stays usable for its holder
+    CHECK(pool.Acquire(second_path.string()) != first);
+    CHECK(pool.GetStats().evictions == 1);
+    CHECK(first->ExtractFile(FixtureGenerator::MakeEntry(spec, 0).name).size() ==
+          first->GetFileSize(FixtureGenerator::MakeEntry(spec, 0).name));
+
+    // Rewriting the file on disk invalidates the cached copy
+    const auto second = pool.Acquire(second_path.string());
+    spec.entry_count = 3;
+    FixtureGenerator::GenerateArchive(second_path, spec);
+    const auto reopened = pool.Acquire(second_path.string());
+    CHECK(reopened != second);
+    CHECK(reopened->GetFileCount() == spec.entry_count + 1);
+
+    stats = pool.GetStats();
+    CHECK(stats.invalidations == 1);
+    CHECK(stats.archives == 1);
+    CHECK_THROWS_AS(pool.Acquire(GetFixturePath("missing.psarc").string()), PsarcException);
+}
+
+TEST_CASE("Block cache serves repeated extractions without reading the archive", "[psarc][cache]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 6;
+    spec.block_size = 16384;
+    const auto path = GetFixturePath("block_cache.psarc");
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+
+    const auto cache = std::make_shared<PsarcBlockCache>(64 << 20);
+    PsarcFile psarc(path.string());
+    PsarcFile other(path.string());
+    psarc.SetBlockCache(cache);
+    other.SetBlockCache(cache);
+    psarc.Open();
+    other.Open();
+
+    for (int i = 0; i < spec.entry_count; ++i)
+    {
+        CHECK(psarc.ExtractFile(names[i]) == FixtureGenerator::MakeEntry(spec, i).data);
+    }
+    const auto filled = cache->GetStats();
+    CHECK(filled.hits == 0);
+    CHECK(filled.blocks == filled.misses);
+
+    // Every block is now cached, so nothing is read or inflated again
+    psarc.ResetStats();
+    for (int i = spec.entry_count - 1; i >= 0; --i)
+    {
+        CHECK(psarc.ExtractFile(names[i]) == FixtureGenerator::MakeEntry(spec, i).data);
+    }
+    CHECK(psarc.GetStats().bytes_read == 0);
+    CHECK(cache->GetStats().hits == filled.misses);
+
+    // Another opening of the archive has blocks of its own
+    CHECK(other.ExtractFile(names[0]) == FixtureGenerator::MakeEntry(spec, 0).data);
+    CHECK(cache->GetStats().blocks > filled.blocks);
+
+    // A cache smaller than the data keeps only the most recent blocks
+    const auto small = std::make_shared<PsarcBlockCache>(spec.block_size * 2);
+    psarc.SetBlockCache(small);
+    for (int i = 0; i < spec.entry_count; ++i)
+    {
+        CHECK(psarc.ExtractFile(names[i]) == FixtureGenerator::MakeEntry(spec, i).data);
+    }
+    CHECK(small->GetStats().bytes <= spec.block_size * 2);
+    CHECK(small->GetStats().evictions > 0);
+}
+
+TEST_CASE("Outputs written after a cached extraction leave the cache intact", "[psarc][cache]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 6;
+    spec.min_entry_size = 1;
+    const auto path = GetFixturePath("output_cache.psarc");
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+    const auto output_directory = GetFixturePath("output_cache_out");
+    const auto cache_directory = GetFixturePath("output_cache_store");
+    std::filesystem::remove_all(output_directory);
+    std::filesystem::remove_all(cache_directory);
+
+    const auto read_bytes = [](const std::filesystem::path& file) {
+        std::ifstream in(file, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {});
+    };
+    const auto read_cache = [&] {
+        std::map<std::filesystem::path, std::vector<uint8_t>> files;
+        for (const auto& item : std::filesystem::recursive_directory_iterator(cache_directory))
+        {
+            if (item.is_regular_file())
+            {
+                files[item.path()] = read_bytes(item.path());
+            }
+        }
+        return files;
+    };
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    const PsarcOptions cached{.cache_directory = cache_directory.string()};
+    CHECK(psarc.ExtractAll(output_directory.string(), cached).Count(PsarcEntryStatus::Cached) ==
+          0);
+    const auto cache = read_cache();
+    const auto file_count = static_cast<size_t>(psarc.GetFileCount());
+    REQUIRE(cache.size() == file_count);
+
+    const auto report = psarc.ExtractAll(output_directory.string(), cached);
+    CHECK(report.Count(PsarcEntryStatus::Cached) == file_count);
+    for (int i = 0; i < spec.entry_count; ++i)
+    {
+        const auto output_path = output_directory / names[i];
+        CHECK(std::filesystem::hard_link_count(output_path) == 1);
+        CHECK(read_bytes(output_path) == FixtureGenerator::MakeEntry(spec, i).data);
+    }
+
+    // Overwrite the outputs with different content, without the cache
+    const std::vector<uint8_t> replacement(5000, 0xA5);
+    psarc.ReplaceFile(names[0], replacement);
+    CHECK(psarc.ExtractAll(output_directory.string(), {}).Succeeded());
+    psarc.ExtractFileTo(names[0], (output_directory / names[1]).string());
+    CHECK(read_bytes(output_directory / names[0]) == replacement);
+    CHECK(read_bytes(output_directory / names[1]) == replacement);
+    CHECK(read_cache() == cache);
+
+    // The replaced entry is a miss; the rest are still served from the cache
+    CHECK(psarc.ExtractAll(output_directory.string(), cached).Count(PsarcEntryStatus::Cached) ==
+          file_count - 1);
+    CHECK(read_bytes(output_directory / names[0]) == replacement);
+    CHECK(read_bytes(output_directory / names[1]) == FixtureGenerator::MakeEntry(spec, 1).data);
+}
+
+TEST_CASE("Incremental extraction skips entries whose output is up to date", "[psarc][incremental]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 6;
+    spec.min_entry_size = 1;
+    const auto path = GetFixturePath("incremental.psarc");
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+    const auto output_directory = GetFixturePath("incremental_out");
+    const auto state_path = output_directory / ".incremental.psarc.state.json";
+    std::filesystem::remove_all(output_directory);
+
+    const auto write_text = [](const std::filesystem::path& file, const std::string& text) {
+        std::ofstream out(file, std::ios::trunc);
+        out << text;
+    };
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    const PsarcOptions options{.incremental = true};
+    const auto first = psarc.ExtractAll(output_directory.string(), options);
+    const size_t entry_count = first.entries.size();
+    CHECK(first.Count(PsarcEntryStatus::Succeeded) == entry_count);
+    REQUIRE(std::filesystem::exists(state_path));
+
+    CHECK(psarc.ExtractAll(output_directory.string(), options).Count(PsarcEntryStatus::Skipped) ==
+          entry_count);
+
+    SECTION("Changed entries and outputs are extracted again")
+    {
+        const std::vector<uint8_t> replacement(3000, 0x3C);
+        psarc.ReplaceFile(names[0], replacement);
+        std::filesystem::resize_file(output_directory / names[1], 1);
+
+        const auto report = psarc.ExtractAll(output_directory.string(), options);
+        CHECK(report.Count(PsarcEntryStatus::Succeeded) == 2);
+        CHECK(report.Count(PsarcEntryStatus::Skipped) == entry_count - 2);
+        CHECK(psarc.ExtractFile(names[0]) == replacement);
+        CHECK(std::filesystem::file_size(output_directory / names[0]) == replacement.size());
+        CHECK(std::filesystem::file_size(output_directory / names[1]) ==
+              FixtureGenerator::MakeEntry(spec, 1).data.size());
+    }
+
+    SECTION("A corrupt sidecar extracts everything and is rewritten")
+    {
+        write_text(state_path, "{\"version\": 1, \"entries\": ");
+        CHECK(psarc.ExtractAll(output_directory.string(), options)
+                  .Count(PsarcEntryStatus::Succeeded) == entry_count);
+        CHECK(psarc.ExtractAll(output_directory.string(), options)
+                  .Count(PsarcEntryStatus::Skipped) == entry_count);
+    }
+
+    SECTION("A sidecar from another version extracts everything")
+    {
+        std::ifstream in(state_path);
+        std::string text(std::istreambuf_iterator<char>(in), {});
+        in.close();
+        const auto version = text.find("\"version\": 1");
+        REQUIRE(version != std::string::npos);
+        text.replace(version, 12, "\"version\": 0");
+        write_text(state_path, text);
+
+        CHECK(psarc.ExtractAll(output_directory.string(), options)
+                  .Count(PsarcEntryStatus::Succeeded) == entry_count);
+        CHECK(psarc.ExtractAll(output_directory.string(), options)
+                  .Count(PsarcEntryStatus::Skipped) == entry_count);
+    }
+}
+
+TEST_CASE("Catalogs find entries across archives without opening them", "[psarc][catalog]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 5;
+    const auto first_path = GetFixturePath("catalog_first.psarc").string();
+    const auto first_names = FixtureGenerator::GenerateArchive(first_path, spec);
+    spec.seed = 8;
+    spec.sng_count = 1;
+    const auto second_path = GetFixturePath("catalog_second.psarc").string();
+    const auto second_names = FixtureGenerator::GenerateArchive(second_path, spec);
+
+    PsarcCatalogBuilder builder;
+    builder.AddArchive(first_path);
+    builder.AddArchive(second_path);
+    const auto catalog_path = GetFixturePath("library.catalog").string();
+    builder.Save(catalog_path);
+
+    const auto catalog = PsarcCatalog::Load(catalog_path);
+    REQUIRE(catalog.GetArchiveCount() == 2);
+    CHECK(catalog.GetArchivePath(1) == second_path);
+
+    PsarcFile first(first_path);
+    PsarcFile second(second_path);
+    first.Open();
+    second.Open();
+    CHECK(catalog.GetEntryCount() == first.GetEntries().size() + second.GetEntries().size());
+    for (const auto& name : second_names)
+    {
+        const auto found = catalog.FindAll(name);
+        REQUIRE_FALSE(found.empty());
+        CHECK(found.back().archive_path == second_path);
+        CHECK(second.GetEntry(found.back().index).name == name);
+        CHECK(found.back().size == second.GetFileSize(name));
+    }
+    CHECK(catalog.Find(first_names[0])->archive_path == first_path);
+    CHECK_FALSE(catalog.Find("songs/bin/generic/missing.sng"));
+
+    // The in-memory image reads the same as the saved file
+    const PsarcCatalog image(PsarcByteSource::FromMemory(builder.Build()));
+    CHECK(image.Find(second_names[0])->index == catalog.Find(second_names[0])->index);
+
+    auto corrupt = builder.Build();
+    corrupt.resize(corrupt.size() - 1);
+    CHECK_THROWS_AS(PsarcCatalog(PsarcByteSource::FromMemory(std::move(corrupt))),
+                    PsarcException);
+}
+
+TEST_CASE("Prefetch hints the stored ranges of the named entries", "[psarc][source]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 12;
+    const auto path = GetFixturePath("prefetch.psarc");
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+
+    std::ifstream in(path, std::ios::binary);
+    const auto source = std::make_shared<RecordingSource>(
+        std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {}));
+    PsarcFile psarc(source);
+    psarc.Open();
+
+    const std::vector<std::string> wanted = {names[1], names[7], "missing.json"};
+    psarc.Prefetch(wanted);
+    const auto ranges = source->TakePrefetched();
+    REQUIRE_FALSE(ranges.empty());
+    for (const auto& name : {names[1], names[7]})
+    {
+        const auto info = psarc.GetEntryInfo(name);
+        if (info.compressed_size == 0)
+        {
+            continue;
+        }
+        CHECK(std::ranges::any_of(ranges, [&](const auto& range) {
+            return range.first <= info.offset &&
+                   info.offset + info.compressed_size <= range.second;
+        }));
+    }
+
+    // Neighbouring entries are merged into a single hint
+    std::vector<std::string> all(names.begin(), names.end());
+    psarc.Prefetch(all);
+    CHECK(source->TakePrefetched().size() == 1);
+}
+
+TEST_CASE("Generated SNG entries decrypt to the requested arrangement", "[psarc][fixture][sng]")
+{
+    FixtureArchiveSpec spec;
+    spec.entry_count = 0;
+    spec.sng_count = 2;
+    spec.sng = {.levels = 3, .notes_per_level = 200, .chord_interval = 10, .chord_templates = 2};
+
+    const auto path = GetFixturePath("songs.psarc");
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+    REQUIRE(names.size() == 4);
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+
+    const auto sng = SngParser::Parse(psarc.ExtractFile(names[0]));
+    REQUIRE(sng.arrangements.size() == 3);
+    CHECK(sng.chords.size() == 2);
+    CHECK(sng.arrangements[2].notes.size() == 200);
+    CHECK(sng.metadata.max_difficulty == 2);
+}
+
+TEST_CASE("SNG entries decrypt into the caller's buffer", "[psarc][sng]")
+{
+    FixtureArchiveSpec spec;
+    spec.entry_count = 0;
+    spec.sng_count = 2;
+    spec.sng = {.levels = 2, .notes_per_level = 300};
+
+    const auto path = GetFixturePath("songs_buffer.psarc");
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    const auto first = psarc.ExtractFile(names[0]);
+    const auto second = psarc.ExtractFile(names[2]);
+
+    std::vector<uint8_t> output;
+    output.reserve(4 * std::max(first.size(), second.size()));
+    const auto* data = output.data();
+    const auto capacity = output.capacity();
+
+    psarc.ExtractFile(names[0], output);
+    CHECK(output == first);
+    psarc.ResetStats();
+    psarc.ExtractFile(names[2], output);
+    CHECK(output == second);
+    psarc.ExtractFile(names[0], output);
+    CHECK(output == first);
+
+    CHECK(output.data() == data);
+    CHECK(output.capacity() == capacity);
+    CHECK(psarc.GetStats().buffer_allocations == 0);
+}
+
+TEST_CASE("Extraction stops when cancelled from the progress callback", "[psarc][progress]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 32;
+    spec.min_entry_size = 20000;
+    const auto path = GetFixturePath("cancel.psarc");
+    FixtureGenerator::GenerateArchive(path, spec);
+    const auto output_directory = GetFixturePath("cancel_out");
+    std::filesystem::remove_all(output_directory);
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+
+    std::stop_source stop;
+    std::vector<PsarcProgress> progress;
+    PsarcOptions options;
+    options.thread_count = GENERATE(1U, 4U);
+    options.incremental = true;
+    options.stop_token = stop.get_token();
+    options.progress = [&](const PsarcProgress& update) {
+        progress.push_back(update);
+        if (update.entries_done >= 8)
+        {
+            stop.request_stop();
+        }
+    };
+
+    CHECK_THROWS_AS(psarc.ExtractAll(output_directory.string(), options),
+                    PsarcCancelledException);
+    REQUIRE_FALSE(progress.empty());
+    for (size_t i = 1; i < progress.size(); ++i)
+    {
+        CHECK(progress[i].entries_done >= progress[i - 1].entries_done);
+        CHECK(progress[i].bytes_done >= progress[i - 1].bytes_done);
+        CHECK(progress[i].bytes_done <= progress[i].bytes_total);
+    }
+    const auto cancelled_at = progress.back();
+    CHECK(cancelled_at.entries_done >= 8);
+    CHECK(cancelled_at.entries_done < cancelled_at.entries_total);
+
+    // Entries finished before the stop were recorded, so a rerun picks up where it left off
+    options.stop_token = {};
+    options.progress = nullptr;
+    const auto report = psarc.ExtractAll(output_directory.string(), options);
+    CHECK(report.Succeeded());
+    CHECK(report.Count(PsarcEntryStatus::Skipped) >= 8);
+    CHECK(report.Count(PsarcEntryStatus::Succeeded) > 0);
+}
+
+TEST_CASE("Bulk reports record a failed entry without stopping the others", "[psarc][report]")
+{
+    FixtureArchiveSpec spec;
+    spec.encrypt_toc = false;
+    std::vector<FixtureEntry> entries;
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        entries.push_back({.name = std::format("data/entry_{}.txt", i),
+                           .data = FixtureGenerator::MakeEntryData(30000, i)});
+    }
+    const auto path = GetFixturePath("outcomes.psarc");
+    FixtureGenerator::WriteArchive(path, entries, spec);
+
+    // Garble the stored data of the fourth entry
+    uint64_t corrupt_offset = 0;
+    {
+        PsarcFile psarc(path.string());
+        psarc.Open();
+        const auto info = psarc.GetEntryInfo(entries[3].name);
+        corrupt_offset = info.offset + info.compressed_size / 2;
+    }
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(corrupt_offset));
+        const std::string garbage(64, '\x5A');
+        file.write(garbage.data(), static_cast<std::streamsize>(garbage.size()));
+    }
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    const auto output_directory = GetFixturePath("outcomes_out");
+    const auto report =
+        psarc.ExtractAll(output_directory.string(), {.thread_count = GENERATE(1U, 3U)});
+
+    CHECK_FALSE(report.Succeeded());
+    CHECK(report.Count(PsarcEntryStatus::Failed) == 1);
+    CHECK(report.Count(PsarcEntryStatus::Succeeded) == report.entries.size() - 1);
+    CHECK(report.GetFailedEntries() == std::vector<std::string>{entries[3].name});
+    for (const auto& result : report.entries)
+    {
+        if (result.name == entries[3].name)
+        {
+            CHECK(result.error_code == PsarcErrorCode::ReadFailed);
+            CHECK_FALSE(result.message.empty());
+            continue;
+        }
+        CHECK(result.error_code == PsarcErrorCode::None);
+    }
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (i != 3)
+        {
+            std::ifstream in(output_directory / entries[i].name, std::ios::binary);
+            CHECK(std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {}) ==
+                  entries[i].data);
+        }
+    }
+}
+
+TEST_CASE("Archive info totals entry sizes from the TOC", "[psarc][info]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 12;
+    const auto path = GetFixturePath("info.psarc");
+    FixtureGenerator::GenerateArchive(path, spec);
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    psarc.ResetStats();
+    const auto info = psarc.GetArchiveInfo(3);
+    CHECK(psarc.GetStats().bytes_read == 0);
+
+    uint64_t expected_size = 0;
+    for (const auto& name : psarc.GetFileList())
+    {
+        expected_size += psarc.GetFileSize(name);
+    }
+    CHECK(info.entry_count == static_cast<uint64_t>(psarc.GetFileCount()));
+    CHECK(info.uncompressed_size == expected_size);
+    CHECK(info.compressed_size < info.archive_size);
+    CHECK(info.block_size == spec.block_size);
+    CHECK(info.toc_encrypted);
+
+    uint64_t extension_entries = 0;
+    for (const auto& extension : info.extensions)
+    {
+        extension_entries += extension.entry_count;
+    }
+    CHECK(extension_entries == info.entry_count);
+
+    REQUIRE(info.largest_entries.size() == 3);
+    CHECK(info.largest_entries[0].uncompressed_size >= info.largest_entries[1].uncompressed_size);
+    CHECK(info.largest_entries[0].block_count > 0);
+}
+
+TEST_CASE("Replaced entries extract, verify and survive compaction", "[psarc][edit]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 8;
+    spec.block_size = 16384;
+    const auto path = GetFixturePath("replace.psarc");
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+
+    // More blocks than the entry had, so the TOC grows into the first entry's data
+    std::vector<uint8_t> replacement(spec.block_size * 5 + 123);
+    for (size_t i = 0; i < replacement.size(); ++i)
+    {
+        replacement[i] = static_cast<uint8_t>(i * 7 / 3);
+    }
+
+    const auto check_archive = [&](const PsarcFile& psarc) {
+        CHECK(psarc.Verify().empty());
+        CHECK(psarc.ExtractFile(names[2]) == replacement);
+        for (int i = 0; i < spec.entry_count; ++i)
+        {
+            if (i != 2)
+            {
+                CHECK(psarc.ExtractFile(names[i]) == FixtureGenerator::MakeEntry(spec, i).data);
+            }
+        }
+
+        // No z-lengths are left behind for the replaced blocks
+        auto infos = psarc.GetEntryInfoList();
+        std::ranges::sort(infos, {}, &PsarcEntryInfo::start_chunk_index);
+        for (size_t i = 1; i < infos.size(); ++i)
+        {
+            CHECK(infos[i].start_chunk_index ==
+                  infos[i - 1].start_chunk_index + infos[i - 1].block_count);
+        }
+    };
+
+    {
+        PsarcFile psarc(path.string());
+        psarc.Open();
+        psarc.ReplaceFile(names[2], replacement);
+        check_archive(psarc);
+        psarc.ReplaceFile(names[2], replacement);
+        check_archive(psarc);
+    }
+    CHECK_FALSE(std::filesystem::exists(path.string() + ".journal"));
+
+    const auto replaced_size = std::filesystem::file_size(path);
+    {
+        PsarcFile psarc(path.string());
+        psarc.Open();
+        check_archive(psarc);
+        psarc.Compact();
+        check_archive(psarc);
+    }
+    CHECK(std::filesystem::file_size(path) < replaced_size);
+
+    PsarcFile psarc(path.string());
+    psarc.Open();
+    check_archive(psarc);
+}
+
+TEST_CASE("Opening an archive finishes an interrupted TOC rewrite", "[psarc][edit]")
+{
+    auto spec = MakeMixedSpec();
+    spec.entry_count = 6;
+    const auto path = GetFixturePath("journal.psarc");
+    const auto journal_path = path.string() + ".journal";
+    const auto names = FixtureGenerator::GenerateArchive(path, spec);
+
+    const auto read_bytes = [](const std::filesystem::path& file) {
+        std::ifstream in(file, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), {});
+    };
+    const auto write_bytes = [](const std::filesystem::path& file, std::span<const uint8_t> data) {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        out.write(reinterpret_cast<const char*>(data.data()),
+                  static_cast<std::streamsize>(data.size()));
+    };
+    const auto crc32 = [](std::span<const uint8_t> data) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (const uint8_t byte : data)
+        {
+            crc ^= byte;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    };
+
+    const auto before = read_bytes(path);
+    const std::vector<uint8_t> replacement(70000, 0x5A);
+    {
+        PsarcFile psarc(path.string());
+        psarc.Open();
+        psarc.ReplaceFile(names[1], replacement);
+    }
+    const auto after = read_bytes(path);
+    const auto read_toc_length = [](const std::vector<uint8_t>& archive) {
+        return (uint32_t{archive[12]} << 24) | (uint32_t{archive[13]} << 16) |
+               (archive[14] << 8) | archive[15];
+    };
+    const uint32_t old_toc_length = read_toc_length(before);
+    const uint32_t toc_length = read_toc_length(after);
+    const size_t appended_offset = std::max<size_t>(before.size(), toc_length);
+
+    // Target: archive size, old TOC length and CRC, appended blocks' offset and CRC; then the new
+    // header and TOC, then a CRC of everything before it
+    std::vector<uint8_t> journal;
+    const auto append_be = [&](uint64_t value, int count) {
+        for (int shift = (count - 1) * 8; shift >= 0; shift -= 8)
+        {
+            journal.push_back(static_cast<uint8_t>(value >> shift));
+        }
+    };
+    append_be(after.size(), 8);
+    append_be(old_toc_length, 4);
+    append_be(crc32(std::span(before).first(old_toc_length)), 4);
+    append_be(appended_offset, 8);
+    append_be(crc32(std::span(after).subspan(appended_offset)), 4);
+    journal.insert(journal.end(), after.begin(), after.begin() + toc_length);
+    append_be(crc32(journal), 4);
+
+    // The new blocks were appended but only half of the new TOC reached the disk
+    auto torn = after;
+    std::copy_n(before.begin(), toc_length / 2, torn.begin());
+
+    SECTION("A complete journal is replayed")
+    {
+        write_bytes(path, torn);
+        write_bytes(journal_path, journal);
+
+        PsarcFile psarc(path.string());
+        psarc.Open();
+        CHECK_FALSE(std::filesystem::exists(journal_path));
+        CHECK(read_bytes(path) == after);
+        CHECK(psarc.ExtractFile(names[1]) == replacement);
+        CHECK(psarc.Verify().empty());
+    }
+
+    SECTION("An incomplete journal is discarded")
+    {
+        write_bytes(path, before);
+        journal.pop_back();
+        write_bytes(journal_path, journal);
+
+        PsarcFile psarc(path.string());
+        psarc.Open();
+        CHECK_FALSE(std::filesystem::exists(journal_path));
+        CHECK(read_bytes(path) == before);
+        CHECK(psarc.ExtractFile(names[1]) == FixtureGenerator::MakeEntry(spec, 1).data);
+    }
+
+    SECTION("A journal for an archive restored over the path is discarded")
+    {
+        write_bytes(path, before);
+        write_bytes(journal_path, journal);
+
+        PsarcFile psarc(path.string());
+        psarc.Open();
+        CHECK_FALSE(std::filesystem::exists(journal_path));
+        CHECK(read_bytes(path) == before);
+    }
+
+    SECTION("A journal for a same-sized archive with other contents is discarded")
+    {
+        auto other = torn;
+        other.back() ^= 0xFF;
+        write_bytes(path, other);
+        write_bytes(journal_path, journal);
+
+        PsarcFile psarc(path.string());
+        CHECK_THROWS_AS(psarc.Open(), PsarcException);
+        CHECK_FALSE(std::filesystem::exists(journal_path));
+        CHECK(read_bytes(path) == other);
+    }
+}
@@ -0,0 +1,122 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <open-psarc/psarc_file.h>
+
+#include "sng_parser.h"
+#include "sng_writer.h"
+
+namespace
+{
+
+sng::SngData MakeSampleSng()
+{
+    sng::SngData sng;
+    sng.bpms = {{.time = 0.5f, .measure = 1, .beat = 0, .phrase_iteration = 0, .mask = 1},
+                {.time = 1.0f, .measure = -1, .beat = 1, .phrase_iteration = 0, .mask = 0}};
+    sng.phrases = {{.max_difficulty = 2, .name = "COUNT"}, {.solo = 1, .name = "riff"}};
+
+    sng::Chord chord;
+    chord.frets = {-1, 2, 2, 1, -1, -1};
+    chord.fingers = {-1, 2, 3, 1, -1, -1};
+    chord.name = "Am";
+    sng.chords = {chord};
+
+    sng::ChordNotes chord_notes;
+    chord_notes.mask[1] = 0x1000;
+    chord_notes.bend_data[1].bend_values = {{.time = 1.25f, .step = 1.0f}};
+    chord_notes.bend_data[1].used_count = 1;
+    chord_notes.slide_to.fill(-1);
+    chord_notes.slide_unpitch_to.fill(-1);
+    sng.chord_notes = {chord_notes};
+
+    sng.phrase_iterations = {{.phrase_id = 0, .start_time = 0.5f, .next_phrase_time = 4.0f}};
+    sng.nlinked_difficulties = {{.level_break = -1, .nld_phrases = {0, 1}}};
+    sng.events = {{.time = 2.0f, .name = "B0"}};
+    sng.tones = {{.time = 3.0f, .tone_id = 1}};
+    sng.sections = {{.name = "intro", .number = 1, .start_time = 0.5f, .end_time = 4.0f}};
+
+    sng::Arrangement arrangement;
+    arrangement.difficulty = 0;
+    arrangement.anchors = {{.start_time = 0.5f, .end_time = 4.0f, .fret = 1, .width = 4}};
+    arrangement.fingerprints_handshape = {{.chord_id = 0, .start_time = 1.0f, .end_time = 2.0f}};
+
+    sng::Note note;
+    note.mask = 0x00800000;
+    note.time = 1.0f;
+    note.string = 2;
+    note.fret = 3;
+    note.chord_id = -1;
+    note.chord_notes_id = -1;
+    note.bend_values = {{.time = 1.1f, .step = 0.5f}};
+    arrangement.notes = {note};
+    arrangement.phrase_count = 1;
+    arrangement.average_notes_per_iteration = {1.0f};
+    arrangement.phrase_iteration_count1 = 1;
+    arrangement.notes_in_iteration1 = {1};
+    arrangement.phrase_iteration_count2 = 1;
+    arrangement.notes_in_iteration2 = {1};
+    sng.arrangements = {arrangement};
+
+    sng.metadata.max_score = 100000.0;
+    sng.metadata.last_conversion_date_time = "10-17-26 12:00";
+    sng.metadata.song_length = 4.0f;
+    sng.metadata.string_count = 6;
+    sng.metadata.tuning = {0, 0, 0, 0, 0, 0};
+    return sng;
+}
+
+} // namespace
+
+TEST_CASE("SNG serialization round-trips through the parser", "[sng][writer]")
+{
+    const auto sng = MakeSampleSng();
+    const auto serialized = SngWriter::Serialize(sng);
+    const auto parsed = SngParser::Parse(serialized);
+
+    CHECK(SngWriter::Serialize(parsed) == serialized);
+    REQUIRE(parsed.arrangements.size() == 1);
+    CHECK(parsed.arrangements[0].notes[0].fret == 3);
+    CHECK(parsed.chords[0].frets[0] == -1);
+    CHECK(parsed.chord_notes[0].bend_data[1].bend_values.size() == 1);
+    CHECK(parsed.phrases[1].name == "riff");
+}
+
+TEST_CASE("SNG serialization keeps up to 32 chord bend values", "[sng][writer]")
+{
+    auto sng = MakeSampleSng();
+    auto& bend_values = sng.chord_notes[0].bend_data[1].bend_values;
+    bend_values.resize(32);
+    for (size_t i = 0; i < bend_values.size(); ++i)
+    {
+        bend_values[i] = {.time = 1.0f + static_cast<float>(i), .step = 0.5f};
+    }
+
+    const auto parsed = SngParser::Parse(SngWriter::Serialize(sng));
+    const auto& parsed_values = parsed.chord_notes[0].bend_data[1].bend_values;
+    REQUIRE(parsed_values.size() == 32);
+    CHECK(parsed_values[31].time == bend_values[31].time);
+
+    bend_values.emplace_back();
+    CHECK_THROWS_AS(SngWriter::Serialize(sng), PsarcException);
+}
+
+TEST_CASE("SNG encoding emits the encrypted container header", "[sng][writer]")
+{
+    const auto encoded = SngWriter::Encode(MakeSampleSng());
+
+    REQUIRE(encoded.size() > 24);
+    CHECK(encoded[0] == 0x4A);
+    CHECK(encoded[4] == 0x01);
+}
+
+TEST_CASE("SNG parsing rejects counts larger than the remaining data", "[sng][parser]")
+{
+    auto serialized = SngWriter::Serialize(MakeSampleSng());
+
+    // The BPM count leads the payload; claim far more records than the buffer holds
+    serialized[3] = 0x10;
+    CHECK_THROWS_AS(SngParser::Parse(serialized), PsarcException);
+
+    serialized.resize(2);
+    CHECK_THROWS_AS(SngParser::Parse(serialized), PsarcException);
+}
@@ -0,0 +1,158 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <open-psarc/psarc_file.h>
+
+#include "sng_parser.h"
+#include "sng_writer.h"
+#include "sng_xml_reader.h"
+
+#include <string>
+
+namespace
+{
+
+constexpr const char* g_arrangement_xml = R"(<?xml version="1.0" encoding="utf-8"?>
+<!-- Generated for tests -->
+<song version="8">
+  <title>Test &amp; Song</title>
+  <offset>-0.500</offset>
+  <songLength>8.000</songLength>
+  <startBeat>0.500</startBeat>
+  <capo>0</capo>
+  <tuning string0="-2" string1="0" string2="0" string3="0" string4="0" string5="0" />
+  <phrases count="2">
+    <phrase disparity="0" ignore="0" maxDifficulty="0" name="COUNT" solo="0" />
+    <phrase disparity="0" ignore="0" maxDifficulty="1" name="riff" solo="1" />
+  </phrases>
+  <phraseIterations count="2">
+    <phraseIteration time="0.500" phraseId="0" />
+    <phraseIteration time="2.500" phraseId="1">
+      <heroLevels count="1"><heroLevel hero="3" difficulty="1" /></heroLevels>
+    </phraseIteration>
+  </phraseIterations>
+  <chordTemplates count="2">
+    <chordTemplate chordName="A5" displayName="A5" finger0="1" fret0="5" fret1="7" />
+    <chordTemplate chordName="Am" displayName="Am-arp" fret1="0" fret2="2" />
+  </chordTemplates>
+  <ebeats count="3">
+    <ebeat time="0.500" measure="1" />
+    <ebeat time="1.000" />
+    <ebeat time="1.500" measure="2" />
+  </ebeats>
+  <sections count="1"><section name="riff" number="1" startTime="2.500" /></sections>
+  <events count="1"><event time="2.000" code="B0" /></events>
+  <transcriptionTrack difficulty="-1"><notes count="0" /></transcriptionTrack>
+  <levels count="2">
+    <level difficulty="0">
+      <notes count="1"><note time="3.000" string="0" fret="0" /></notes>
+      <anchors count="1"><anchor time="0.500" fret="1" width="4.000" /></anchors>
+    </level>
+    <level difficulty="1">
+      <notes count="2">
+        <note time="3.500" string="1" fret="5" sustain="0.500" linkNext="1" bend="1">
+          <bendValues count="1"><bendValue time="3.600" step="1.000" /></bendValues>
+        </note>
+        <note time="4.000" string="1" fret="7" slideTo="9" />
+      </notes>
+      <chords count="1">
+        <chord time="3.000" chordId="0" palmMute="1">
+          <chordNote time="3.000" string="0" fret="5" palmMute="1" />
+          <chordNote time="3.000" string="1" fret="7" />
+        </chord>
+      </chords>
+      <anchors count="1"><anchor time="2.500" fret="5" width="4" /></anchors>
+      <handShapes count="1"><handShape chordId="0" startTime="3.000" endTime="3.250" /></handShapes>
+    </level>
+  </levels>
+</song>
+)";
+
+} // namespace
+
+TEST_CASE("Arrangement XML builds SNG data with derived fields", "[sng][xml][reader]")
+{
+    const auto sng = SngXmlReader::Parse(g_arrangement_xml);
+
+    REQUIRE(sng.arrangements.size() == 2);
+    CHECK(sng.metadata.tuning[0] == -2);
+    CHECK(sng.metadata.capo_fret_id == -1);
+    CHECK(sng.metadata.max_difficulty == 1);
+    CHECK(sng.chords[1].mask == 1);
+    CHECK(sng.chords[0].frets[2] == -1);
+    CHECK(sng.bpms[1].measure == 1);
+    CHECK(sng.bpms[1].beat == 1);
+    CHECK(sng.phrase_iterations[0].next_phrase_time == 2.5f);
+    CHECK(sng.phrase_iterations[1].difficulty[2] == 1);
+    CHECK(sng.phrases[1].phrase_iteration_links == 1);
+    CHECK(sng.sections[0].end_time == 8.0f);
+
+    const auto& easy = sng.arrangements[0];
+    REQUIRE(easy.notes.size() == 1);
+    CHECK((easy.notes[0].mask & static_cast<uint32_t>(sng::OPEN)) != 0);
+    CHECK(easy.notes[0].anchor_fret == 1);
+
+    // Chords and notes are merged in time order
+    const auto& hard = sng.arrangements[1];
+    REQUIRE(hard.notes.size() == 3);
+    CHECK(hard.notes[0].chord_id == 0);
+    CHECK(hard.notes[0].chord_notes_id == 0);
+    CHECK(hard.notes[0].fingerprint_id[0] == 0);
+    CHECK(hard.notes[1].max_bend == 1.0f);
+    CHECK(hard.notes[1].phrase_iteration_id == 1);
+    CHECK(hard.notes[2].parent_prev_note == 1);
+    CHECK(hard.notes[2].slide_to == 9);
+    CHECK(hard.notes_in_iteration1 == std::vector<int32_t>{0, 3});
+    CHECK(sng.chord_notes.size() == 1);
+}
+
+TEST_CASE("Compiled XML survives SNG serialization", "[sng][xml][reader]")
+{
+    const auto sng = SngXmlReader::Parse(g_arrangement_xml);
+    const auto serialized = SngWriter::Serialize(sng);
+
+    CHECK(SngWriter::Serialize(SngParser::Parse(serialized)) == serialized);
+}
+
+TEST_CASE("Vocals XML builds vocal entries", "[sng][xml][reader]")
+{
+    const auto sng = SngXmlReader::Parse(
+        R"(<vocals count="2"><vocal time="1.0" note="60" length="0.5" lyric="Hel-"/>)"
+        R"(<vocal time="1.5" note="62" length="0.5" lyric="lo&apos;+"/></vocals>)");
+
+    REQUIRE(sng.vocals.size() == 2);
+    CHECK(sng.vocals[1].lyric == "lo'+");
+    CHECK(sng.vocals[0].note == 60);
+}
+
+TEST_CASE("Malformed XML is rejected", "[sng][xml][reader]")
+{
+    CHECK_THROWS(SngXmlReader::Parse("<song><levels>"));
+    CHECK_THROWS(SngXmlReader::Parse("<song attr=unquoted/>"));
+    CHECK_THROWS(SngXmlReader::Parse("<unknown/>"));
+}
+
+TEST_CASE("Integers that do not fit their fields are rejected", "[sng][xml][reader]")
+{
+    const auto level = [](const std::string& notes) {
+        return R"(<song><levels><level difficulty="0"><notes>)" + notes +
+               "</notes></level></levels></song>";
+    };
+    CHECK(SngXmlReader::Parse(level(R"(<note time="1" string="0" fret="7.000"/>)"))
+              .arrangements[0]
+              .notes[0]
+              .fret == 7);
+    CHECK_THROWS_AS(SngXmlReader::Parse(level(R"(<note time="1" fret="99999999999"/>)")),
+                    PsarcException);
+    CHECK_THROWS_AS(SngXmlReader::Parse(level(R"(<note time="1" fret="12abc"/>)")),
+                    PsarcException);
+    CHECK_THROWS_AS(SngXmlReader::Parse(level(R"(<note time="1" fret="3e10"/>)")),
+                    PsarcException);
+
+    // Notes link to their neighbours by 16-bit index
+    std::string notes;
+    for (int i = 0; i < 32768; ++i)
+    {
+        notes += R"(<note time="1" string="0" fret="1"/>)";
+    }
+    CHECK_THROWS_AS(SngXmlReader::Parse(level(notes)), PsarcException);
+}
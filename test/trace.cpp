@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <open-psarc/psarc_trace.h>
+
+#include "trace.h"
+
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace
+{
+
+constexpr size_t g_ring_capacity = 16384; // Per-thread span limit in src/trace.cpp
+
+nlohmann::json WriteAndReadTrace()
+{
+    const auto directory = std::filesystem::path(TEST_BINARY_DIR) / "generated";
+    std::filesystem::create_directories(directory);
+    const auto path = directory / "trace.json";
+    PsarcTrace::WriteChromeTrace(path.string());
+
+    std::ifstream in(path);
+    return nlohmann::json::parse(in);
+}
+
+} // namespace
+
+TEST_CASE("Trace rings keep the newest spans and count the dropped ones", "[trace]")
+{
+    PsarcTrace::Start();
+    for (size_t i = 0; i < g_ring_capacity + 10; ++i)
+    {
+        const auto detail = std::to_string(i);
+        const TraceSpan span("Span", detail);
+    }
+
+    // 65 bytes whose cut to the last 63 would start inside the "é"
+    const std::string long_detail = "a\xC3\xA9" + std::string(62, 'x');
+    {
+        const TraceSpan span("Long", long_detail);
+    }
+    PsarcTrace::Stop();
+    {
+        const TraceSpan span("Stopped");
+    }
+
+    const auto trace = WriteAndReadTrace();
+    CHECK(trace["otherData"]["dropped_events"] == 11);
+
+    std::set<std::string> names;
+    std::set<std::string> details;
+    std::string long_exported;
+    for (const auto& event : trace["traceEvents"])
+    {
+        if (event["ph"] != "X")
+        {
+            continue;
+        }
+        names.insert(event["name"].get<std::string>());
+        const auto detail = event["args"]["detail"].get<std::string>();
+        if (event["name"] == "Long")
+        {
+            long_exported = detail;
+        }
+        details.insert(detail);
+    }
+    CHECK(names == std::set<std::string>{"Span", "Long"});
+    CHECK(details.size() == g_ring_capacity);
+    CHECK_FALSE(details.contains("10"));
+    CHECK(details.contains("11"));
+    CHECK(details.contains(std::to_string(g_ring_capacity + 9)));
+    CHECK(long_exported == std::string(62, 'x'));
+}